@@ -5,6 +5,9 @@
 #include <array>
 #include <memory>
 #include <thread>
+#include <string>
+#include <filesystem>
+#include <fstream>
 #include "CppUnitTest.h"
 #include "ConcurrentQueue.h"
 
@@ -57,7 +60,7 @@ namespace tiel::concurrent::container
 				Assert::IsTrue(val1.has_value(), L"val3 muss einen Wert haben");
 				auto val4 = queue.Pop();
 				Assert::IsFalse(val4.has_value(), L"val4 darf keinen Wert haben");
-				Assert::IsFalse(queue.Push(4), L"Push() darf bei geschlossener queue nicht true zurck geben");
+				Assert::IsFalse(queue.Push(4), L"Push() darf bei geschlossener queue nicht true zurück geben");
 				Assert::IsTrue(queue.IsEmpty(), L"Queue muss bei geschlossener Queue nach Push leer sein");
 				val4 = queue.Pop();
 				Assert::IsFalse(val4.has_value(), L"val4 darf keinen Wert haben");
@@ -79,11 +82,11 @@ namespace tiel::concurrent::container
 				Assert::AreEqual(expectedSize, queue1.Size(), L"Nach Move-Zuweisung muss Queue1 alle Elemente haben");
 
 				auto val1 = queue1.Pop();
-				Assert::AreEqual(1, val1.value_or(0), L"unerwarteter Wert fr val1");
+				Assert::AreEqual(1, val1.value_or(0), L"unerwarteter Wert für val1");
 				auto val2 = queue1.Pop();
-				Assert::AreEqual(2, val2.value_or(0), L"unerwarteter Wert fr val1");
+				Assert::AreEqual(2, val2.value_or(0), L"unerwarteter Wert für val1");
 				auto val3 = queue1.Pop();
-				Assert::AreEqual(3, val3.value_or(0), L"unerwarteter Wert fr val1");
+				Assert::AreEqual(3, val3.value_or(0), L"unerwarteter Wert für val1");
 			}
 		}
 		///----------------------------------------------------------------------------------------------
@@ -127,7 +130,7 @@ namespace tiel::concurrent::container
 			Assert::IsTrue(queue.Push(42), L"Push() muss erfolgreich sein");
 			Assert::IsFalse(queue.IsEmpty(), L"Queue darf nicht leer sein");
 			Assert::IsTrue(queue.RemoveByFilter(filterElements), L"es muessen Elemente herausgefilter worden sein");
-			Assert::AreEqual<size_t>(3ULL, queue.Size(), L"unerwartete Anzahl verbleibender Elemente"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(3ULL, queue.Size(), L"unerwartete Anzahl verbleibender Elemente"); // <size_t> für VS2017 erforderlich
 			Assert::IsFalse(queue.IsEmpty(), L"Queue darf nicht leer sein");
 			Assert::IsFalse(queue.RemoveByFilter(filterElements), L"es duefen keine weiteren Elemente herausgefilter worden sein");
 			Assert::IsTrue(queue.RemoveByFilter(filterAllElements), L"alle uebrigen Elemente muessen herausgefilter worden sein");
@@ -192,7 +195,7 @@ namespace tiel::concurrent::container
 				pops[i] = queue.Pop().value_or(0);
 			}
 			int64_t	sumAllResults = std::accumulate(pops.begin(), pops.end(), 0LL);
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		/// Relativ schlechte Performance, wenn viele Consumer auf Daten warten, die nur von einem
@@ -239,7 +242,7 @@ namespace tiel::concurrent::container
 			{
 				sumAllResults += std::accumulate(popValues[i].begin(), popValues[i].end(), 0LL);
 			}
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		/// Relativ schlechte Performance, wenn viele Consumer auf Daten warten, die nur von einem
@@ -288,7 +291,7 @@ namespace tiel::concurrent::container
 			{
 				sumAllResults += std::accumulate(popValues[i].begin(), popValues[i].end(), 0LL);
 			}
-			Assert::AreNotEqual<size_t>(sumAllResults, SUM_TOTAL, L"Summe darf wegen Timeout nicht stimmen"); // <size_t> fr VS2017 erforderlich
+			Assert::AreNotEqual<size_t>(sumAllResults, SUM_TOTAL, L"Summe darf wegen Timeout nicht stimmen"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		TEST_METHOD(MultipleConsumerProducer)
@@ -348,7 +351,7 @@ namespace tiel::concurrent::container
 			{
 				sumAllResults += std::accumulate(popValues[i].begin(), popValues[i].end(), 0LL);
 			}
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		TEST_METHOD(MultipleProducer)
@@ -394,7 +397,129 @@ namespace tiel::concurrent::container
 			}
 
 			int64_t	sumAllResults = std::accumulate(popValues.begin(), popValues.end(), 0LL);
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Auslagern in Segmentdateien: Reihenfolge, Dateien löschen, Mischbetrieb Speicher/Datei
+		TEST_METHOD(SpillToSegmentFiles)
+		{
+			constexpr size_t	MEMORY_THRESHOLD	= 100;
+			constexpr int		NUM_PUSHES			= 10000;
+			const auto			spillDirectory		= std::filesystem::temp_directory_path() / "UnitTest_BlockingQueue_Spill";
+			auto				countSegmentFiles	= [&spillDirectory]()
+			{
+				return std::distance(std::filesystem::directory_iterator(spillDirectory), std::filesystem::directory_iterator{});
+			};
+			std::filesystem::remove_all(spillDirectory);
+			{
+				BlockingQueue<std::string> queue;
+				Assert::IsTrue(queue.EnableSpill({ spillDirectory, MEMORY_THRESHOLD, 4096 }), L"EnableSpill() muss erfolgreich sein");
+				Assert::IsFalse(queue.EnableSpill({ spillDirectory, MEMORY_THRESHOLD, 4096 }), L"EnableSpill() darf nur einmal erfolgreich sein");
+
+				for(int i = 0; i < NUM_PUSHES; i++)
+				{
+					Assert::IsTrue(queue.Push(std::to_string(i)), L"Push() muss erfolgreich sein");
+				}
+				Assert::AreEqual<size_t>(NUM_PUSHES, queue.Size(), L"Size() muss ausgelagerte Elemente enthalten");
+				Assert::AreEqual<size_t>(NUM_PUSHES - MEMORY_THRESHOLD, queue.SpilledSize(), L"unerwartete Anzahl ausgelagerter Elemente");
+				Assert::IsTrue(countSegmentFiles() > 1, L"es muessen mehrere Segmentdateien existieren");
+
+				// Hälfte entnehmen, dabei weiter pushen -> FIFO muss erhalten bleiben
+				for(int i = 0; i < NUM_PUSHES/2; i++)
+				{
+					Assert::AreEqual(std::to_string(i), queue.Pop().value_or(""), L"FIFO-Reihenfolge verletzt");
+				}
+				Assert::IsTrue(queue.Push(std::to_string(NUM_PUSHES)), L"Push() muss erfolgreich sein");
+				for(int i = NUM_PUSHES/2; i <= NUM_PUSHES; i++)
+				{
+					Assert::AreEqual(std::to_string(i), queue.Pop(10).value_or(""), L"FIFO-Reihenfolge verletzt");
+				}
+				Assert::IsTrue(queue.IsEmpty(), L"Queue muss leer sein");
+				Assert::AreEqual<size_t>(0, queue.SpilledSize(), L"es duerfen keine Elemente mehr ausgelagert sein");
+				Assert::AreEqual<ptrdiff_t>(0, countSegmentFiles(), L"gelesene Segmentdateien muessen geloescht sein");
+
+				// nach dem Leeren wird wieder im Speicher gepuffert
+				Assert::IsTrue(queue.Push("memory"), L"Push() muss erfolgreich sein");
+				Assert::AreEqual<size_t>(0, queue.SpilledSize(), L"Element darf nicht ausgelagert werden");
+
+				for(int i = 0; i < NUM_PUSHES; i++)
+				{
+					Assert::IsTrue(queue.Push(std::to_string(i)), L"Push() muss erfolgreich sein");
+				}
+				Assert::IsTrue(queue.RemoveByFilter([](const std::string& s) { return (s != "memory") && (s.back() != '0'); }), L"es muessen Elemente entfernt werden");
+				Assert::AreEqual<size_t>(NUM_PUSHES/10 + 1, queue.Size(), L"unerwartete Anzahl verbleibender Elemente");
+				Assert::IsTrue(queue.IsFront([](const std::string& s) { return s == "memory"; }), L"unerwartetes erstes Element");
+			}
+			Assert::AreEqual<ptrdiff_t>(0, countSegmentFiles(), L"Destruktor muss alle Segmentdateien loeschen");
+			std::filesystem::remove_all(spillDirectory);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Snapshot schreiben und in neue Queue (mit und ohne Auslagern) wiederherstellen
+		TEST_METHOD(SnapshotRestore)
+		{
+			constexpr int	NUM_PUSHES		= 1000;
+			const auto		tempDirectory	= std::filesystem::temp_directory_path() / "UnitTest_BlockingQueue_Snapshot";
+			const auto		snapshotPath	= tempDirectory / "queue.snapshot";
+
+			std::filesystem::remove_all(tempDirectory);
+			std::filesystem::create_directories(tempDirectory);
+			{
+				BlockingQueue<std::string> queue;
+				Assert::IsTrue(queue.EnableSpill({ tempDirectory / "spill", NUM_PUSHES/4, 4096 }), L"EnableSpill() muss erfolgreich sein");
+				for(int i = 0; i < NUM_PUSHES; i++)
+				{
+					Assert::IsTrue(queue.Push(std::to_string(i)), L"Push() muss erfolgreich sein");
+				}
+				Assert::IsTrue(queue.SpilledSize() > 0, L"Elemente muessen ausgelagert sein");
+				queue.Close();
+				Assert::IsTrue(queue.Snapshot(snapshotPath), L"Snapshot() muss erfolgreich sein");
+				Assert::IsTrue(queue.IsEmpty(), L"Queue muss nach Snapshot() leer sein");
+				Assert::IsFalse(queue.Restore(snapshotPath), L"Restore() in geschlossene Queue darf nicht erfolgreich sein");
+			}
+			{
+				BlockingQueue<std::string> queue;
+				Assert::IsTrue(queue.Push("first"), L"Push() muss erfolgreich sein");
+				Assert::IsTrue(queue.Restore(snapshotPath), L"Restore() muss erfolgreich sein");
+				Assert::AreEqual<size_t>(NUM_PUSHES + 1, queue.Size(), L"unerwartete Anzahl wiederhergestellter Elemente");
+				Assert::AreEqual(std::string("first"), queue.Pop().value_or(""), L"vorhandene Elemente muessen vorne bleiben");
+				for(int i = 0; i < NUM_PUSHES; i++)
+				{
+					Assert::AreEqual(std::to_string(i), queue.Pop().value_or(""), L"FIFO-Reihenfolge verletzt");
+				}
+			}
+			{
+				BlockingQueue<std::string> queue;
+				Assert::IsTrue(queue.EnableSpill({ tempDirectory / "spill", NUM_PUSHES/2, 4096 }), L"EnableSpill() muss erfolgreich sein");
+				Assert::IsTrue(queue.Restore(snapshotPath), L"Restore() muss erfolgreich sein");
+				Assert::AreEqual<size_t>(NUM_PUSHES/2, queue.SpilledSize(), L"Elemente oberhalb der Schwelle muessen ausgelagert sein");
+				for(int i = 0; i < NUM_PUSHES; i++)
+				{
+					Assert::AreEqual(std::to_string(i), queue.Pop().value_or(""), L"FIFO-Reihenfolge verletzt");
+				}
+			}
+			{
+				BlockingQueue<int> queue;
+				Assert::IsFalse(queue.Restore(tempDirectory / "missing.snapshot"), L"Restore() einer fehlenden Datei muss fehlschlagen");
+				Assert::IsTrue(queue.Push(1) && queue.Push(2), L"Push() muss erfolgreich sein");
+				Assert::IsTrue(queue.Snapshot(snapshotPath), L"Snapshot() muss erfolgreich sein");
+			}
+			{
+				BlockingQueue<int64_t> queue;
+				Assert::IsFalse(queue.Restore(snapshotPath), L"Restore() mit anderem Elementtyp muss fehlschlagen");
+			}
+			{
+				// Nutzdatengröße des ersten Datensatzes verfälschen (passt noch in die Datei, aber nicht zu int)
+				const uint32_t payloadSize = 0;
+				std::fstream file(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+				file.seekp(sizeof(QueueSnapshotFile::Header));
+				file.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+			}
+			{
+				BlockingQueue<int> queue;
+				Assert::IsFalse(queue.Restore(snapshotPath), L"Restore() mit ungueltiger Datensatzgroesse muss fehlschlagen");
+				Assert::IsTrue(queue.IsEmpty(), L"Queue muss unveraendert bleiben");
+			}
+			std::filesystem::remove_all(tempDirectory);
 		}
 	};
 }
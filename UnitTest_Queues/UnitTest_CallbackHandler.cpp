@@ -7,6 +7,7 @@
 #include <thread>
 #include <future>
 #include <atomic>
+#include <mutex>
 #include "CppUnitTest.h"
 #include "CallbackHandler.h"
 
@@ -42,38 +43,38 @@ namespace tiel::concurrent
 				value3 = i;
 			};
 
-			Assert::IsFalse(callbackMgr.IsCallbackHandleValid(-1), L"Ungltiges Callback-Handle darf nicht gltig sein");
-			Assert::IsFalse(callbackMgr.IsCallbackHandleValid(0), L"Callback-Handle darf nicht gltig sein");
+			Assert::IsFalse(callbackMgr.IsCallbackHandleValid(-1), L"Ungültiges Callback-Handle darf nicht gültig sein");
+			Assert::IsFalse(callbackMgr.IsCallbackHandleValid(0), L"Callback-Handle darf nicht gültig sein");
 
 			auto handle1 = callbackMgr.AddCallback(callback1);
-			callbackMgr.CallAll(handle1, "CallbackHandler");
+			callbackMgr.CallAll(1, "CallbackHandler");
 			Assert::IsTrue(value1 != -1, L"callback1 nicht aufgerufen");		value1 = -1;
 			Assert::IsFalse(value2 != -1, L"callback2 unerwartet aufgerufen"); value2 = -1;
 			Assert::IsFalse(value3 != -1, L"callback3 unerwartet aufgerufen"); value3 = -1;
 			
 			auto handle2 = callbackMgr.AddCallback(callback2);
-			callbackMgr.CallAll(handle2, "CallbackHandler");
+			callbackMgr.CallAll(2, "CallbackHandler");
 			Assert::IsTrue(value1 != -1, L"callback1 nicht aufgerufen");		value1 = -1;
 			Assert::IsTrue(value2 != -1, L"callback2 nicht aufgerufen");		value2 = -1;
 			Assert::IsFalse(value3 != -1, L"callback3 unerwartet aufgerufen"); value3 = -1;
 
-			Assert::IsTrue(callbackMgr.IsCallbackHandleValid(handle1), L"Callback-Handle muss gltig sein");
+			Assert::IsTrue(callbackMgr.IsCallbackHandleValid(handle1), L"Callback-Handle muss gültig sein");
 			callbackMgr.RemoveCallback(handle1);
-			Assert::IsFalse(callbackMgr.IsCallbackHandleValid(handle1), L"Callback-Handle darf nicht mehr gltig sein");
-			callbackMgr.CallAll(handle2, "CallbackHandler");
+			Assert::IsFalse(callbackMgr.IsCallbackHandleValid(handle1), L"Callback-Handle darf nicht mehr gültig sein");
+			callbackMgr.CallAll(2, "CallbackHandler");
 			Assert::IsFalse(value1 != -1, L"callback1 unerwartet aufgerufen"); value1 = -1;
 			Assert::IsTrue(value2 != -1, L"callback2 nicht aufgerufen");		value2 = -1;
 			Assert::IsFalse(value3 != -1, L"callback3 unerwartet aufgerufen"); value3 = -1;
 
 			handle1 = callbackMgr.AddCallback(callback1);
 			auto handle3 = callbackMgr.AddCallback(callback3);
-			callbackMgr.CallAll(handle3, "CallbackHandler");
+			callbackMgr.CallAll(3, "CallbackHandler");
 			Assert::IsTrue(value1 != -1, L"callback1 nicht aufgerufen");		value1 = -1;
 			Assert::IsTrue(value2 != -1, L"callback2 nicht aufgerufen");		value2 = -1;
 			Assert::IsTrue(value3 != -1, L"callback3 nicht aufgerufen");		value3 = -1;
 
 			callbackMgr.RemoveCallback(handle2);
-			callbackMgr.CallAll(handle3, "CallbackHandler");
+			callbackMgr.CallAll(3, "CallbackHandler");
 			Assert::IsTrue(value1 != -1, L"callback1 nicht aufgerufen");		value1 = -1;
 			Assert::IsFalse(value2 != -1, L"callback2 unerwartet aufgerufen"); value2 = -1;
 			Assert::IsTrue(value3 != -1, L"callback3 nicht aufgerufen");		value3 = -1;
@@ -96,6 +97,15 @@ namespace tiel::concurrent
 			callMgr3 = std::move(callMgr2);
 			Assert::IsTrue(callMgr2.Size() == 0UL, L"Fehler bei der  Move-Zuweisung");
 			Assert::IsTrue(callMgr3.Size() == 3UL, L"cFehler bei der  Move-Zuweisung");
+
+			// Zuweisung an einen Handler mit Callbacks ersetzt diese, Selbstzuweisung aendert nichts
+			CallbackHandler<int, std::string> callMgr4;
+			(void)callMgr4.AddCallback(callback1);
+			callMgr4 = std::move(callMgr3);
+			Assert::IsTrue(callMgr4.Size() == 3UL, L"bisherige Callbacks muessen ersetzt werden");
+			auto& rCallMgr4 = callMgr4;
+			callMgr4 = std::move(rCallMgr4);
+			Assert::IsTrue(callMgr4.Size() == 3UL, L"Selbstzuweisung darf nichts aendern");
 		}
 		///----------------------------------------------------------------------------------------------
 		TEST_METHOD(Test_AsyncInterface)
@@ -129,7 +139,7 @@ namespace tiel::concurrent
 
 			// Test: IsCallbackPending()
 			Assert::IsTrue(cbMgr.CallAllAsync(50, "TestAsync1"), L"TestAsync1: CallAllAsync() muss erfolgreich sein");
-			Assert::IsTrue(cbMgr.CallAllAsync(100, "TestAsync2"), L"TestAsync2: CallAllAsync() darf wegen pending-call nicht true zurckgeben");
+			Assert::IsTrue(cbMgr.CallAllAsync(100, "TestAsync2"), L"TestAsync2: CallAllAsync() darf wegen pending-call nicht true zurückgeben");
 			Assert::IsTrue(cbMgr.IsCallbackPending(handle3), L"TestAsync1: Callback kann noch micht fertig sein");
 			std::this_thread::sleep_for(milliseconds(100));
 			Assert::IsFalse(cbMgr.IsCallbackPending(handle3), L"TestAsync1: Callback muss jetzt fertig sein");
@@ -152,13 +162,13 @@ namespace tiel::concurrent
 			handle1 = cbMgr.AddCallback(wait10ms);
 			handle2 = cbMgr.AddCallback(wait10msException);
 			Assert::IsTrue(cbMgr.CallAllAsync(50, "TestAsync5"), L"TestAsync5: CallAllAsync() muss erfolgreich sein");
-			Assert::IsFalse(cbMgr.WaitForAsyncCallbacksFinished(true, 100), L"TestAsync5: Exception muss false zurckgeben");
+			Assert::IsFalse(cbMgr.WaitForAsyncCallbacksFinished(true, 100), L"TestAsync5: Exception muss false zurückgeben");
 
 			Assert::IsTrue(cbMgr.CallAllAsync(50, "TestAsync6"), L"TestAsync6: CallAllAsync() muss erfolgreich sein");
-			Assert::IsFalse(cbMgr.WaitForAsyncCallbackFinished(handle2, true, 100), L"TestAsync6: Exception muss false zurckgeben");
+			Assert::IsFalse(cbMgr.WaitForAsyncCallbackFinished(handle2, true, 100), L"TestAsync6: Exception muss false zurückgeben");
 
 			// ohne Exception-Behandlung
-			Assert::IsFalse(cbMgr.CallAllNoExcept(50, "TestAsync7"), L"TestAsync7: CallAllNoExcept() muss false zurckgeben");
+			Assert::IsFalse(cbMgr.CallAllNoExcept(50, "TestAsync7"), L"TestAsync7: CallAllNoExcept() muss false zurückgeben");
 			auto throwTest1 = [&]()
 			{
 				cbMgr.CallAll(50, "TestAsync8");
@@ -180,18 +190,1014 @@ namespace tiel::concurrent
 			Assert::ExpectException<std::exception>(throwTest3, L"TestAsync10: Exception erwartet");
 		}
 		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_AsyncExecutor)
+		{
+			constexpr int NUM_CALLS = 1000;
+
+			ThreadPoolExecutor					executor(2);
+			CallbackHandler<int, std::string>	cbMgr(executor);
+			std::atomic_int						sum = 0;
+			std::atomic_bool					isWorkerThread = true;
+
+			auto handle = cbMgr.AddCallback([&](int i, const std::string& /*s*/)
+				{
+					isWorkerThread = isWorkerThread && executor.IsWorkerThread();
+					sum += i;
+				});
+			for(int i = 1; i <= NUM_CALLS; i++)
+			{
+				Assert::IsTrue(cbMgr.CallAllAsync(i, "TestExecutor"), L"CallAllAsync() muss erfolgreich sein");
+				Assert::IsTrue(cbMgr.WaitForAsyncCallbackFinished(handle, false), L"kein Fehler erwartet");
+				Assert::IsFalse(cbMgr.IsCallbackPending(handle), L"Callback muss fertig sein");
+			}
+			Assert::AreEqual(NUM_CALLS*(NUM_CALLS + 1)/2, sum.load(), L"Callback nicht bei jedem Aufruf ausgefuehrt");
+			Assert::IsTrue(isWorkerThread, L"Callback muss im Executor des CallbackHandlers laufen");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_ConcurrentCallAll)
+		{
+			constexpr int NUM_CALLERS = 4;
+
+			CallbackHandler<int, std::string>	cbMgr;
+			std::atomic_int						numActiveCalls	= 0;
+			std::atomic_int						maxActiveCalls	= 0;
+			std::atomic_bool					isReleased		= false;
+
+			(void)cbMgr.AddCallback([&](int, const std::string&)
+				{
+					const int numCalls = ++numActiveCalls;
+					int maxCalls = maxActiveCalls;
+					while((numCalls > maxCalls) && !maxActiveCalls.compare_exchange_weak(maxCalls, numCalls))
+					{;}
+					while(!isReleased)
+					{
+						std::this_thread::yield();
+					}
+					--numActiveCalls;
+				});
+
+			std::vector<std::future<void>> callers;
+			for(int i = 0; i < NUM_CALLERS; i++)
+			{
+				callers.push_back(std::async(std::launch::async, [&cbMgr, i]() { cbMgr.CallAll(i, "TestConcurrent"); }));
+			}
+			// alle Aufrufer muessen gleichzeitig im Callback sein (keine Sperre waehrend des Aufrufs)
+			const auto startTime = steady_clock::now();
+			while((maxActiveCalls < NUM_CALLERS) && (steady_clock::now() - startTime < 5s))
+			{
+				std::this_thread::yield();
+			}
+			Assert::AreEqual(NUM_CALLERS, maxActiveCalls.load(), L"CallAll()-Aufrufe duerfen sich nicht gegenseitig blockieren");
+			Assert::IsTrue(cbMgr.IsPendingOperation(), L"laufende CallAll()-Aufrufe erwartet");
+
+			// Aenderungen der Liste blockieren nicht hinter laufenden Callbacks
+			const auto handle = cbMgr.AddCallback([](int, const std::string&) {});
+			Assert::IsTrue(cbMgr.RemoveCallback(handle), L"RemoveCallback() muss erfolgreich sein");
+
+			isReleased = true;
+			for(auto& caller : callers)
+			{
+				caller.wait();
+			}
+			Assert::IsFalse(cbMgr.IsPendingOperation(), L"keine laufenden CallAll()-Aufrufe erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallAllNoSharedWrites)
+		{
+			constexpr int NUM_CALLERS	= 4;
+			constexpr int NUM_CALLS		= 10000;
+
+			// zaehlt Kopien des Callbacks und liest den Referenzzaehler eines gemeinsamen Objekts
+			struct CountingCallback
+			{
+				std::atomic_int*		pNumCopies;
+				std::atomic_int*		pNumSharedWrites;
+				std::shared_ptr<int>	pToken;
+
+				CountingCallback(std::atomic_int* pCopies, std::atomic_int* pWrites, std::shared_ptr<int> pShared)
+					: pNumCopies(pCopies), pNumSharedWrites(pWrites), pToken(std::move(pShared))
+				{}
+				CountingCallback(const CountingCallback& other)
+					: pNumCopies(other.pNumCopies), pNumSharedWrites(other.pNumSharedWrites), pToken(other.pToken)
+				{
+					++*pNumCopies;
+				}
+				CountingCallback(CountingCallback&&) = default;
+				void operator()(int) const
+				{
+					// nur der registrierte Callback selbst haelt einen Anteil am Token
+					if(pToken.use_count() != 1)
+					{
+						++*pNumSharedWrites;
+					}
+				}
+			};
+			CallbackHandler<int>	cbMgr;
+			std::atomic_int			numCopies		= 0;
+			std::atomic_int			numSharedWrites	= 0;
+			(void)cbMgr.AddCallback(CountingCallback(&numCopies, &numSharedWrites, std::make_shared<int>(0)));
+			const int numCopiesAfterAdd = numCopies;
+
+			// CallAll() kopiert weder Liste noch Callbacks und zaehlt keinen gemeinsamen Referenzzaehler,
+			// gleichzeitige Aufrufer schreiben daher keine gemeinsame Cache-Line (Durchsatz: Benchmark)
+			std::vector<std::thread> callers;
+			for(int t = 0; t < NUM_CALLERS; t++)
+			{
+				callers.emplace_back([&cbMgr]()
+					{
+						for(int i = 0; i < NUM_CALLS; i++)
+						{
+							cbMgr.CallAll(i);
+						}
+					});
+			}
+			for(auto& caller : callers)
+			{
+				caller.join();
+			}
+			Assert::AreEqual(numCopiesAfterAdd, numCopies.load(), L"CallAll() darf Callbacks nicht kopieren");
+			Assert::AreEqual(0, numSharedWrites.load(), L"CallAll() darf keine Anteile am Callback halten");
+			Assert::IsFalse(cbMgr.IsPendingOperation(), L"keine laufenden CallAll()-Aufrufe erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_DeferredListRelease)
+		{
+			CallbackHandler<int>	cbMgr;
+			std::atomic_bool		isBlocked	= false;
+			std::atomic_bool		isReleased	= false;
+			auto					pToken		= std::make_shared<int>(0);
+			std::weak_ptr<int>		pWeakToken	= pToken;
+
+			(void)cbMgr.AddCallback([&](int)
+				{
+					isBlocked = true;
+					while(!isReleased)
+					{
+						std::this_thread::yield();
+					}
+				});
+			const auto handle = cbMgr.AddCallback([pToken = std::move(pToken)](int) {});
+			auto caller = std::async(std::launch::async, [&cbMgr]() { cbMgr.CallAll(1); });
+			while(!isBlocked)
+			{
+				std::this_thread::yield();
+			}
+			Assert::IsTrue(cbMgr.IsPendingOperation(), L"laufender CallAll()-Aufruf erwartet");
+
+			// die vom laufenden Aufruf gelesene Liste (und damit der Callback) bleibt erhalten
+			Assert::IsTrue(cbMgr.RemoveCallback(handle), L"RemoveCallback() muss erfolgreich sein");
+			(void)cbMgr.AddCallback([](int) {});
+			Assert::IsFalse(pWeakToken.expired(), L"Callback darf waehrend des Aufrufs nicht freigegeben werden");
+
+			isReleased = true;
+			caller.wait();
+			Assert::IsFalse(cbMgr.IsPendingOperation(), L"keine laufenden CallAll()-Aufrufe erwartet");
+
+			// die naechste Aenderung gibt die nicht mehr gelesenen Listen frei
+			(void)cbMgr.AddCallback([](int) {});
+			Assert::IsTrue(pWeakToken.expired(), L"Callback muss nach dem Aufruf freigegeben werden");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallAllParallel)
+		{
+			constexpr int NUM_CALLBACKS = 4;
+
+			CallbackHandler<int, std::string>	cbMgr;
+			std::atomic_int						sum = 0;
+
+			for(int i = 0; i < NUM_CALLBACKS; i++)
+			{
+				(void)cbMgr.AddCallback([&sum](int waitMs, const std::string&)
+					{
+						std::this_thread::sleep_for(milliseconds(waitMs));
+						++sum;
+					});
+			}
+			// Laufzeit entspricht dem langsamsten Callback, nicht der Summe
+			const auto startTime = steady_clock::now();
+			cbMgr.CallAllParallel(100, "TestParallel");
+			const auto duration = steady_clock::now() - startTime;
+			Assert::AreEqual(NUM_CALLBACKS, sum.load(), L"alle Callbacks muessen abgeschlossen sein");
+			Assert::IsTrue(duration < milliseconds(NUM_CALLBACKS*100 - 100), L"Callbacks muessen parallel laufen");
+			Assert::IsFalse(cbMgr.IsPendingOperation(), L"keine laufenden Aufrufe erwartet");
+
+			// Exceptions
+			(void)cbMgr.AddCallback([](int, const std::string& s)
+				{
+					if(s.empty())
+					{
+						throw std::runtime_error("Test");
+					}
+				});
+			sum = 0;
+			Assert::IsFalse(cbMgr.CallAllParallelNoExcept(1, ""), L"Exception muss false zurueckgeben");
+			Assert::AreEqual(NUM_CALLBACKS, sum.load(), L"alle uebrigen Callbacks muessen aufgerufen werden");
+			Assert::IsTrue(cbMgr.CallAllParallelNoExcept(1, "TestParallel"), L"kein Fehler erwartet");
+			auto throwTest = [&]()
+			{
+				cbMgr.CallAllParallel(1, "");
+			};
+			Assert::ExpectException<std::runtime_error>(throwTest, L"Exception erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallAllBatch)
+		{
+			using Handler = CallbackHandler<int, std::string>;
+
+			Handler										cbMgr;
+			std::vector<std::pair<char, int>>			calls;
+			const std::vector<Handler::ArgumentTuple>	batch = { { 1, "a" }, { 2, "b" }, { 3, "" } };
+
+			(void)cbMgr.AddCallback([&calls](int i, const std::string&) { calls.emplace_back('A', i); });
+			(void)cbMgr.AddCallback([&calls](int i, const std::string& s)
+				{
+					if(s.empty())
+					{
+						throw std::runtime_error("Test");
+					}
+					calls.emplace_back('B', i);
+				});
+
+			Assert::IsFalse(cbMgr.CallAllBatchNoExcept(batch), L"Exception muss false zurueckgeben");
+			const std::vector<std::pair<char, int>> expectedCalls = { { 'A', 1 }, { 'A', 2 }, { 'A', 3 }, { 'B', 1 }, { 'B', 2 } };
+			Assert::IsTrue(calls == expectedCalls, L"jeder Callback muss die ganze Folge abarbeiten, bevor der naechste beginnt");
+
+			calls.clear();
+			cbMgr.CallAllBatch(std::span(batch).first(2));
+			Assert::AreEqual<size_t>(4, calls.size(), L"unerwartete Anzahl Aufrufe");
+			auto throwTest = [&]()
+			{
+				cbMgr.CallAllBatch(batch);
+			};
+			Assert::ExpectException<std::runtime_error>(throwTest, L"Exception erwartet");
+			cbMgr.CallAllBatch({});
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallAllQueued)
+		{
+			using Handler = CallbackHandler<int, std::string>;
+
+			// Callback, der beim ersten Ereignis wartet, bis er freigegeben wird
+			struct GatedSubscriber
+			{
+				std::atomic_bool	isEntered	= false;
+				std::atomic_bool	isReleased	= false;
+				std::vector<int>	values;
+
+				Handler::CallbackType Callback()
+				{
+					return [this](int i, const std::string&)
+					{
+						isEntered = true;
+						while(!isReleased)
+						{
+							std::this_thread::yield();
+						}
+						values.push_back(i);
+					};
+				}
+				void WaitEntered() const
+				{
+					while(!isEntered)
+					{
+						std::this_thread::yield();
+					}
+				}
+			};
+
+			Handler				cbMgr;
+			GatedSubscriber		dropOldest;
+			GatedSubscriber		dropNewest;
+			GatedSubscriber		coalesce;
+			std::vector<int>	fastValues;
+
+			const auto handleFast		= cbMgr.AddCallback([&fastValues](int i, const std::string&) { fastValues.push_back(i); });
+			const auto handleOldest		= cbMgr.AddCallback(dropOldest.Callback(), { 2, MailboxOverflowPolicy::DropOldest });
+			const auto handleNewest		= cbMgr.AddCallback(dropNewest.Callback(), { 2, MailboxOverflowPolicy::DropNewest });
+			const auto handleCoalesce	= cbMgr.AddCallback(coalesce.Callback(), { 10, MailboxOverflowPolicy::Coalesce });
+
+			// das erste Ereignis wird zugestellt und blockiert die langsamen Callbacks
+			Assert::IsTrue(cbMgr.CallAllQueued(1, "TestQueued"), L"erstes Ereignis darf nicht verworfen werden");
+			dropOldest.WaitEntered();
+			dropNewest.WaitEntered();
+			coalesce.WaitEntered();
+			// langsame Callbacks halten den Aufrufer nicht auf
+			for(int i = 2; i <= 5; i++)
+			{
+				(void)cbMgr.CallAllQueued(i, "TestQueued");
+			}
+			Assert::AreEqual<size_t>(2 + 2 + 3, cbMgr.NumDroppedEvents(), L"unerwartete Anzahl verworfener Ereignisse");
+			Assert::AreEqual<size_t>(0, cbMgr.NumDroppedEvents(handleFast), L"schneller Callback darf nichts verlieren");
+			Assert::AreEqual<size_t>(2, cbMgr.NumDroppedEvents(handleOldest), L"DropOldest: zwei Ereignisse verworfen");
+			Assert::AreEqual<size_t>(2, cbMgr.NumDroppedEvents(handleNewest), L"DropNewest: zwei Ereignisse verworfen");
+			Assert::AreEqual<size_t>(3, cbMgr.NumDroppedEvents(handleCoalesce), L"Coalesce: drei Ereignisse ersetzt");
+
+			dropOldest.isReleased = dropNewest.isReleased = coalesce.isReleased = true;
+			Assert::IsTrue(cbMgr.WaitForMailboxesDrained(5000), L"Postfaecher muessen geleert werden");
+			Assert::IsTrue(fastValues == std::vector<int>{ 1, 2, 3, 4, 5 }, L"schneller Callback muss alle Ereignisse in Reihenfolge erhalten");
+			Assert::IsTrue(dropOldest.values == std::vector<int>{ 1, 4, 5 }, L"DropOldest: neueste Ereignisse erwartet");
+			Assert::IsTrue(dropNewest.values == std::vector<int>{ 1, 2, 3 }, L"DropNewest: aelteste Ereignisse erwartet");
+			Assert::IsTrue(coalesce.values == std::vector<int>{ 1, 5 }, L"Coalesce: nur neuestes Ereignis erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallAllQueuedBlock)
+		{
+			CallbackHandler<int>	cbMgr;
+			std::atomic_bool		isEntered	= false;
+			std::atomic_bool		isReleased	= false;
+			std::atomic_int			sum			= 0;
+
+			const auto handle = cbMgr.AddCallback([&](int i)
+				{
+					isEntered = true;
+					while(!isReleased)
+					{
+						std::this_thread::yield();
+					}
+					if(i < 0)
+					{
+						throw std::runtime_error("Test");
+					}
+					sum += i;
+				}, { 1, MailboxOverflowPolicy::Block });
+
+			Assert::IsTrue(cbMgr.CallAllQueued(1), L"kein Ereignis darf verworfen werden");
+			while(!isEntered)
+			{
+				std::this_thread::yield();
+			}
+			Assert::IsTrue(cbMgr.CallAllQueued(-1), L"kein Ereignis darf verworfen werden");	// Postfach ist voll
+			auto publisher = std::async(std::launch::async, [&cbMgr]()
+				{
+					for(int i = 2; i <= 100; i++)
+					{
+						(void)cbMgr.CallAllQueued(i);
+					}
+				});
+			Assert::IsTrue(publisher.wait_for(20ms) == std::future_status::timeout, L"Aufrufer muss bei vollem Postfach warten");
+			Assert::IsFalse(cbMgr.WaitForMailboxesDrained(10), L"Postfach darf noch nicht geleert sein");
+			isReleased = true;
+			publisher.wait();
+			Assert::IsTrue(cbMgr.WaitForMailboxesDrained(), L"Postfach muss geleert werden");
+			Assert::AreEqual(100*101/2, sum.load(), L"kein Ereignis darf verloren gehen");
+			Assert::AreEqual<size_t>(0, cbMgr.NumDroppedEvents(), L"kein Ereignis darf verworfen werden");
+			Assert::AreEqual<size_t>(1, cbMgr.NumFailedQueuedCalls(handle), L"eine Exception erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_ZeroCopy)
+		{
+			// zählt die Kopien des Ereignisses
+			struct Payload
+			{
+				std::atomic_int* pNumCopies;
+				std::string data = std::string(1024, 'x');
+
+				explicit Payload(std::atomic_int& numCopies) : pNumCopies(&numCopies)
+				{}
+				Payload(const Payload& other) : pNumCopies(other.pNumCopies), data(other.data)
+				{
+					++*pNumCopies;
+				}
+			};
+			constexpr int NUM_CALLBACKS = 8;
+
+			CallbackHandler<Payload>	cbMgr;
+			std::atomic_int				numCopies	= 0;
+			std::atomic_int				numCalls	= 0;
+			const Payload				payload(numCopies);
+
+			for(int i = 0; i < NUM_CALLBACKS; i++)
+			{
+				(void)cbMgr.AddCallback([&numCalls, &payload](const Payload& p)
+					{
+						Assert::AreEqual<size_t>(payload.data.size(), p.data.size(), L"unerwartete Nutzdaten");
+						++numCalls;
+					});
+			}
+			cbMgr.CallAll(payload);
+			Assert::IsTrue(cbMgr.CallAllNoExcept(payload), L"kein Fehler erwartet");
+			cbMgr.CallAllParallel(payload);
+			Assert::AreEqual(0, numCopies.load(), L"synchrone Aufrufe duerfen nicht kopieren");
+
+			Assert::IsTrue(cbMgr.CallAllAsync(payload), L"CallAllAsync() muss erfolgreich sein");
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false), L"kein Fehler erwartet");
+			Assert::AreEqual(1, numCopies.load(), L"asynchrone Aufrufe muessen sich eine Kopie teilen");
+
+			Assert::IsTrue(cbMgr.CallAllQueued(payload), L"kein Ereignis darf verworfen werden");
+			Assert::IsTrue(cbMgr.WaitForMailboxesDrained(5000), L"Postfaecher muessen geleert werden");
+			Assert::AreEqual(2, numCopies.load(), L"Postfaecher muessen sich eine Kopie teilen");
+			Assert::AreEqual(5*NUM_CALLBACKS, numCalls.load(), L"unerwartete Anzahl Aufrufe");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_AsyncCompletion)
+		{
+			CallbackHandler<int>	cbMgr;
+			std::atomic_int			numCompleted = 0;
+
+			// leere Runde ist sofort abgeschlossen
+			auto pEmpty = cbMgr.CallAllAsyncTracked(0);
+			Assert::IsTrue(pEmpty->IsComplete(), L"leere Runde muss abgeschlossen sein");
+			Assert::IsTrue(pEmpty->WaitAny(steady_clock::now()), L"leere Runde muss abgeschlossen sein");
+
+			(void)cbMgr.AddCallback([](int) { std::this_thread::sleep_for(20ms); });
+			(void)cbMgr.AddCallback([](int) { std::this_thread::sleep_for(100ms); });
+			(void)cbMgr.AddCallback([](int i)
+				{
+					std::this_thread::sleep_for(100ms);
+					if(i < 0)
+					{
+						throw std::runtime_error("Test");
+					}
+				});
+
+			auto pCompletion = cbMgr.CallAllAsyncTracked(-1);
+			pCompletion->OnComplete([&numCompleted]() { ++numCompleted; });
+			Assert::AreEqual<size_t>(3, pCompletion->NumStarted(), L"drei gestartete Aufrufe erwartet");
+			Assert::IsTrue(pCompletion->WaitAny(steady_clock::now() + 1s), L"ein Aufruf muss abgeschlossen sein");
+			Assert::IsFalse(pCompletion->WaitAll(steady_clock::now() + 10ms), L"Timeout erwartet");
+
+			// noch laufende Callbacks werden in der naechsten Runde nicht gestartet
+			auto pSkipped = cbMgr.CallAllAsyncTracked(0);
+			Assert::AreEqual<size_t>(1, pSkipped->NumStarted(), L"nur der fertige Callback darf gestartet werden");
+
+			Assert::IsTrue(pCompletion->WaitAll(steady_clock::now() + 1s), L"alle Aufrufe muessen abgeschlossen sein");
+			Assert::IsTrue(pCompletion->IsComplete(), L"Runde muss abgeschlossen sein");
+			Assert::AreEqual<size_t>(3, pCompletion->NumFinished(), L"drei abgeschlossene Aufrufe erwartet");
+			Assert::AreEqual<size_t>(1, pCompletion->NumFailed(), L"eine Exception erwartet");
+			Assert::AreEqual(1, numCompleted.load(), L"Completion-Callback muss einmal aufgerufen werden");
+			pCompletion->OnComplete([&numCompleted]() { ++numCompleted; });
+			Assert::AreEqual(2, numCompleted.load(), L"nach Abschluss muss der Callback sofort aufgerufen werden");
+			pSkipped->WaitAll();
+			Assert::IsFalse(cbMgr.WaitForAsyncCallbacksFinished(true), L"Exception muss false zurueckgeben");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_WaitForAsyncCallbacksBudget)
+		{
+			constexpr int NUM_CALLBACKS = 5;
+
+			CallbackHandler<int> cbMgr;
+			for(int i = 0; i < NUM_CALLBACKS; i++)
+			{
+				(void)cbMgr.AddCallback([](int waitMs) { std::this_thread::sleep_for(milliseconds(waitMs)); });
+			}
+			// der Timeout gilt fuer alle Callbacks zusammen
+			Assert::IsTrue(cbMgr.CallAllAsync(300), L"CallAllAsync() muss erfolgreich sein");
+			auto startTime = steady_clock::now();
+			Assert::IsFalse(cbMgr.WaitForAsyncCallbacksFinished(true, 50), L"Timeout erwartet");
+			Assert::IsTrue(steady_clock::now() - startTime < 200ms, L"Timeout darf nicht je Callback gelten");
+
+			// waehrend des Wartens blockieren Aenderungen der Callback-Liste nicht
+			auto waiter = std::async(std::launch::async, [&cbMgr]() { return cbMgr.WaitForAsyncCallbacksFinished(true); });
+			while(!cbMgr.IsPendingOperation())
+			{
+				std::this_thread::yield();
+			}
+			startTime = steady_clock::now();
+			const auto handle = cbMgr.AddCallback([](int) {});
+			Assert::IsTrue(cbMgr.RemoveCallback(handle), L"RemoveCallback() muss erfolgreich sein");
+			Assert::IsTrue(steady_clock::now() - startTime < 100ms, L"AddCallback() darf nicht blockieren");
+			Assert::IsTrue(waiter.get(), L"kein Fehler erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallbackProfiling)
+		{
+			static_assert(!CallbackHandler<int>::IsProfilingEnabled, "Messung muss ohne ProfilingPolicy entfallen");
+
+			ProfilingCallbackHandler<int>					cbMgr;
+			std::vector<ProfilingCallbackHandler<int>::CallbackHandle>	slowHandles;
+			std::mutex										slowMutex;
+
+			const auto hFast = cbMgr.AddCallback([](int) {});
+			const auto hSlow = cbMgr.AddCallback([](int i)
+				{
+					std::this_thread::sleep_for(5ms);
+					if(i < 0)
+					{
+						throw std::runtime_error("Test");
+					}
+				});
+			cbMgr.SetSlowCallbackHook([&](ProfilingCallbackHandler<int>::CallbackHandle handle, nanoseconds duration)
+				{
+					Assert::IsTrue(duration > 1ms, L"Laufzeit muss ueber dem Budget liegen");
+					std::lock_guard lock(slowMutex);
+					slowHandles.push_back(handle);
+				});
+			Assert::IsTrue(cbMgr.SetCallbackBudget(hFast, 1ms), L"Handle muss gueltig sein");
+			Assert::IsTrue(cbMgr.SetCallbackBudget(hSlow, 1ms), L"Handle muss gueltig sein");
+
+			cbMgr.CallAll(1);
+			Assert::IsFalse(cbMgr.CallAllNoExcept(-1), L"Fehler erwartet");
+			Assert::IsTrue(cbMgr.CallAllAsync(1), L"CallAllAsync() muss erfolgreich sein");
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false), L"kein Fehler erwartet");
+
+			const std::optional<CallbackProfile> optSlow = cbMgr.GetCallbackProfile(hSlow);
+			const std::optional<CallbackProfile> optFast = cbMgr.GetCallbackProfile(hFast);
+			Assert::IsTrue(optSlow.has_value() && optFast.has_value(), L"Statistik erwartet");
+			Assert::AreEqual<uint64_t>(3, optSlow->numCalls, L"Aufrufe aller CallAll-Varianten muessen gezaehlt werden");
+			Assert::AreEqual<uint64_t>(3, optFast->numCalls, L"Aufrufe aller CallAll-Varianten muessen gezaehlt werden");
+			Assert::AreEqual<uint64_t>(3, optSlow->numBudgetExceeded, L"jeder Aufruf ueberschreitet das Budget");
+			Assert::IsTrue(optSlow->totalTime >= 15ms, L"unerwartete Gesamtlaufzeit");
+			Assert::IsTrue((optSlow->maxTime >= 5ms) && (optSlow->maxTime <= optSlow->totalTime), L"unerwartete max. Laufzeit");
+			Assert::AreEqual<uint64_t>(3, std::accumulate(optSlow->histogram.begin(), optSlow->histogram.end(), uint64_t(0)), L"Histogramm muss alle Aufrufe enthalten");
+			Assert::AreEqual<uint64_t>(0, optSlow->histogram[0], L"kein Aufruf unter 1 us erwartet");
+			{
+				std::lock_guard lock(slowMutex);
+				Assert::AreEqual<size_t>(3, slowHandles.size(), L"Hook muss je langsamem Aufruf aufgerufen werden");
+				Assert::IsTrue(std::all_of(slowHandles.begin(), slowHandles.end(), [hSlow](auto handle) { return handle == hSlow; }),
+							   L"Hook darf nur fuer den langsamen Callback aufgerufen werden");
+			}
+
+			Assert::IsTrue(cbMgr.RemoveCallback(hSlow), L"Callback muss entfernt werden");
+			Assert::IsFalse(cbMgr.GetCallbackProfile(hSlow).has_value(), L"keine Statistik fuer entferntes Handle");
+			Assert::IsFalse(cbMgr.SetCallbackBudget(hSlow, 1ms), L"Handle muss ungueltig sein");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallAllAwaitable)
+		{
+			constexpr int NUM_TASKS = 1000;
+
+			ThreadPoolExecutor		executor(2);
+			CallbackHandler<int>	cbMgr(executor);
+			std::atomic_int			sum			= 0;
+			std::atomic_int			numPlain	= 0;
+
+			// viele wartende Coroutinen teilen sich zwei Worker
+			for(int i = 0; i < NUM_TASKS; i++)
+			{
+				(void)cbMgr.AddCallback([&sum, &executor](const int& value) -> CallbackTask
+					{
+						co_await ResumeOn(executor);
+						co_await ResumeOn(executor);
+						if(value < 0)
+						{
+							throw std::runtime_error("Test");
+						}
+						sum += value;
+					});
+			}
+			(void)cbMgr.AddCallback([&numPlain](const int&) { ++numPlain; });
+			Assert::AreEqual<size_t>(NUM_TASKS + 1, cbMgr.Size(), L"unerwartete Anzahl Callbacks");
+
+			bool isResumed = false;
+			SyncWait([](CallbackHandler<int>& cbMgr, bool& isResumed) -> CallbackTask
+				{
+					co_await cbMgr.CallAllAwaitable(2);
+					isResumed = true;
+				}(cbMgr, isResumed));
+			Assert::IsTrue(isResumed, L"erwartende Coroutine muss fortgesetzt werden");
+			Assert::AreEqual(2*NUM_TASKS, sum.load(), L"alle Coroutinen muessen abgeschlossen sein");
+			Assert::AreEqual(1, numPlain.load(), L"gewoehnlicher Callback muss aufgerufen werden");
+
+			// Exception wird beim Fortsetzen geworfen, alle Callbacks laufen trotzdem
+			bool isThrown = false;
+			try
+			{
+				SyncWait([](CallbackHandler<int>& cbMgr) -> CallbackTask
+					{
+						co_await cbMgr.CallAllAwaitable(-1);
+					}(cbMgr));
+			}
+			catch(const std::runtime_error&)
+			{
+				isThrown = true;
+			}
+			Assert::IsTrue(isThrown, L"Exception erwartet");
+			Assert::AreEqual(2, numPlain.load(), L"gewoehnlicher Callback muss aufgerufen werden");
+
+			// asynchrone Aufrufe belegen keinen Worker, solange die Coroutinen im selben Executor warten
+			sum = 0;
+			const auto pCompletion = cbMgr.CallAllAsyncTracked(1);
+			Assert::IsTrue(pCompletion->WaitAll(std::chrono::steady_clock::now() + 5s), L"CallAllAsyncTracked() darf nicht blockieren");
+			Assert::AreEqual(NUM_TASKS, sum.load(), L"alle Coroutinen muessen abgeschlossen sein");
+			Assert::AreEqual(3, numPlain.load(), L"gewoehnlicher Callback muss aufgerufen werden");
+
+			sum = 0;
+			Assert::IsTrue(cbMgr.CallAllQueued(1), L"kein Ereignis darf verworfen werden");
+			Assert::IsTrue(cbMgr.WaitForMailboxesDrained(5000), L"CallAllQueued() darf nicht blockieren");
+			Assert::AreEqual(NUM_TASKS, sum.load(), L"alle Coroutinen muessen abgeschlossen sein");
+			Assert::AreEqual(4, numPlain.load(), L"gewoehnlicher Callback muss aufgerufen werden");
+
+			// synchrone Aufrufe weisen Coroutinen ab, statt blockierend zu warten
+			isThrown = false;
+			try
+			{
+				cbMgr.CallAll(1);
+			}
+			catch(const std::logic_error&)
+			{
+				isThrown = true;
+			}
+			Assert::IsTrue(isThrown, L"CallAll() muss Coroutinen abweisen");
+			Assert::IsFalse(cbMgr.CallAllParallelNoExcept(1), L"CallAllParallelNoExcept() muss Coroutinen abweisen");
+
+			// leere Runde wird ohne Unterbrechung fortgesetzt
+			CallbackHandler<int> emptyMgr;
+			isResumed = false;
+			SyncWait([](CallbackHandler<int>& cbMgr, bool& isResumed) -> CallbackTask
+				{
+					co_await cbMgr.CallAllAwaitable(0);
+					isResumed = true;
+				}(emptyMgr, isResumed));
+			Assert::IsTrue(isResumed, L"leere Runde muss sofort fortgesetzt werden");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CallbackAffinity)
+		{
+			constexpr int NUM_EVENTS = 1000;
+
+			EventLoop					loop;
+			std::atomic_int				numLoopCalls	= 0;
+			std::atomic_int				numWrongThread	= 0;
+			std::atomic_int				numLocalCalls	= 0;
+			CallbackHandler<int>		handler;
+			std::thread					loopThread([&loop]() { loop.Run(); });
+
+			const auto boundHandle = handler.AddCallback([&](const int& i)
+				{
+					if(!loop.IsCurrentThread())
+					{
+						++numWrongThread;
+					}
+					numLoopCalls += i;
+				}, loop, { NUM_EVENTS, MailboxOverflowPolicy::Block });
+			const auto localHandle = handler.AddCallback([&](const int& i) { numLocalCalls += i; });
+
+			for(int i = 0; i < NUM_EVENTS; i++)
+			{
+				handler.CallAll(1);
+			}
+			Assert::AreEqual(NUM_EVENTS, numLocalCalls.load(), L"ungebundener Callback muss direkt aufgerufen werden");
+			const std::array<std::tuple<int>, 3> batch = { std::tuple<int>(1), std::tuple<int>(1), std::tuple<int>(1) };
+			handler.CallAllBatch(batch);
+			handler.CallAllParallel(1);
+			Assert::IsTrue(handler.WaitForMailboxesDrained(5000), L"Postfaecher muessen geleert werden");
+			Assert::AreEqual(NUM_EVENTS + 4, numLoopCalls.load(), L"jedes Ereignis muss in der Schleife ankommen");
+			Assert::AreEqual(0, numWrongThread.load(), L"gebundener Callback nur im Thread der Schleife");
+			Assert::AreEqual<size_t>(0, handler.NumDroppedEvents(), L"kein Ereignis darf verworfen werden");
+
+			// Aufruf aus dem Thread der Schleife erfolgt direkt
+			struct CallFromLoop : ExecutorTask
+			{
+				CallbackHandler<int>&	handler;
+				const std::atomic_int&	numLoopCalls;
+				bool					isInline = false;
+				CallFromLoop(CallbackHandler<int>& h, const std::atomic_int& n) : handler(h), numLoopCalls(n) {}
+				void Run() override
+				{
+					const int before = numLoopCalls.load();
+					handler.CallAll(1);
+					isInline = (numLoopCalls.load() == before + 1);
+				}
+			} callFromLoop(handler, numLoopCalls);
+			std::promise<void> isRun;
+			struct SetPromise : ExecutorTask
+			{
+				std::promise<void>& promise;
+				explicit SetPromise(std::promise<void>& p) : promise(p) {}
+				void Run() override { promise.set_value(); }
+			} setPromise(isRun);
+			Assert::IsTrue(loop.Post(callFromLoop) && loop.Post(setPromise), L"Schleife muss Aufgaben annehmen");
+			isRun.get_future().wait();
+			Assert::IsTrue(callFromLoop.isInline, L"Aufruf im Thread der Schleife muss direkt erfolgen");
+
+			// CallAllAsync() stellt ebenfalls in die Schleife ein
+			Assert::IsTrue(handler.CallAllAsync(1), L"CallAllAsync muss erfolgreich sein");
+			Assert::IsTrue(handler.WaitForAsyncCallbacksFinished(false, 5000), L"asynchrone Aufrufe muessen abgeschlossen werden");
+			Assert::AreEqual(NUM_EVENTS + 6, numLoopCalls.load(), L"asynchroner Aufruf muss in der Schleife ankommen");
+			Assert::AreEqual(0, numWrongThread.load(), L"gebundener Callback nur im Thread der Schleife");
+
+			Assert::IsTrue(handler.RemoveCallback(boundHandle) && handler.RemoveCallback(localHandle), L"Callbacks muessen entfernt werden");
+			loop.Stop();
+			loopThread.join();
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_AsyncOverrunPolicy)
+		{
+			CallbackHandler<int>	cbMgr;
+			std::atomic_bool		isReleased	= false;
+			std::vector<int>		received;	// nur ein Aufruf gleichzeitig je Callback
+
+			(void)cbMgr.AddCallback([&](int i)
+				{
+					if(i < 20 && (i%10) == 0)
+					{
+						isReleased.wait(false);
+					}
+					received.push_back(i);
+				});
+			Assert::IsTrue(cbMgr.GetAsyncOverrunOptions().policy == AsyncOverrunPolicy::Skip, L"Skip ist Standard");
+
+			// Coalesce: nach dem laufenden Aufruf nur noch das neueste Ereignis
+			cbMgr.SetAsyncOverrunOptions({ AsyncOverrunPolicy::Coalesce });
+			for(int i = 0; i < 4; i++)
+			{
+				(void)cbMgr.CallAllAsync(i);
+			}
+			Assert::AreEqual<size_t>(2, cbMgr.NumCoalescedAsyncCalls(), L"zwei ersetzte Ereignisse erwartet");
+			isReleased = true;
+			isReleased.notify_all();
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false, 5000), L"Aufrufe muessen abgeschlossen werden");
+			Assert::IsTrue(received == std::vector<int>{ 0, 3 }, L"erstes und neuestes Ereignis erwartet");
+
+			// Queue: bis zu zwei eingereihte Ereignisse, weitere werden verworfen
+			received.clear();
+			isReleased = false;
+			cbMgr.SetAsyncOverrunOptions({ AsyncOverrunPolicy::Queue, 2 });
+			auto pCompletion = cbMgr.CallAllAsyncTracked(10);
+			for(int i = 11; i < 14; i++)
+			{
+				(void)cbMgr.CallAllAsync(i);
+			}
+			Assert::AreEqual<size_t>(1, cbMgr.NumDroppedAsyncCalls(), L"ein verworfenes Ereignis erwartet");
+			isReleased = true;
+			isReleased.notify_all();
+			pCompletion->WaitAll();
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false, 5000), L"Aufrufe muessen abgeschlossen werden");
+			Assert::IsTrue(received == std::vector<int>{ 10, 11, 12 }, L"Ereignisse in Reihenfolge erwartet");
+
+			// RateLimit: hoechstens ein Aufruf je Intervall
+			received.clear();
+			cbMgr.SetAsyncOverrunOptions({ AsyncOverrunPolicy::RateLimit, 1, 1h });
+			(void)cbMgr.CallAllAsync(20);
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false, 5000), L"Aufruf muss abgeschlossen werden");
+			(void)cbMgr.CallAllAsync(21);
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false, 5000), L"kein Aufruf darf ausstehen");
+			Assert::IsTrue(received == std::vector<int>{ 20 }, L"nur ein Aufruf je Intervall erwartet");
+			Assert::AreEqual<size_t>(2, cbMgr.NumDroppedAsyncCalls(), L"zwei verworfene Ereignisse erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_CompletionSlot)
+		{
+			CompletionSlot slot;
+			Assert::IsFalse(slot.HasResult() || slot.IsPending(), L"neuer Slot muss leer sein");
+
+			Assert::IsTrue(slot.Start(), L"Start muss erfolgreich sein");
+			Assert::IsFalse(slot.Start(), L"laufender Vorgang darf nicht erneut starten");
+			Assert::IsTrue(slot.IsPending() && slot.HasResult(), L"Vorgang muss laufen");
+			Assert::IsFalse(slot.WaitUntil(steady_clock::now() + 10ms), L"Timeout erwartet");
+
+			slot.Complete(std::make_exception_ptr(std::runtime_error("Test")));
+			Assert::IsTrue(!slot.IsPending() && slot.HasResult(), L"Ergebnis muss vorliegen");
+			Assert::ExpectException<std::runtime_error>([&slot]() { slot.Get(); }, L"Exception muss geworfen werden");
+			Assert::IsFalse(slot.HasResult(), L"Ergebnis muss abgeholt sein");
+
+			// Abschluss aus einem anderen Thread weckt Wartende mit und ohne Timeout
+			Assert::IsTrue(slot.Start(), L"Start muss erfolgreich sein");
+			std::thread completer([&slot]()
+				{
+					std::this_thread::sleep_for(20ms);
+					slot.Complete(nullptr);
+				});
+			std::thread waiter([&slot]() { slot.Wait(); });
+			Assert::IsTrue(slot.WaitUntil(steady_clock::now() + 5s), L"Abschluss muss gemeldet werden");
+			waiter.join();
+			completer.join();
+			slot.Get();
+			Assert::IsFalse(slot.HasResult(), L"Ergebnis muss abgeholt sein");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_ReentrantModification)
+		{
+			using Handler = CallbackHandler<int>;
+			Handler					cbMgr;
+			std::vector<int>		calls;
+			Handler::CallbackHandle	handleB		= -1;
+			Handler::CallbackHandle	handleC		= -1;
+
+			// A entfernt B und sich selbst und fuegt C hinzu, die laufende Runde sieht noch A und B
+			Handler::CallbackHandle handleA = cbMgr.AddCallback([&](const int&)
+				{
+					calls.push_back(1);
+					if(handleC < 0)
+					{
+						Assert::IsTrue(cbMgr.RemoveCallback(handleB) && cbMgr.RemoveCallback(handleA), L"Callbacks muessen entfernt werden");
+						handleC = cbMgr.AddCallback([&](const int&) { calls.push_back(3); });
+					}
+				});
+			handleB = cbMgr.AddCallback([&](const int&) { calls.push_back(2); });
+
+			cbMgr.CallAll(0);
+			Assert::IsTrue(calls == std::vector<int>{ 1, 2 }, L"laufende Runde muss den bisherigen Schnappschuss abarbeiten");
+			calls.clear();
+			cbMgr.CallAll(0);
+			Assert::IsTrue(calls == std::vector<int>{ 3 }, L"Aenderungen muessen ab der naechsten Runde wirken");
+			Assert::AreEqual<size_t>(1, cbMgr.Size(), L"nur C erwartet");
+
+			// asynchroner Callback entfernt sich selbst, ohne auf sich zu warten
+			std::atomic_bool		isRemoved	= false;
+			Handler::CallbackHandle	handleD		= -1;
+			handleD = cbMgr.AddCallback([&](const int& i)
+				{
+					if(i == 1)
+					{
+						Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false), L"darf nicht auf sich selbst warten");
+						isRemoved = cbMgr.RemoveCallback(handleD);
+					}
+				});
+			Assert::IsTrue(cbMgr.CallAllAsync(1), L"CallAllAsync muss erfolgreich sein");
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false, 5000), L"asynchrone Aufrufe muessen abgeschlossen werden");
+			Assert::IsTrue(isRemoved.load(), L"Callback muss sich selbst entfernen");
+			Assert::AreEqual<size_t>(1, cbMgr.Size(), L"nur C erwartet");
+			Assert::IsTrue(cbMgr.RemoveCallback(handleC), L"C muss entfernt werden");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_PriorityCallbacks)
+		{
+			CallbackHandler<int>	cbMgr;
+			std::vector<int>		calls;
+			int						numPlainCalls = 0;
+			auto Filter = [&calls](int id, bool isStopOnNegative)
+				{
+					return [&calls, id, isStopOnNegative](const int& i)
+						{
+							calls.push_back(id);
+							return (isStopOnNegative && (i < 0)) ? CallbackResult::Stop : CallbackResult::Continue;
+						};
+				};
+
+			const auto handleLate	= cbMgr.AddPriorityCallback(Filter(0, false), 0);
+			const auto handleFirst	= cbMgr.AddPriorityCallback(Filter(1, false), 10);
+			const auto handleMiddle	= cbMgr.AddPriorityCallback(Filter(3, true), 5);
+			const auto handleSecond	= cbMgr.AddPriorityCallback(Filter(2, false), 10);
+			const auto handlePlain	= cbMgr.AddCallback([&numPlainCalls](const int&) { ++numPlainCalls; });
+			Assert::AreEqual<size_t>(5, cbMgr.Size(), L"fuenf Callbacks erwartet");
+			Assert::IsTrue(cbMgr.IsCallbackHandleValid(handleMiddle), L"Handle muss gueltig sein");
+
+			Assert::IsTrue(cbMgr.CallUntilStop(1) == CallbackResult::Continue, L"Durchlauf darf nicht beendet werden");
+			Assert::IsTrue(calls == std::vector<int>{ 1, 2, 3, 0 }, L"absteigende Prioritaet, bei Gleichstand Anmeldereihenfolge");
+			Assert::AreEqual(0, numPlainCalls, L"gewoehnliche Callbacks duerfen nicht aufgerufen werden");
+
+			calls.clear();
+			Assert::IsTrue(cbMgr.CallUntilStop(-1) == CallbackResult::Stop, L"Durchlauf muss beendet werden");
+			Assert::IsTrue(calls == std::vector<int>{ 1, 2, 3 }, L"nachrangiger Callback darf nicht aufgerufen werden");
+
+			cbMgr.CallAll(0);
+			Assert::AreEqual(1, numPlainCalls, L"CallAll ruft nur gewoehnliche Callbacks auf");
+
+			Assert::IsTrue(cbMgr.RemoveCallback(handleMiddle), L"Callback muss entfernt werden");
+			Assert::IsFalse(cbMgr.RemoveCallback(handleMiddle), L"Callback darf nicht mehr existieren");
+			Assert::IsFalse(cbMgr.IsCallbackHandleValid(handleMiddle), L"Handle darf nicht mehr gueltig sein");
+			calls.clear();
+			Assert::IsTrue(cbMgr.CallUntilStop(-1) == CallbackResult::Continue, L"Durchlauf darf nicht beendet werden");
+			Assert::IsTrue(calls == std::vector<int>{ 1, 2, 0 }, L"entfernter Callback darf nicht aufgerufen werden");
+
+			// der freigegebene Index wird mit neuer Generation wiederverwendet
+			const auto handleReused = cbMgr.AddCallback([](const int&) {});
+			Assert::AreEqual(static_cast<uint32_t>(handleMiddle), static_cast<uint32_t>(handleReused), L"Index muss wiederverwendet werden");
+			Assert::IsFalse(cbMgr.RemoveCallback(handleMiddle), L"veraltetes Handle darf nichts entfernen");
+
+			cbMgr.SetAsyncOverrunOptions({ AsyncOverrunPolicy::Coalesce });
+			Assert::IsTrue(cbMgr.RemoveCallback(handleFirst) && cbMgr.RemoveCallback(handleSecond) && cbMgr.RemoveCallback(handleLate),
+						   L"Callbacks muessen entfernt werden");
+			Assert::IsTrue(cbMgr.RemoveCallback(handlePlain) && cbMgr.RemoveCallback(handleReused), L"Callbacks muessen entfernt werden");
+			Assert::AreEqual<size_t>(0, cbMgr.Size(), L"Handler muss leer sein");
+			Assert::IsTrue(cbMgr.CallUntilStop(-1) == CallbackResult::Continue, L"leere Kette");
+			(void)cbMgr.AddPriorityCallback(Filter(4, true), 1);
+			cbMgr.RemoveAllCallbacks();
+			Assert::AreEqual<size_t>(0, cbMgr.Size(), L"Handler muss leer sein");
+			Assert::IsTrue(cbMgr.GetAsyncOverrunOptions().policy == AsyncOverrunPolicy::Coalesce, L"Einstellung muss erhalten bleiben");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_HandleGeneration)
+		{
+			CallbackHandler<int, std::string>	cbMgr;
+			int									value = 0;
+
+			const auto staleHandle = cbMgr.AddCallback([&](int i, const std::string&) { value = i; });
+			Assert::IsTrue(cbMgr.RemoveCallback(staleHandle), L"RemoveCallback() muss erfolgreich sein");
+			Assert::IsFalse(cbMgr.RemoveCallback(staleHandle), L"doppeltes Entfernen muss fehlschlagen");
+
+			// der freie Slot wird wiederverwendet, das alte Handle bleibt ungueltig
+			const auto handle = cbMgr.AddCallback([&](int i, const std::string&) { value = 2*i; });
+			Assert::AreNotEqual(staleHandle, handle, L"Handle muss sich durch die Generation unterscheiden");
+			Assert::IsFalse(cbMgr.IsCallbackHandleValid(staleHandle), L"veraltetes Handle darf nicht gueltig sein");
+			Assert::IsFalse(cbMgr.RemoveCallback(staleHandle), L"veraltetes Handle darf keinen neuen Callback entfernen");
+			cbMgr.CallAll(1, "TestGeneration");
+			Assert::AreEqual(2, value, L"neuer Callback muss aufgerufen werden");
+
+			cbMgr.RemoveAllCallbacks();
+			Assert::IsFalse(cbMgr.IsCallbackHandleValid(handle), L"Handle muss nach RemoveAllCallbacks() ungueltig sein");
+			const auto newHandle = cbMgr.AddCallback([](int, const std::string&) {});
+			Assert::IsFalse(cbMgr.IsCallbackHandleValid(handle), L"Handle muss auch nach Wiederverwendung ungueltig sein");
+
+			// viele Slots: nur belegte Slots werden aufgerufen, in der Reihenfolge der Slots
+			std::vector<int> calls;
+			std::vector<CallbackHandler<int, std::string>::CallbackHandle> handles;
+			for(int i = 0; i < 1000; i++)
+			{
+				handles.push_back(cbMgr.AddCallback([&calls, i](int, const std::string&) { calls.push_back(i); }));
+			}
+			for(int i = 0; i < 1000; i++)
+			{
+				if((i % 7) != 0)
+				{
+					Assert::IsTrue(cbMgr.RemoveCallback(handles[i]), L"RemoveCallback() muss erfolgreich sein");
+				}
+			}
+			Assert::IsTrue(cbMgr.RemoveCallback(newHandle), L"RemoveCallback() muss erfolgreich sein");
+			Assert::AreEqual<size_t>(143, cbMgr.Size(), L"unerwartete Anzahl Callbacks");
+			cbMgr.CallAll(0, "TestGeneration");
+			Assert::AreEqual<size_t>(143, calls.size(), L"nur belegte Slots duerfen aufgerufen werden");
+			Assert::IsTrue(std::is_sorted(calls.begin(), calls.end()), L"Aufrufreihenfolge muss der Slot-Reihenfolge entsprechen");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_InplaceFunction)
+		{
+			auto pCounter = std::make_shared<int>(0);
+
+			InplaceFunction<int(int), 32> empty;
+			Assert::IsFalse(static_cast<bool>(empty), L"Standard-InplaceFunction muss leer sein");
+
+			InplaceFunction<int(int), 32> func = [pCounter](int i) { return *pCounter += i; };
+			Assert::IsTrue(static_cast<bool>(func), L"InplaceFunction darf nicht leer sein");
+			Assert::AreEqual(2, func(2), L"unerwarteter Rueckgabewert");
+
+			InplaceFunction<int(int), 32> copy = func;
+			Assert::AreEqual(5, copy(3), L"Kopie muss auf denselben Zaehler zugreifen");
+			Assert::AreEqual<long>(3, pCounter.use_count(), L"Capture muss kopiert werden");
+
+			InplaceFunction<int(int), 32> moved = std::move(func);
+			Assert::IsFalse(static_cast<bool>(func), L"verschobene InplaceFunction muss leer sein");
+			Assert::AreEqual(6, moved(1), L"unerwarteter Rueckgabewert");
+			Assert::AreEqual<long>(3, pCounter.use_count(), L"Capture darf beim Verschieben nicht kopiert werden");
+
+			copy	= nullptr;
+			moved	= empty;
+			Assert::AreEqual<long>(1, pCounter.use_count(), L"Capture muss zerstoert werden");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_InplaceCallbackHandler)
+		{
+			InplaceCallbackHandler<32, int, std::string>	cbMgr;
+			std::atomic_int									sum = 0;
+
+			auto handle1 = cbMgr.AddCallback([&sum](int i, const std::string&) { sum += i; });
+			auto handle2 = cbMgr.AddCallback([&sum](int i, const std::string&) { sum += 10*i; });
+			Assert::AreEqual<size_t>(2, cbMgr.Size(), L"zwei Callbacks erwartet");
+
+			cbMgr.CallAll(1, "TestInplace");
+			Assert::AreEqual(11, sum.load(), L"unerwartete Summe nach CallAll()");
+
+			Assert::IsTrue(cbMgr.CallAllAsync(2, "TestInplace"), L"CallAllAsync() muss erfolgreich sein");
+			Assert::IsTrue(cbMgr.WaitForAsyncCallbacksFinished(false), L"kein Fehler erwartet");
+			Assert::AreEqual(33, sum.load(), L"unerwartete Summe nach CallAllAsync()");
+
+			Assert::IsTrue(cbMgr.RemoveCallback(handle1), L"RemoveCallback() muss erfolgreich sein");
+			Assert::IsFalse(cbMgr.IsCallbackHandleValid(handle1), L"Handle muss ungueltig sein");
+			cbMgr.CallAll(1, "TestInplace");
+			Assert::AreEqual(43, sum.load(), L"nur der verbleibende Callback darf aufgerufen werden");
+			Assert::IsTrue(cbMgr.RemoveCallback(handle2), L"RemoveCallback() muss erfolgreich sein");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_InPlaceRegistration)
+		{
+			// zählt Kopien des Callbacks, Verschieben ist erlaubt
+			struct CopyCounter
+			{
+				std::atomic_int* pNumCopies;
+				std::atomic_int* pNumCalls;
+
+				CopyCounter(std::atomic_int& numCopies, std::atomic_int& numCalls) : pNumCopies(&numCopies), pNumCalls(&numCalls) {}
+				CopyCounter(const CopyCounter& other) : pNumCopies(other.pNumCopies), pNumCalls(other.pNumCalls) { ++*pNumCopies; }
+				CopyCounter(CopyCounter&&) = default;
+				void operator()(int, const std::string&) const { ++*pNumCalls; }
+			};
+			using Handler = InplaceCallbackHandler<32, int, std::string>;
+			std::atomic_int							numCopies	= 0;
+			std::atomic_int							numCalls	= 0;
+			Handler									cbMgr;
+			std::vector<Handler::CallbackHandle>	handles;
+
+			cbMgr.AddCallback(CopyCounter(numCopies, numCalls));
+			for(int i = 0; i < 200; ++i) // belegt weitere Blöcke
+			{
+				handles.push_back(cbMgr.AddCallback([](int, const std::string&) {}));
+			}
+			for(size_t i = 0; i < handles.size(); i += 2)
+			{
+				Assert::IsTrue(cbMgr.RemoveCallback(handles[i]), L"RemoveCallback() muss erfolgreich sein");
+			}
+			for(int i = 0; i < 100; ++i) // belegt die frei gewordenen Slots wieder
+			{
+				cbMgr.AddCallback([](int, const std::string&) {});
+			}
+			cbMgr.CallAll(1, "TestInPlace");
+			Assert::AreEqual(1, numCalls.load(), L"Callback muss genau einmal aufgerufen werden");
+			Assert::AreEqual(0, numCopies.load(), L"Anmelden und Entfernen anderer Callbacks darf den Slot nicht kopieren");
+			Assert::AreEqual<size_t>(201, cbMgr.Size(), L"201 Callbacks erwartet");
+		}
+		///----------------------------------------------------------------------------------------------
 		TEST_METHOD(ThreadSafty)
 		{
 			std::atomic_size_t	counter = 0;
-			std::atomic_int		lastHandle = -1;
 
 			CallbackHandler<int, std::string> handler1;
 
-			// Callback aus unabhngigen Thread aufrufen
+			// Callback aus unabhängigen Thread aufrufen
 			auto future1 = std::async(std::launch::async,
 				[&]()
 				{
-					// warten bis der erste Callback hinzugefgt wurde
+					// warten bis der erste Callback hinzugefügt wurde
 					while(handler1.Size() == 0)
 					{;}
 					for(int i = 0; i < 100000; i++)
@@ -199,25 +1205,26 @@ namespace tiel::concurrent
 						handler1.CallAll(i, "TestAsync");
 					}
 				});
-			// Callbacks in unabhngigen Thread immer wieder hinzufgen und entfernen
+			// Callbacks in unabhängigen Thread immer wieder hinzufügen und entfernen
 			auto future2 = std::async(std::launch::async,
 				[&]()
 				{
 					for(int j = 0; j < 10000; j++)
 					{
-						for(int i = 0; i < 10; i++)
+						std::array<CallbackHandler<int, std::string>::CallbackHandle, 10> handles;
+						for(auto& handle : handles)
 						{
-							lastHandle = handler1.AddCallback(
+							handle = handler1.AddCallback(
 								[&](int i, std::string s)
 								{
-									Assert::IsTrue(i >= 0, L"'i' ungltig");
-									Assert::IsFalse(s.empty(), L"'s' ungltig");
+									Assert::IsTrue(i >= 0, L"'i' ungültig");
+									Assert::IsFalse(s.empty(), L"'s' ungültig");
 									++counter;
 								});
 						}
-						for(int i = 0; i < 10; i++)
+						for(const auto handle : handles)
 						{
-							handler1.RemoveCallback(i);
+							Assert::IsTrue(handler1.RemoveCallback(handle), L"RemoveCallback() muss erfolgreich sein");
 						}
 					}
 				});
@@ -0,0 +1,139 @@
+#include "pch.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CppUnitTest.h"
+#include "EventBus.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std::chrono_literals;
+
+namespace tiel::concurrent
+{
+	TEST_CLASS(Test_EventBus)
+	{
+	public:
+
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_ExactTopics)
+		{
+			EventBus<int>	bus;
+			int				sumA	= 0;
+			std::atomic_int	sumB	= 0;
+
+			const auto subA1 = bus.Subscribe("a/b", [&sumA](const int& i) { sumA += i; });
+			const auto subA2 = bus.Subscribe("a/b", [&sumA](const int& i) { sumA += 10*i; });
+			const auto subB	 = bus.Subscribe("a/c", [&sumB](const int& i) { sumB += i; });
+			Assert::IsTrue(subA1.IsValid() && subA2.IsValid() && subB.IsValid(), L"Abonnements muessen gueltig sein");
+			Assert::AreEqual<size_t>(2, bus.NumTopics(), L"unerwartete Anzahl Topics");
+
+			Assert::AreEqual<size_t>(1, bus.Publish("a/b", 1), L"genau ein Topic erwartet");
+			Assert::AreEqual<size_t>(0, bus.Publish("a/x", 1), L"kein Topic erwartet");
+			Assert::AreEqual(11, sumA, L"beide Callbacks von a/b muessen aufgerufen werden");
+			Assert::AreEqual(0, sumB.load(), L"a/c darf nicht aufgerufen werden");
+
+			Assert::IsTrue(bus.Unsubscribe(subA1), L"Abonnement muss bestehen");
+			Assert::IsFalse(bus.Unsubscribe(subA1), L"Abonnement darf nicht mehr bestehen");
+			Assert::AreEqual<size_t>(2, bus.NumTopics(), L"a/b hat noch einen Callback");
+			Assert::IsTrue(bus.Unsubscribe(subA2), L"Abonnement muss bestehen");
+			Assert::AreEqual<size_t>(1, bus.NumTopics(), L"leeres Topic muss entfernt werden");
+			Assert::AreEqual<size_t>(0, bus.Publish("a/b", 1), L"kein Topic erwartet");
+
+			Assert::AreEqual<size_t>(1, bus.PublishQueued("a/c", 5), L"genau ein Topic erwartet");
+			for(int i = 0; (i < 5000) && (sumB.load() != 5); i++)
+			{
+				std::this_thread::sleep_for(1ms);
+			}
+			Assert::AreEqual(5, sumB.load(), L"Ereignis muss zugestellt werden");
+			Assert::IsTrue(bus.Unsubscribe(subB), L"Abonnement muss bestehen");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_Patterns)
+		{
+			EventBus<std::string>		bus;
+			std::vector<std::string>	received;
+			auto Record = [&received](const char* pName)
+				{
+					return [&received, pName](const std::string& topic) { received.push_back(std::string(pName) + ":" + topic); };
+				};
+
+			const auto subSingle	= bus.Subscribe("sensor/+/temp", Record("single"));
+			const auto subMulti		= bus.Subscribe("sensor/#", Record("multi"));
+			const auto subAll		= bus.Subscribe("#", Record("all"));
+			const auto subExact		= bus.Subscribe("sensor/1/temp", Record("exact"));
+			Assert::IsFalse(bus.Subscribe("sensor/#/temp", Record("invalid")).IsValid(), L"# nur als letzte Ebene");
+			Assert::AreEqual<size_t>(3, bus.NumPatterns(), L"unerwartete Anzahl Muster");
+			Assert::AreEqual<size_t>(1, bus.NumTopics(), L"unerwartete Anzahl Topics");
+
+			Assert::AreEqual<size_t>(4, bus.Publish("sensor/1/temp", "sensor/1/temp"), L"alle Abonnements muessen passen");
+			Assert::AreEqual<size_t>(2, bus.Publish("sensor/2/humidity", "sensor/2/humidity"), L"multi und all erwartet");
+			Assert::AreEqual<size_t>(2, bus.Publish("sensor", "sensor"), L"# muss auch keine weitere Ebene erfassen");
+			Assert::AreEqual<size_t>(1, bus.Publish("other", "other"), L"nur all erwartet");
+			Assert::AreEqual<size_t>(9, received.size(), L"unerwartete Anzahl Aufrufe");
+			Assert::IsTrue(std::find(received.begin(), received.end(), "single:sensor/1/temp") != received.end(), L"+ muss eine Ebene erfassen");
+
+			Assert::IsTrue(bus.Unsubscribe(subAll), L"Abonnement muss bestehen");
+			Assert::IsTrue(bus.Unsubscribe(subMulti), L"Abonnement muss bestehen");
+			Assert::AreEqual<size_t>(1, bus.NumPatterns(), L"leere Muster muessen entfernt werden");
+			received.clear();
+			Assert::AreEqual<size_t>(0, bus.Publish("other", "other"), L"kein Abonnement erwartet");
+			Assert::AreEqual<size_t>(1, bus.Publish("sensor/7/temp", "sensor/7/temp"), L"nur single erwartet");
+			Assert::AreEqual<size_t>(1, received.size(), L"nur single erwartet");
+
+			Assert::IsTrue(bus.Unsubscribe(subSingle), L"Abonnement muss bestehen");
+			Assert::IsTrue(bus.Unsubscribe(subExact), L"Abonnement muss bestehen");
+			Assert::AreEqual<size_t>(0, bus.NumPatterns() + bus.NumTopics(), L"Bus muss leer sein");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_ConcurrentPublish)
+		{
+			constexpr int NUM_TOPICS		= 1000;
+			constexpr int NUM_PUBLISHERS	= 4;
+			constexpr int NUM_ROUNDS		= 20;
+
+			EventBus<int>		bus;
+			std::atomic_int		numCalls	= 0;
+			std::atomic_bool	isStopping	= false;
+
+			for(int i = 0; i < NUM_TOPICS; i++)
+			{
+				(void)bus.Subscribe("topic/" + std::to_string(i), [&numCalls](const int&) { ++numCalls; });
+			}
+			// gleichzeitig an- und abmelden, auch Muster
+			std::thread subscriber([&]()
+				{
+					while(!isStopping.load())
+					{
+						const auto subTopic		= bus.Subscribe("extra/topic", [](const int&) {});
+						const auto subPattern	= bus.Subscribe("extra/+", [](const int&) {});
+						Assert::IsTrue(bus.Unsubscribe(subTopic) && bus.Unsubscribe(subPattern), L"Abonnement muss bestehen");
+					}
+				});
+			std::vector<std::thread> publishers;
+			for(int p = 0; p < NUM_PUBLISHERS; p++)
+			{
+				publishers.emplace_back([&bus]()
+					{
+						for(int round = 0; round < NUM_ROUNDS; round++)
+						{
+							for(int i = 0; i < NUM_TOPICS; i++)
+							{
+								(void)bus.Publish("topic/" + std::to_string(i), i);
+							}
+							(void)bus.Publish("extra/topic", 0);
+						}
+					});
+			}
+			for(std::thread& publisher : publishers)
+			{
+				publisher.join();
+			}
+			isStopping = true;
+			subscriber.join();
+			Assert::AreEqual(NUM_PUBLISHERS*NUM_ROUNDS*NUM_TOPICS, numCalls.load(), L"jedes Ereignis muss genau einmal ankommen");
+			Assert::AreEqual<size_t>(NUM_TOPICS, bus.NumTopics(), L"unerwartete Anzahl Topics");
+		}
+	};
+}
@@ -5,6 +5,8 @@
 #include <array>
 #include <memory>
 #include <thread>
+#include <string>
+#include <filesystem>
 #include "CppUnitTest.h"
 #include "ConcurrentQueue.h"
 
@@ -26,7 +28,7 @@ namespace tiel::concurrent::container
 				LockFreeQueue<int64_t>	queue(NUM_PUSHES);
 				std::vector<int64_t>	pops(NUM_PUSHES, 0);
 
-				// fllen->zurcksetzen->fllen->schlieen-lesen
+				// füllen->zurücksetzen->füllen->schließen-lesen
 				Assert::IsTrue(queue.IsEmpty(), L"Queue muss leer sein");
 				for(size_t i = 1; i <= queue.MaxSize(); i++)
 				{
@@ -57,7 +59,7 @@ namespace tiel::concurrent::container
 					pops[i] = queue.TryPop().value_or(0);
 				}
 				int64_t	sumAllResults = std::accumulate(pops.begin(), pops.end(), 0LL);
-				Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+				Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 			}
 			//  Move-Konstruktor Move-Zuweisung
 			{
@@ -83,7 +85,7 @@ namespace tiel::concurrent::container
 					pops[i] = queue1.TryPop().value_or(0);
 				}
 				int64_t	sumAllResults = std::accumulate(pops.begin(), pops.end(), 0LL);
-				Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+				Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 			}
 
 		}
@@ -105,7 +107,7 @@ namespace tiel::concurrent::container
 			Assert::IsTrue(queue.TryPush(42), L"Push() muss erfolgreich sein");
 			Assert::IsFalse(queue.IsEmpty(), L"Queue darf nicht leer sein");
 			Assert::IsTrue(queue.RemoveByFilter(filterElements), L"es muessen Elemente herausgefilter worden sein");
-			Assert::AreEqual<size_t>(3ULL, queue.Size(), L"unerwartete Anzahl verbleibender Elemente"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(3ULL, queue.Size(), L"unerwartete Anzahl verbleibender Elemente"); // <size_t> für VS2017 erforderlich
 			Assert::IsFalse(queue.IsEmpty(), L"Queue darf nicht leer sein");
 			Assert::IsFalse(queue.RemoveByFilter(filterElements), L"es duefen keine weiteren Elemente herausgefilter worden sein");
 			Assert::IsTrue(queue.RemoveByFilter(filterAllElements), L"alle uebrigen Elemente muessen herausgefilter worden sein");
@@ -123,17 +125,17 @@ namespace tiel::concurrent::container
 				Assert::IsTrue(queue.TryPush(i), L"TryPush(): unerwartet fehlgeschlagen");
 			}
 			Assert::IsTrue(queue.IsFull(), L"Queue muss voll sein");
-			Assert::IsFalse(queue.TryPush(42), L"TryPush() muss bei voller Queue FALSE zurckgeben");
+			Assert::IsFalse(queue.TryPush(42), L"TryPush() muss bei voller Queue FALSE zurückgeben");
 			Assert::IsTrue(queue.IsFull(), L"Queue muss voll sein");
 			for(int i = 0; i < static_cast<int>(QUEUE_SIZE); i++)
 			{
 				auto opti = queue.TryPop();
-				Assert::IsTrue(opti.has_value(), L"TryPop() muss gltiges std::optional<T> liefern");
+				Assert::IsTrue(opti.has_value(), L"TryPop() muss gültiges std::optional<T> liefern");
 				Assert::AreEqual<int>(opti.value(), i, L"TryPop(): unerwarteter Wert");
 			}
 			Assert::IsTrue(queue.IsEmpty(), L"Queue muss zu beginn leer sein");
 			auto opti = queue.TryPop();
-			Assert::IsFalse(opti.has_value(), L"TryPop() muss auf leere Queue ungltiges std::optional<T> liefern");
+			Assert::IsFalse(opti.has_value(), L"TryPop() muss auf leere Queue ungültiges std::optional<T> liefern");
 			Assert::IsTrue(queue.IsEmpty(), L"Queue muss leer sein");
 
 		}
@@ -149,17 +151,17 @@ namespace tiel::concurrent::container
 				Assert::IsTrue(queue.TryPush(std::make_unique<int>(i)), L"TryPush() : unerwartet fehlgeschlagen");
 			}
 			Assert::IsTrue(queue.IsFull(), L"Queue muss voll sein");
-			Assert::IsFalse(queue.TryPush(std::make_unique<int>(42)), L"TryPush() muss bei voller Queue FALSE zurckgeben");
+			Assert::IsFalse(queue.TryPush(std::make_unique<int>(42)), L"TryPush() muss bei voller Queue FALSE zurückgeben");
 			Assert::IsTrue(queue.IsFull(), L"Queue muss voll sein");
 			for(int i = 0; i < static_cast<int>(QUEUE_SIZE); i++)
 			{
 				auto opti = queue.TryPop();
-				Assert::IsTrue(opti.has_value(), L"TryPop() muss gltiges std::optional<T> liefern");
+				Assert::IsTrue(opti.has_value(), L"TryPop() muss gültiges std::optional<T> liefern");
 				Assert::AreEqual<int>(*opti.value(), i, L"TryPop(): unerwarteter Wert");
 			}
 			Assert::IsTrue(queue.IsEmpty(), L"Queue muss zu beginn leer sein");
 			auto opti = queue.TryPop();
-			Assert::IsFalse(opti.has_value(), L"TryPop() muss auf leere Queue ungltiges std::optional<T> liefern");
+			Assert::IsFalse(opti.has_value(), L"TryPop() muss auf leere Queue ungültiges std::optional<T> liefern");
 			Assert::IsTrue(queue.IsEmpty(), L"Queue muss leer sein");
 		}
 		///----------------------------------------------------------------------------------------------
@@ -208,7 +210,7 @@ namespace tiel::concurrent::container
 			{
 				sumAllResults += std::accumulate(popValues[i].begin(), popValues[i].end(), 0LL);
 			}
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		TEST_METHOD(MultipleProducer)
@@ -258,7 +260,7 @@ namespace tiel::concurrent::container
 			}
 
 			int64_t	sumAllResults = std::accumulate(popValues.begin(), popValues.end(), 0LL);
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		TEST_METHOD(MultipleConsumerProducer)
@@ -322,7 +324,7 @@ namespace tiel::concurrent::container
 			{
 				sumAllResults += std::accumulate(popValues[i].begin(), popValues[i].end(), 0LL);
 			}
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		/// LockFreeQueue nur aus Haupt-Thread
@@ -343,7 +345,7 @@ namespace tiel::concurrent::container
 				pops[i] = queue.TryPop().value_or(0);
 			}
 			int64_t	sumAllResults = std::accumulate(pops.begin(), pops.end(), 0LL);
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
 		}
 		///----------------------------------------------------------------------------------------------
 		/// Vergleichszeiten zur unsynchronisierten Queue aus Haupt-Thread
@@ -365,7 +367,69 @@ namespace tiel::concurrent::container
 				queue.pop();
 			}
 			int64_t	sumAllResults = std::accumulate(pops.begin(), pops.end(), 0LL);
-			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> fr VS2017 erforderlich
+			Assert::AreEqual<size_t>(sumAllResults, SUM_TOTAL, L"unerwartete Summe aller empfangener Werte"); // <size_t> für VS2017 erforderlich
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Snapshot schreiben und wiederherstellen
+		TEST_METHOD(SnapshotRestore)
+		{
+			constexpr size_t	NUM_PUSHES		= 1000;
+			const auto			snapshotPath	= std::filesystem::temp_directory_path() / "UnitTest_LockFreeQueue.snapshot";
+
+			LockFreeQueue<int64_t> queue(NUM_PUSHES);
+			for(size_t i = 1; i <= NUM_PUSHES; i++)
+			{
+				Assert::IsTrue(queue.TryPush(i), L"TryPush(): unerwartet fehlgeschlagen");
+			}
+			Assert::IsTrue(queue.Snapshot(snapshotPath), L"Snapshot() muss erfolgreich sein");
+			Assert::IsTrue(queue.IsEmpty(), L"Queue muss nach Snapshot() leer sein");
+
+			Assert::IsTrue(queue.TryPush(0), L"TryPush(): unerwartet fehlgeschlagen");
+			Assert::IsFalse(queue.Restore(snapshotPath), L"Restore() darf MaxSize() nicht ueberschreiten");
+			Assert::AreEqual<size_t>(1, queue.Size(), L"Queue muss nach fehlgeschlagenem Restore() unveraendert sein");
+			Assert::AreEqual<int64_t>(0, queue.TryPop().value_or(-1), L"unerwarteter Wert");
+
+			Assert::IsTrue(queue.Restore(snapshotPath), L"Restore() muss erfolgreich sein");
+			Assert::IsTrue(queue.IsFull(), L"Queue muss voll sein");
+			for(size_t i = 1; i <= NUM_PUSHES; i++)
+			{
+				Assert::AreEqual<int64_t>(i, queue.TryPop().value_or(0), L"FIFO-Reihenfolge verletzt");
+			}
+			std::filesystem::remove(snapshotPath);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// fehlgeschlagener Snapshot darf MaxSize() auch bei gleichzeitigem TryPush() nicht ueberschreiten
+		TEST_METHOD(SnapshotFailureMaxSize)
+		{
+			constexpr size_t	MAX_SIZE	= 1000;
+			const auto			invalidPath	= std::filesystem::temp_directory_path() / "UnitTest_LockFreeQueue.missing" / "queue.snapshot";
+
+			LockFreeQueue<int64_t>	queue(MAX_SIZE);
+			std::atomic_bool		isDone		= false;
+			for(size_t i = 1; i <= MAX_SIZE; i++)
+			{
+				Assert::IsTrue(queue.TryPush(i), L"TryPush(): unerwartet fehlgeschlagen");
+			}
+			std::thread producer([&queue, &isDone]()
+				{
+					while(!isDone)
+					{
+						(void)queue.TryPush(0);
+					}
+				});
+			for(size_t i = 0; i < 100; i++)
+			{
+				Assert::IsFalse(queue.Snapshot(invalidPath), L"Snapshot() darf nicht erfolgreich sein");
+				Assert::IsTrue(queue.Size() <= MAX_SIZE, L"MaxSize() ueberschritten");
+			}
+			isDone = true;
+			producer.join();
+
+			Assert::AreEqual<size_t>(MAX_SIZE, queue.Size(), L"Elemente verloren");
+			for(size_t i = 1; i <= MAX_SIZE; i++)
+			{
+				Assert::AreEqual<int64_t>(i, queue.TryPop().value_or(0), L"FIFO-Reihenfolge verletzt");
+			}
 		}
 		///----------------------------------------------------------------------------------------------
 	};
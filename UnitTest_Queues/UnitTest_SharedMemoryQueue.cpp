@@ -0,0 +1,120 @@
+#include "pch.h"
+#include <numeric>
+#include <vector>
+#include <thread>
+#include <filesystem>
+#include "CppUnitTest.h"
+#include "SharedMemoryQueue.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace tiel::concurrent::container
+{
+	///_______________________________________________________________________________________________
+	TEST_CLASS(Test_SharedMemoryQueue)
+	{
+	public:
+		///-------------------------------------------------------------------------------------------
+		TEST_METHOD(TestInterface)
+		{
+			const auto path = SharedMemoryQueue<int64_t>::DefaultPath("UnitTest_SharedMemoryQueue.Interface");
+			{
+				SharedMemoryQueue<int64_t>	producer;
+				SharedMemoryQueue<int64_t>	consumer;
+				SharedMemoryQueue<int32_t>	wrongType;
+
+				Assert::IsFalse(consumer.Open(path.string() + ".missing"), L"Open() einer nicht vorhandenen Queue muss fehlschlagen");
+				Assert::IsTrue(producer.Create(path, 6), L"Create() muss erfolgreich sein");
+				Assert::AreEqual<size_t>(8, producer.MaxSize(), L"Kapazitaet muss auf Zweierpotenz aufgerundet werden");
+				Assert::IsTrue(consumer.Open(path), L"Open() muss erfolgreich sein");
+				Assert::IsFalse(wrongType.Open(path), L"Open() mit falschem Elementtyp muss fehlschlagen");
+
+				Assert::IsFalse(consumer.TryPop().has_value(), L"Queue muss leer sein");
+				Assert::IsFalse(consumer.Pop(10).has_value(), L"Pop() muss nach Ablauf der Wartezeit zurueckkehren");
+				for(int64_t i = 1; i <= 8; i++)
+				{
+					Assert::IsTrue(producer.TryPush(i), L"TryPush(): unerwartet fehlgeschlagen");
+				}
+				Assert::IsTrue(consumer.IsFull(), L"Queue muss in allen Instanzen voll sein");
+				Assert::IsFalse(producer.TryPush(9), L"TryPush() in volle Queue muss fehlschlagen");
+				Assert::IsFalse(producer.Push(9, 10), L"Push() muss nach Ablauf der Wartezeit zurueckkehren");
+
+				Assert::AreEqual<int64_t>(1, consumer.TryPop().value_or(0), L"FIFO-Reihenfolge verletzt");
+				Assert::IsTrue(producer.Push(9, 10), L"Push(): unerwartet fehlgeschlagen");
+			}
+			{
+				// erneut verbinden (z.B. nach Neustart eines Prozesses), Inhalt bleibt erhalten
+				SharedMemoryQueue<int64_t> consumer;
+				Assert::IsTrue(consumer.Open(path), L"erneutes Open() muss erfolgreich sein");
+				Assert::AreEqual<size_t>(8, consumer.Size(), L"Inhalt muss nach erneutem Open() erhalten bleiben");
+				consumer.Close();
+				Assert::IsFalse(consumer.TryPush(0), L"TryPush() in geschlossene Queue muss fehlschlagen");
+				for(int64_t i = 2; i <= 9; i++)
+				{
+					Assert::AreEqual<int64_t>(i, consumer.Pop().value_or(0), L"FIFO-Reihenfolge verletzt");
+				}
+				Assert::IsFalse(consumer.Pop().has_value(), L"Pop() einer leeren geschlossenen Queue muss sofort zurueckkehren");
+			}
+			std::filesystem::remove(path);
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(ThreadSafty)
+		{
+			constexpr size_t	NUM_PRODUCERS	= 4;
+			constexpr size_t	NUM_CONSUMERS	= 4;
+			constexpr int64_t	NUM_PUSHES		= 20000;
+			const auto			path			= SharedMemoryQueue<int64_t>::DefaultPath("UnitTest_SharedMemoryQueue.ThreadSafty");
+
+			SharedMemoryQueue<int64_t> owner;
+			Assert::IsTrue(owner.Create(path, 64), L"Create() muss erfolgreich sein");
+
+			// jeder Thread verwendet eine eigene Einblendung wie ein eigener Prozess
+			std::vector<std::thread>	threads;
+			std::vector<int64_t>		sums(NUM_CONSUMERS, 0);
+			for(size_t i = 0; i < NUM_CONSUMERS; i++)
+			{
+				threads.emplace_back([&path, &sum = sums[i]]()
+					{
+						SharedMemoryQueue<int64_t> consumer;
+						if(consumer.Open(path))
+						{
+							while(std::optional<int64_t> value = consumer.Pop())
+							{
+								sum += value.value();
+							}
+						}
+					});
+			}
+			std::vector<std::thread> producers;
+			for(size_t i = 0; i < NUM_PRODUCERS; i++)
+			{
+				producers.emplace_back([&path]()
+					{
+						SharedMemoryQueue<int64_t> producer;
+						if(producer.Open(path))
+						{
+							for(int64_t value = 1; value <= NUM_PUSHES; value++)
+							{
+								(void)producer.Push(value);
+							}
+						}
+					});
+			}
+			for(auto& producer : producers)
+			{
+				producer.join();
+			}
+			owner.Close();
+			for(auto& thread : threads)
+			{
+				thread.join();
+			}
+
+			const int64_t sumTotal = std::accumulate(sums.begin(), sums.end(), int64_t(0));
+			Assert::AreEqual<int64_t>(NUM_PRODUCERS*NUM_PUSHES*(NUM_PUSHES + 1)/2, sumTotal, L"Elemente verloren oder doppelt entnommen");
+			Assert::IsTrue(owner.IsEmpty(), L"Queue muss leer sein");
+			std::filesystem::remove(path);
+		}
+		///----------------------------------------------------------------------------------------------
+	};
+}
@@ -0,0 +1,102 @@
+#include "pch.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "CppUnitTest.h"
+#include "ProfileZone.h"
+#include "SimpleTimer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std::chrono_literals;
+using namespace std::chrono;
+
+namespace tiel::timer
+{
+	TEST_CLASS(Test_SimpleTimer)
+	{
+	public:
+
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_TscClock)
+		{
+			// TscTimer fordert die Kalibrierung beim Programmstart an, weitere Aufrufe kehren sofort zurück
+			const double nsPerTick = TscClock::NanosecondsPerTick();
+			TscClock::Calibrate();
+			Assert::AreEqual(nsPerTick, TscClock::NanosecondsPerTick(), L"Kalibrierung muss beim Programmstart erfolgt sein");
+
+			// TscClock hat dieselbe Epoche wie steady_clock, auch ohne invarianten TSC
+			const auto tscNow		= TscClock::now();
+			const auto steadyNow	= steady_clock::now();
+			Assert::IsTrue(abs(tscNow.time_since_epoch() - duration_cast<nanoseconds>(steadyNow.time_since_epoch())) < 10ms,
+						   L"TscClock muss mit steady_clock uebereinstimmen");
+			Assert::IsTrue(!TscClock::IsTscUsed() || (TscClock::NanosecondsPerTick() > 0.0), L"Kalibrierung erwartet");
+
+			auto previous = TscClock::now();
+			for(int i = 0; i < 100000; i++)
+			{
+				const auto current = TscClock::now();
+				Assert::IsTrue(current >= previous, L"TscClock muss monoton sein");
+				previous = current;
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_TscTimer)
+		{
+			TscTimer tmr;
+			std::this_thread::sleep_for(20ms);
+			const int64_t elapsedNs = tmr.llStopNs();
+			Assert::IsTrue(elapsedNs >= 19'000'000 && elapsedNs < 2'000'000'000, L"gemessene Zeit ausserhalb des Bereichs");
+			Assert::AreEqual<int64_t>(elapsedNs, tmr.llGetMeasuredTimeNs(), L"gestoppte Zeit muss erhalten bleiben");
+			Assert::AreEqual<uint64_t>(elapsedNs/1000, tmr.llGetMeasuredTimeUs(), L"Us und Ns muessen uebereinstimmen");
+			Assert::IsTrue(tmr.llElapseNs() >= elapsedNs, L"abgelaufene Zeit muss weiterlaufen");
+
+			SimpleTimer steadyTmr;
+			steadyTmr.Start();
+			Assert::IsTrue(steadyTmr.llStopNs() >= 0, L"steady_clock-Timer muss Ns liefern");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(Test_ProfileZone)
+		{
+			TraceCollector& collector = TraceCollector::Instance();
+			{
+				// ohne laufenden Flusher wird nichts aufgezeichnet, ohne TIEL_PROFILE_ZONES entfällt das Makro
+				ProfileZone zone("nicht aufgezeichnet");
+				TIEL_PROFILE_ZONE("entfaellt");
+			}
+			const std::filesystem::path path = std::filesystem::temp_directory_path()/"tiel_profile_zone_test.json";
+			const size_t numWrittenBefore = collector.NumWrittenEvents();
+			Assert::IsTrue(collector.Start(path, 5ms), L"Flusher muss starten");
+			Assert::IsFalse(collector.Start(path), L"Flusher darf nur einmal laufen");
+
+			constexpr int NumZones = 1000;
+			auto recordZones = [](const char* name)
+			{
+				for(int i = 0; i < NumZones; i++)
+				{
+					ProfileZone zone(name);
+				}
+			};
+			std::thread worker(recordZones, "worker \"zone\"");
+			{
+				ProfileZone outer("outer");
+				recordZones("inner");
+			}
+			worker.join();
+			collector.Stop();
+			Assert::IsFalse(collector.IsRunning(), L"Flusher muss beendet sein");
+			Assert::AreEqual<size_t>(2*NumZones + 1, collector.NumWrittenEvents() - numWrittenBefore + collector.NumDroppedEvents(),
+									 L"alle Zonen muessen geschrieben oder verworfen sein");
+
+			std::stringstream content;
+			content << std::ifstream(path).rdbuf();
+			const std::string json = content.str();
+			std::filesystem::remove(path);
+			Assert::IsTrue(json.starts_with("[") && json.ends_with("]\n"), L"JSON-Array erwartet");
+			Assert::IsTrue(json.find("\"name\":\"outer\",\"cat\":\"zone\",\"ph\":\"X\"") != std::string::npos, L"Zone fehlt");
+			Assert::IsTrue(json.find("\"name\":\"worker \\\"zone\\\"\"") != std::string::npos, L"Name muss maskiert sein");
+			Assert::IsTrue(json.find("nicht aufgezeichnet") == std::string::npos, L"Zone vor Start darf nicht erscheinen");
+		}
+	};
+}
@@ -0,0 +1,105 @@
+#include "pch.h"
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "CppUnitTest.h"
+#include "StaticCallbackHandler.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace tiel::concurrent
+{
+	namespace
+	{
+		std::atomic_int sStaticSum = 0;
+
+		void AddToStaticSum(int i)
+		{
+			sStaticSum += i;
+		}
+		void AddTwiceToStaticSum(int i)
+		{
+			sStaticSum += 2*i;
+		}
+
+		// statisch initialisiert, ohne Heap und ohne dynamische Initialisierung
+		constinit StaticCallbackHandler<4, int> sConstHandler(&AddToStaticSum, &AddTwiceToStaticSum);
+	}
+
+	///_______________________________________________________________________________________________
+	TEST_CLASS(Test_StaticCallbackHandler)
+	{
+	public:
+		///-------------------------------------------------------------------------------------------
+		TEST_METHOD(TestInterface)
+		{
+			Assert::IsTrue(sConstHandler.IsFrozen(), L"mit Funktionszeigern konstruierter Handler muss eingefroren sein");
+			Assert::AreEqual<size_t>(2, sConstHandler.Size(), L"zwei Callbacks erwartet");
+			sConstHandler.CallAll(1);
+			Assert::AreEqual(3, sStaticSum.load(), L"unerwartete Summe");
+
+			StaticCallbackHandler<3, int, const std::string&>	handler;
+			std::vector<int>									calls;
+
+			Assert::IsFalse(handler.AddCallback(nullptr), L"nullptr darf nicht angemeldet werden");
+			Assert::IsTrue(handler.AddCallback([&calls](int i, const std::string&) { calls.push_back(i); }), L"AddCallback() muss erfolgreich sein");
+			Assert::IsTrue(handler.AddCallback([](int, const std::string&) {}), L"AddCallback() muss erfolgreich sein");
+			Assert::IsTrue(handler.AddCallback([&calls](int i, const std::string& s)
+				{
+					if(s.empty())
+					{
+						throw std::runtime_error("Test");
+					}
+					calls.push_back(10*i);
+				}), L"AddCallback() muss erfolgreich sein");
+			Assert::IsFalse(handler.AddCallback([](int, const std::string&) {}), L"Handler ist voll");
+			Assert::AreEqual<size_t>(3, handler.Size(), L"drei Callbacks erwartet");
+
+			handler.CallAll(1, "TestStatic");
+			Assert::IsTrue(calls == std::vector<int>{ 1, 10 }, L"Callbacks muessen in Anmeldereihenfolge aufgerufen werden");
+			Assert::IsFalse(handler.CallAllNoExcept(2, ""), L"Exception muss gemeldet werden");
+			Assert::IsTrue(calls == std::vector<int>{ 1, 10, 2 }, L"nachfolgende Callbacks muessen aufgerufen werden");
+
+			StaticCallbackHandler<2, int> frozenHandler;
+			frozenHandler.Freeze();
+			Assert::IsFalse(frozenHandler.AddCallback(&AddToStaticSum), L"nach Freeze() ist keine Anmeldung moeglich");
+		}
+		///-------------------------------------------------------------------------------------------
+		TEST_METHOD(ThreadSafty)
+		{
+			constexpr int NUM_CALLERS	= 4;
+			constexpr int NUM_CALLS		= 20000;
+
+			StaticCallbackHandler<8, int>	handler;
+			std::atomic_int64_t				sum = 0;
+
+			// Aufrufer laufen bereits waehrend der Anmeldephase
+			std::vector<std::future<void>> callers;
+			for(int i = 0; i < NUM_CALLERS; i++)
+			{
+				callers.push_back(std::async(std::launch::async, [&handler]()
+					{
+						for(int value = 1; value <= NUM_CALLS; value++)
+						{
+							handler.CallAll(value);
+						}
+					}));
+			}
+			for(int i = 0; i < 8; i++)
+			{
+				Assert::IsTrue(handler.AddCallback([&sum](int value) { sum += value; }), L"AddCallback() muss erfolgreich sein");
+			}
+			handler.Freeze();
+			for(auto& caller : callers)
+			{
+				caller.wait();
+			}
+			const int64_t sumAfterFreeze = sum;
+			handler.CallAll(1);
+			Assert::AreEqual<int64_t>(sumAfterFreeze + 8, sum, L"alle Callbacks muessen aufgerufen werden");
+		}
+		///-------------------------------------------------------------------------------------------
+	};
+}
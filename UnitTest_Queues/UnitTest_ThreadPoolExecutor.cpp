@@ -0,0 +1,167 @@
+#include "pch.h"
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <vector>
+#include <thread>
+#include <stdexcept>
+#include "CppUnitTest.h"
+#include "ThreadPoolExecutor.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace tiel::concurrent
+{
+	///_______________________________________________________________________________________________
+	TEST_CLASS(Test_ThreadPoolExecutor)
+	{
+		///-------------------------------------------------------------------------------------------
+		/// rekursive Fibonacci-Berechnung mit verschachteltem Submit()/Get()
+		static int64_t Fibonacci(ThreadPoolExecutor& executor, int64_t n)
+		{
+			if(n < 2)
+			{
+				return n;
+			}
+			auto future = executor.Submit([&executor, n]() { return Fibonacci(executor, n - 1); });
+			const int64_t value = Fibonacci(executor, n - 2);
+			return value + future.Get();
+		}
+
+	public:
+		///-------------------------------------------------------------------------------------------
+		TEST_METHOD(TestInterface)
+		{
+			ThreadPoolExecutor executor(4);
+			Assert::AreEqual<size_t>(4, executor.NumWorkers(), L"unerwartete Anzahl Worker");
+			Assert::IsFalse(executor.IsWorkerThread(), L"Testthread ist kein Worker");
+
+			TaskFuture<int> invalid;
+			Assert::IsFalse(invalid.IsValid(), L"Standard-TaskFuture muss ungueltig sein");
+
+			auto futureValue	= executor.Submit([]() { return 42; });
+			auto futureVoid		= executor.Submit([]() {});
+			auto futureWorker	= executor.Submit([&executor]() { return executor.IsWorkerThread(); });
+			auto futureThrow	= executor.Submit([]() -> int { throw std::runtime_error("Test"); });
+
+			Assert::AreEqual(42, futureValue.Get(), L"unerwarteter Rueckgabewert");
+			futureVoid.Wait();
+			Assert::IsTrue(futureVoid.IsReady(), L"Aufgabe muss abgeschlossen sein");
+			Assert::IsTrue(futureWorker.Get(), L"Aufgabe muss in einem Worker laufen");
+			bool isThrown = false;
+			try
+			{
+				(void)futureThrow.Get();
+			}
+			catch(const std::runtime_error&)
+			{
+				isThrown = true;
+			}
+			Assert::IsTrue(isThrown, L"Exception der Aufgabe muss von Get() geworfen werden");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(NestedSubmit)
+		{
+			// verschachteltes Warten in den Workern darf den Pool nicht verklemmen
+			ThreadPoolExecutor executor(2);
+			Assert::AreEqual<int64_t>(6765, Fibonacci(executor, 20), L"unerwartetes Ergebnis");
+		}
+		///-------------------------------------------------------------------------------------------
+		TEST_METHOD(NestedWaitForStolenTask)
+		{
+			// die erwartete Aufgabe läuft in einem anderen Worker: der wartende Worker findet keine
+			// Aufgaben mehr, blockiert und muss beim Abschluss geweckt werden
+			ThreadPoolExecutor	executor(2);
+			std::atomic_bool	isInnerStarted = false;
+			auto outer = executor.Submit([&executor, &isInnerStarted]()
+				{
+					auto inner = executor.Submit([&isInnerStarted]()
+						{
+							isInnerStarted.store(true);
+							std::this_thread::sleep_for(std::chrono::milliseconds(50));
+							return 42;
+						});
+					while(!isInnerStarted.load() && !inner.IsReady())
+					{
+						std::this_thread::yield();
+					}
+					return inner.Get();
+				});
+			Assert::AreEqual(42, outer.Get(), L"unerwartetes Ergebnis");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(ParallelFor)
+		{
+			constexpr size_t NUM_INDICES = 100000;
+
+			ThreadPoolExecutor		executor(4);
+			std::vector<int64_t>	values(NUM_INDICES, 0);
+
+			executor.ParallelFor(0, NUM_INDICES, [&values](size_t i) { values[i] += static_cast<int64_t>(i) + 1; });
+			Assert::AreEqual<int64_t>(NUM_INDICES*(NUM_INDICES + 1)/2, std::accumulate(values.begin(), values.end(), int64_t(0)),
+									  L"jeder Index muss genau einmal bearbeitet werden");
+
+			// verschachtelt aus Aufgaben heraus
+			std::atomic_size_t count = 0;
+			auto future = executor.Submit([&executor, &count]()
+				{
+					executor.ParallelFor(0, 100, [&executor, &count](size_t)
+						{
+							executor.ParallelFor(0, 100, [&count](size_t) { ++count; }, 7);
+						});
+				});
+			future.Get();
+			Assert::AreEqual<size_t>(100*100, count, L"verschachteltes ParallelFor unvollstaendig");
+
+			bool isThrown = false;
+			try
+			{
+				executor.ParallelFor(0, NUM_INDICES, [](size_t i)
+					{
+						if(i == NUM_INDICES/2)
+						{
+							throw std::runtime_error("Test");
+						}
+					});
+			}
+			catch(const std::runtime_error&)
+			{
+				isThrown = true;
+			}
+			Assert::IsTrue(isThrown, L"Exception muss von ParallelFor() geworfen werden");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(ThreadSafty)
+		{
+			constexpr size_t	NUM_PRODUCERS	= 4;
+			constexpr int64_t	NUM_TASKS		= 20000;
+
+			std::atomic_int64_t sum = 0;
+			{
+				ThreadPoolExecutor			executor(3);
+				std::vector<std::thread>	producers;
+				for(size_t i = 0; i < NUM_PRODUCERS; i++)
+				{
+					producers.emplace_back([&executor, &sum]()
+						{
+							for(int64_t value = 1; value <= NUM_TASKS; value++)
+							{
+								(void)executor.Submit([&sum, value]() { sum += value; });
+								if((value % 1000) == 0)
+								{
+									// Worker zwischendurch schlafen lassen
+									std::this_thread::sleep_for(std::chrono::milliseconds(1));
+								}
+							}
+						});
+				}
+				for(auto& producer : producers)
+				{
+					producer.join();
+				}
+			} // Destruktor arbeitet alle ausstehenden Aufgaben ab
+			Assert::AreEqual<int64_t>(NUM_PRODUCERS*NUM_TASKS*(NUM_TASKS + 1)/2, sum, L"Aufgaben verloren oder doppelt ausgefuehrt");
+		}
+		///----------------------------------------------------------------------------------------------
+	};
+}
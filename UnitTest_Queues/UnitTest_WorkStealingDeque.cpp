@@ -0,0 +1,144 @@
+#include "pch.h"
+#include <atomic>
+#include <numeric>
+#include <vector>
+#include <thread>
+#include "CppUnitTest.h"
+#include "WorkStealingDeque.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace tiel::concurrent::container
+{
+	///_______________________________________________________________________________________________
+	TEST_CLASS(Test_WorkStealingDeque)
+	{
+	public:
+		///-------------------------------------------------------------------------------------------
+		TEST_METHOD(TestInterface)
+		{
+			constexpr int64_t NUM_PUSHES = 100;
+
+			WorkStealingDeque<int64_t> deque(4);
+			Assert::AreEqual<size_t>(4, deque.Capacity(), L"unerwartete Anfangskapazitaet");
+			Assert::IsFalse(deque.Pop().has_value(), L"Deque muss leer sein");
+			Assert::IsFalse(deque.Steal().has_value(), L"Deque muss leer sein");
+
+			for(int64_t i = 1; i <= NUM_PUSHES; i++)
+			{
+				deque.Push(i);
+			}
+			Assert::AreEqual<size_t>(NUM_PUSHES, deque.Size(), L"unerwartete Anzahl Elemente");
+			Assert::IsTrue(deque.Capacity() >= NUM_PUSHES, L"Deque muss gewachsen sein");
+
+			// Besitzer LIFO am unteren, Dieb FIFO am oberen Ende
+			Assert::AreEqual<int64_t>(NUM_PUSHES, deque.Pop().value_or(0), L"Pop() muss LIFO entnehmen");
+			Assert::AreEqual<int64_t>(1, deque.Steal().value_or(0), L"Steal() muss FIFO entnehmen");
+			for(int64_t i = 2; i < NUM_PUSHES; i++)
+			{
+				Assert::AreEqual<int64_t>(i, deque.Steal().value_or(0), L"Steal() muss FIFO entnehmen");
+			}
+			Assert::IsTrue(deque.IsEmpty(), L"Deque muss leer sein");
+			Assert::IsFalse(deque.Pop().has_value(), L"Deque muss leer sein");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(ThreadSafty)
+		{
+			constexpr size_t	NUM_THIEVES		= 4;
+			constexpr int64_t	NUM_PUSHES		= 200000;
+
+			WorkStealingDeque<int64_t>	deque(16);
+			std::atomic_bool			isDone		= false;
+			std::vector<int64_t>		sums(NUM_THIEVES + 1, 0);
+			std::vector<int64_t>		counts(NUM_THIEVES + 1, 0);
+			std::vector<std::thread>	thieves;
+
+			for(size_t i = 0; i < NUM_THIEVES; i++)
+			{
+				thieves.emplace_back([&deque, &isDone, &sum = sums[i], &count = counts[i]]()
+					{
+						while(!isDone || !deque.IsEmpty())
+						{
+							if(std::optional<int64_t> value = deque.Steal())
+							{
+								sum += value.value();
+								++count;
+							}
+						}
+					});
+			}
+			// Besitzer: wachsen lassen, zwischendurch selbst entnehmen
+			for(int64_t i = 1; i <= NUM_PUSHES; i++)
+			{
+				deque.Push(i);
+				if((i % 3) == 0)
+				{
+					if(std::optional<int64_t> value = deque.Pop())
+					{
+						sums[NUM_THIEVES] += value.value();
+						++counts[NUM_THIEVES];
+					}
+				}
+			}
+			while(std::optional<int64_t> value = deque.Pop())
+			{
+				sums[NUM_THIEVES] += value.value();
+				++counts[NUM_THIEVES];
+			}
+			isDone = true;
+			for(auto& thief : thieves)
+			{
+				thief.join();
+			}
+
+			Assert::AreEqual<int64_t>(NUM_PUSHES, std::accumulate(counts.begin(), counts.end(), int64_t(0)), L"Elemente verloren oder doppelt entnommen");
+			Assert::AreEqual<int64_t>(NUM_PUSHES*(NUM_PUSHES + 1)/2, std::accumulate(sums.begin(), sums.end(), int64_t(0)), L"Elemente verloren oder doppelt entnommen");
+		}
+		///----------------------------------------------------------------------------------------------
+		TEST_METHOD(ReclaimUnderLoad)
+		{
+			constexpr size_t	NUM_THIEVES		= 4;
+			constexpr int64_t	MAX_PUSHES		= 10000000;
+
+			WorkStealingDeque<int64_t>	deque(16);
+			std::atomic_bool			isDone		= false;
+			std::vector<std::thread>	thieves;
+
+			for(size_t i = 0; i < NUM_THIEVES; i++)
+			{
+				thieves.emplace_back([&deque, &isDone]()
+					{
+						while(!isDone)
+						{
+							(void)deque.Steal();
+						}
+					});
+			}
+			// Besitzer: waehrend die Diebe ununterbrochen stehlen mehrfach wachsen lassen ...
+			int64_t numPushes = 0;
+			while((deque.Capacity() < 1024) && (numPushes < MAX_PUSHES))
+			{
+				deque.Push(numPushes++);
+			}
+			const size_t capacity = deque.Capacity();
+			// ... die abgeloesten Puffer muessen freigegeben werden, obwohl die Diebe weiter stehlen
+			while((deque.NumRetiredArrays() != 0) && (numPushes < MAX_PUSHES))
+			{
+				deque.Push(numPushes++);
+				if((numPushes % 64) == 0)
+				{
+					std::this_thread::yield();
+				}
+			}
+			const size_t numRetiredArrays = deque.NumRetiredArrays();
+			isDone = true;
+			for(auto& thief : thieves)
+			{
+				thief.join();
+			}
+			Assert::IsTrue(capacity >= 1024, L"Deque muss gewachsen sein");
+			Assert::AreEqual<size_t>(0, numRetiredArrays, L"abgeloeste Puffer wurden unter Last nicht freigegeben");
+		}
+		///----------------------------------------------------------------------------------------------
+	};
+}
@@ -0,0 +1,801 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include "CallbackTask.h"
+#include "CompletionSlot.h"
+#include "ConcurrentQueue.h"
+#include "EventLoop.h"
+#include "ThreadPoolExecutor.h"
+
+namespace tiel::concurrent
+{
+	namespace detail
+	{
+		template <class Target>
+		class AsyncCall;
+	}
+
+	//________________________________________________________________________________________________
+	/// @brief	Gibt den gemeinsamen Executor zurück, über den CallbackHandler::CallAllAsync() die
+	///			Callbacks aufruft, sofern dem CallbackHandler kein eigener Executor übergeben wurde.
+	/// @remark	Da Callbacks blockieren dürfen (I/O, Warten), hat dieser Pool unabhängig von der Anzahl
+	///			der Hardware-Threads mindestens 8 Worker.
+	inline ThreadPoolExecutor& CallbackDispatchExecutor()
+	{
+		static ThreadPoolExecutor sDispatchExecutor((std::max)(8u, std::thread::hardware_concurrency()));
+		return sDispatchExecutor;
+	}
+
+	//________________________________________________________________________________________________
+	/// @brief	Verfolgt den Abschluss aller Aufrufe einer CallAllAsyncTracked()-Runde.
+	/// @remark	Die Aufrufe zählen einen atomaren Zähler herunter. Wartende Threads werden höchstens
+	///			zweimal je Runde geweckt: beim ersten abgeschlossenen Aufruf (WaitAny()) und beim letzten
+	///			(WaitAll(), Completion-Callback). Die Sperre des CallbackHandlers wird dabei nicht gehalten.
+	class AsyncCompletion final
+	{
+		template <class StoragePolicy, class ... Args>
+		friend class BasicCallbackHandler;
+		template <class Target>
+		friend class detail::AsyncCall;
+
+	public:
+		AsyncCompletion() = default;
+		AsyncCompletion(const AsyncCompletion&) = delete;
+		AsyncCompletion& operator=(const AsyncCompletion&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob alle Aufrufe der Runde abgeschlossen sind.
+		[[nodiscard]] bool IsComplete() const
+		{
+			return mNumOutstanding.load(std::memory_order_acquire) == 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der in dieser Runde gestarteten bzw. eingereihten Aufrufe zurück.
+		///			Callbacks, deren vorheriger asynchroner Aufruf noch lief, wurden je nach
+		///			AsyncOverrunPolicy ggf. übersprungen und zählen dann nicht mit.
+		[[nodiscard]] size_t NumStarted() const
+		{
+			return mNumStarted.load(std::memory_order_acquire);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der bereits abgeschlossenen Aufrufe zurück.
+		[[nodiscard]] size_t NumFinished() const
+		{
+			return mNumFinished.load(std::memory_order_acquire);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der Aufrufe zurück, in denen der Callback eine Exception geworfen hat.
+		[[nodiscard]] size_t NumFailed() const
+		{
+			return mNumFailed.load(std::memory_order_acquire);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet, bis alle Aufrufe der Runde abgeschlossen sind.
+		void WaitAll() const
+		{
+			std::unique_lock lock(mMutex);
+			mCondition.wait(lock, [this]() { return mIsComplete; });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet bis spätestens "deadline", bis alle Aufrufe der Runde abgeschlossen sind.
+		/// @return			true, wenn alle Aufrufe abgeschlossen sind
+		template <class Clock, class Duration>
+		bool WaitAll(const std::chrono::time_point<Clock, Duration>& deadline) const
+		{
+			std::unique_lock lock(mMutex);
+			return mCondition.wait_until(lock, deadline, [this]() { return mIsComplete; });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet, bis mindestens ein Aufruf der Runde abgeschlossen ist (oder die Runde leer ist).
+		void WaitAny() const
+		{
+			std::unique_lock lock(mMutex);
+			mCondition.wait(lock, [this]() { return IsAnyFinished(); });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet bis spätestens "deadline", bis mindestens ein Aufruf der Runde abgeschlossen
+		///			ist (oder die Runde leer ist).
+		/// @return			true, wenn mindestens ein Aufruf abgeschlossen bzw. die Runde leer ist
+		template <class Clock, class Duration>
+		bool WaitAny(const std::chrono::time_point<Clock, Duration>& deadline) const
+		{
+			std::unique_lock lock(mMutex);
+			return mCondition.wait_until(lock, deadline, [this]() { return IsAnyFinished(); });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt die Funktion fest, die nach dem Abschluss aller Aufrufe einmalig aufgerufen wird.
+		/// @remark	Die Funktion läuft im Thread des zuletzt abgeschlossenen Aufrufs. Ist die Runde bereits
+		///			abgeschlossen, wird sie sofort im aufrufenden Thread aufgerufen.
+		/// @param onComplete	aufzurufende Funktion
+		void OnComplete(std::function<void()> onComplete)
+		{
+			{
+				std::lock_guard lock(mMutex);
+				if(!mIsComplete)
+				{
+					mOnComplete = std::move(onComplete);
+					return;
+				}
+			}
+			onComplete();
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Meldet einen gestarteten Aufruf an
+		void AddCall()
+		{
+			mNumStarted.fetch_add(1, std::memory_order_relaxed);
+			mNumOutstanding.fetch_add(1, std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Meldet den Abschluss eines Aufrufs
+		void FinishCall(bool isFailed)
+		{
+			if(isFailed)
+			{
+				mNumFailed.fetch_add(1, std::memory_order_relaxed);
+			}
+			const bool isFirst = (mNumFinished.fetch_add(1, std::memory_order_acq_rel) == 0);
+			Release(isFirst);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt die Referenz der startenden Runde frei, nachdem alle Aufrufe gestartet wurden
+		void Seal()
+		{
+			Release(false);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Verringert den Zähler und weckt die Wartenden beim ersten bzw. letzten Abschluss
+		void Release(bool isFirstFinished)
+		{
+			if(mNumOutstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::function<void()> onComplete;
+				{
+					std::lock_guard lock(mMutex);
+					mIsComplete	= true;
+					onComplete	= std::move(mOnComplete);
+					mCondition.notify_all();
+				}
+				if(onComplete)
+				{
+					onComplete();
+				}
+			}
+			else if(isFirstFinished)
+			{
+				std::lock_guard lock(mMutex);
+				mCondition.notify_all();
+			}
+		}
+		bool IsAnyFinished() const
+		{
+			return mIsComplete || (mNumFinished.load(std::memory_order_acquire) != 0);
+		}
+
+		std::atomic_size_t				mNumOutstanding	= 1;	// +1, bis alle Aufrufe der Runde gestartet sind
+		std::atomic_size_t				mNumStarted		= 0;
+		std::atomic_size_t				mNumFinished	= 0;
+		std::atomic_size_t				mNumFailed		= 0;
+		mutable std::mutex				mMutex;
+		mutable std::condition_variable	mCondition;
+		bool							mIsComplete		= false;
+		std::function<void()>			mOnComplete;
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Verhalten eines Callback-Postfachs (siehe BasicCallbackHandler::CallAllQueued()), wenn es
+	///			voll ist
+	enum class MailboxOverflowPolicy
+	{
+		Block,			// der Aufrufer wartet, bis im Postfach wieder Platz ist
+		DropOldest,		// das älteste noch nicht zugestellte Ereignis wird verworfen
+		DropNewest,		// das neue Ereignis wird verworfen
+		Coalesce		// das Postfach hält nur das neueste Ereignis, ältere werden durch dieses ersetzt
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Einstellungen des Postfachs eines Callbacks
+	struct MailboxOptions
+	{
+		size_t					capacity		= 1024;	// max. Anzahl nicht zugestellter Ereignisse
+		MailboxOverflowPolicy	overflowPolicy	= MailboxOverflowPolicy::Block;
+
+		bool operator==(const MailboxOptions&) const = default;
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Verhalten von BasicCallbackHandler::CallAllAsync(), wenn der vorherige asynchrone Aufruf
+	///			eines Callbacks noch nicht zurückgekehrt ist
+	enum class AsyncOverrunPolicy
+	{
+		Skip,			// das Ereignis wird für diesen Callback verworfen
+		Coalesce,		// nach dem laufenden Aufruf wird der Callback einmal mit dem neuesten Ereignis aufgerufen
+		Queue,			// bis zu maxPending Ereignisse werden eingereiht, weitere werden verworfen
+		RateLimit		// wie Skip, zusätzlich höchstens ein Aufruf je minInterval
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Einstellungen für CallAllAsync() eines CallbackHandlers
+	struct AsyncOverrunOptions
+	{
+		AsyncOverrunPolicy			policy		= AsyncOverrunPolicy::Skip;
+		size_t						maxPending	= 1;	// nur AsyncOverrunPolicy::Queue
+		std::chrono::nanoseconds	minInterval	{};		// nur AsyncOverrunPolicy::RateLimit
+	};
+
+	namespace detail
+	{
+		// Die folgenden Bausteine stellen Ereignisse an ein Aufrufziel ("Target") zu, z.B. an einen Slot
+		// eines BasicCallbackHandlers oder an einen Abonnenten eines EventBus. Ein Target bietet:
+		//	using ArgumentTuple;								Argumente eines Ereignisses
+		//	void Invoke(const ArgumentTuple&) const;			ruft den gewöhnlichen Callback auf
+		//	bool IsTask() const;								true für Coroutine-Callbacks
+		//	CallbackTask InvokeTask(const ArgumentTuple&) const;	startet den Coroutine-Callback
+		//	EventLoop* Loop() const;							gebundene Schleife bzw. nullptr
+		// Das Target muss den Baustein überleben. Während ein Aufruf aussteht, hält der Baustein den
+		// übergebenen "keepAlive"-Anteil (z.B. den Schnappschuss der Callback-Liste), der das Target und
+		// damit den Baustein selbst am Leben hält.
+
+		///_________________________________________________________________________________________________
+		/// Wiederverwendbarer asynchroner Aufruf eines Targets. Das Objekt wird bei jedem CallAllAsync()
+		/// ohne Allokation erneut in den Executor eingestellt (ersetzt std::async() und std::future je
+		/// Aufruf). Gemäß AsyncOverrunPolicy eingereihte Ereignisse werden im Anschluss an den laufenden
+		/// Aufruf ohne Warten des Aufrufers zugestellt. Ein als Coroutine angemeldeter Callback wird nur
+		/// gestartet, der Aufruf gilt erst mit dem Ende der Coroutine als abgeschlossen; der Worker wird
+		/// dabei nicht blockiert.
+		/// Das Ergebnis liegt in einem eingebetteten CompletionSlot, Abfragen und Warten benötigen keine
+		/// Sperre.
+		template <class Target>
+		class AsyncCall final : public ExecutorTask
+		{
+		public:
+			using SharedArguments = std::shared_ptr<const typename Target::ArgumentTuple>;
+
+			enum class StartResult
+			{
+				Started,		// Aufruf eingestellt
+				Queued,			// Ereignis eingereiht
+				Coalesced,		// Ereignis ersetzt ein noch nicht zugestelltes Ereignis
+				Dropped			// Ereignis verworfen
+			};
+
+			explicit AsyncCall(const Target& target)
+				: mTarget(target)
+			{}
+			///------------------------------------------------------------------------------------------
+			/// Stellt den Aufruf in den Executor ein, sofern der vorherige Aufruf abgeschlossen ist,
+			/// andernfalls wird gemäß "options" verfahren
+			StartResult TryStart(ThreadPoolExecutor& executor, std::shared_ptr<const void> keepAlive,
+								 const AsyncOverrunOptions& options, const SharedArguments& pArgs,
+								 const std::shared_ptr<AsyncCompletion>& pCompletion = nullptr)
+			{
+				std::shared_ptr<AsyncCompletion>	pSuperseded;
+				StartResult							result	= StartResult::Started;
+				{
+					std::lock_guard lock(mMutex);
+					if(mResult.IsPending())
+					{
+						switch(options.policy)
+						{
+						case AsyncOverrunPolicy::Coalesce:
+							if(!mQueuedCalls.empty())
+							{
+								pSuperseded = std::exchange(mQueuedCalls.back().pCompletion, pCompletion);
+								mQueuedCalls.back().pArgs = pArgs;
+								result = StartResult::Coalesced;
+								break;
+							}
+							[[fallthrough]];
+						case AsyncOverrunPolicy::Queue:
+							if(mQueuedCalls.size() >= (std::max)(size_t(1), options.maxPending))
+							{
+								return StartResult::Dropped;
+							}
+							mQueuedCalls.push_back({ pArgs, pCompletion });
+							result = StartResult::Queued;
+							break;
+						default:
+							return StartResult::Dropped;
+						}
+						if(pCompletion != nullptr)
+						{
+							pCompletion->AddCall();
+						}
+					}
+					else
+					{
+						if(options.policy == AsyncOverrunPolicy::RateLimit)
+						{
+							const auto now = std::chrono::steady_clock::now();
+							if((mLastStart != std::chrono::steady_clock::time_point()) && (now - mLastStart < options.minInterval))
+							{
+								return StartResult::Dropped;
+							}
+							mLastStart = now;
+						}
+						if(pCompletion != nullptr)
+						{
+							pCompletion->AddCall();
+						}
+						mCompletion	= pCompletion;
+						mArgs		= pArgs;
+						mException	= nullptr;
+						mKeepAlive	= std::move(keepAlive);
+						mExecutor	= &executor;
+						(void)mResult.Start();
+					}
+				}
+				// ein ersetztes Ereignis gilt in seiner Runde als abgeschlossen
+				if(pSuperseded != nullptr)
+				{
+					pSuperseded->FinishCall(false);
+				}
+				if(result == StartResult::Started)
+				{
+					PostSelf();
+				}
+				return result;
+			}
+			///------------------------------------------------------------------------------------------
+			void Run() override
+			{
+				if(mTarget.IsTask())
+				{
+					RunTask(this);
+					return;
+				}
+				std::exception_ptr exception;
+				{
+					const RunningScope runningScope(this);
+					try
+					{
+						mTarget.Invoke(*mArgs);
+					}
+					catch(...)
+					{
+						exception = std::current_exception();
+					}
+				}
+				Finish(exception);
+			}
+			///------------------------------------------------------------------------------------------
+			/// true, wenn der Aufruf noch nicht zurückgekehrt ist
+			bool IsPending() const
+			{
+				return mResult.IsPending();
+			}
+			///------------------------------------------------------------------------------------------
+			/// true, wenn der aufrufende Thread gerade diesen Aufruf ausführt (d.h. aus dem Callback
+			/// heraus), ein Warten auf den Abschluss würde dann nie zurückkehren
+			bool IsRunningOnCurrentThread() const
+			{
+				for(const RunningScope* pScope = RunningScope::tpInnermost; pScope != nullptr; pScope = pScope->pOuter)
+				{
+					if(pScope->pCall == this)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+			///------------------------------------------------------------------------------------------
+			/// true, wenn ein Aufruf gestartet und dessen Ergebnis noch nicht mit Get() abgeholt wurde
+			/// (entspricht std::future::valid())
+			bool HasResult() const
+			{
+				return mResult.HasResult();
+			}
+			///------------------------------------------------------------------------------------------
+			/// Wartet auf den Abschluss des Aufrufs
+			void Wait() const
+			{
+				mResult.Wait();
+			}
+			///------------------------------------------------------------------------------------------
+			/// Wartet bis spätestens "deadline" auf den Abschluss des Aufrufs
+			template <class Clock, class Duration>
+			bool WaitUntil(const std::chrono::time_point<Clock, Duration>& deadline) const
+			{
+				return mResult.WaitUntil(deadline);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Wartet auf den Abschluss des Aufrufs und wirft ggf. die im Callback aufgetretene Exception
+			/// (entspricht std::future::get())
+			void Get()
+			{
+				mResult.Get();
+			}
+		private:
+			///------------------------------------------------------------------------------------------
+			/// Markiert den im aufrufenden Thread laufenden Aufruf. Verschachtelt, da ein Worker beim
+			/// Warten weitere Aufgaben ausführen kann.
+			struct RunningScope
+			{
+				static inline thread_local const RunningScope* tpInnermost = nullptr;
+
+				const AsyncCall*	pCall;
+				const RunningScope*	pOuter;
+
+				explicit RunningScope(const AsyncCall* pRunning)
+					: pCall(pRunning)
+					, pOuter(tpInnermost)
+				{
+					tpInnermost = this;
+				}
+				~RunningScope()
+				{
+					tpInnermost = pOuter;
+				}
+				RunningScope(const RunningScope&) = delete;
+				RunningScope& operator=(const RunningScope&) = delete;
+			};
+			///------------------------------------------------------------------------------------------
+			/// Eingereihtes Ereignis (AsyncOverrunPolicy::Coalesce bzw. Queue)
+			struct QueuedCall
+			{
+				SharedArguments						pArgs;
+				std::shared_ptr<AsyncCompletion>	pCompletion;
+			};
+			///------------------------------------------------------------------------------------------
+			/// Startet die Coroutine des Callbacks und schließt den Aufruf nach deren Ende ab
+			static DetachedCoroutine RunTask(AsyncCall* pCall)
+			{
+				std::exception_ptr exception;
+				try
+				{
+					co_await pCall->mTarget.InvokeTask(*pCall->mArgs);
+				}
+				catch(...)
+				{
+					exception = std::current_exception();
+				}
+				pCall->Finish(exception);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Schließt den Aufruf ab und stellt ggf. das nächste eingereihte Ereignis ein
+			void Finish(std::exception_ptr exception)
+			{
+				// der Anteil wird als letzte Aktion zerstört und gibt ggf. dieses Objekt frei
+				std::shared_ptr<const void>			keepAlive;
+				std::shared_ptr<AsyncCompletion>	pCompletion;
+				bool								isQueued = false;
+				{
+					std::lock_guard lock(mMutex);
+					pCompletion = std::move(mCompletion);
+					if(mException == nullptr)
+					{
+						mException = exception; // erste Exception seit dem Start
+					}
+					if(!mQueuedCalls.empty())
+					{
+						// nächstes eingereihtes Ereignis, der Aufruf bleibt ausstehend
+						QueuedCall& next = mQueuedCalls.front();
+						mArgs		= std::move(next.pArgs);
+						mCompletion	= std::move(next.pCompletion);
+						mQueuedCalls.pop_front();
+						isQueued = true;
+					}
+					else
+					{
+						keepAlive = std::move(mKeepAlive);
+						mArgs.reset();
+						mResult.Complete(std::exchange(mException, nullptr));
+					}
+				}
+				if(pCompletion != nullptr)
+				{
+					pCompletion->FinishCall(exception != nullptr);
+				}
+				if(isQueued)
+				{
+					PostSelf(); // danach nicht mehr auf dieses Objekt zugreifen
+				}
+			}
+			///------------------------------------------------------------------------------------------
+			/// Stellt den Aufruf in die EventLoop des Targets bzw. den Executor ein
+			void PostSelf()
+			{
+				if(EventLoop* const pLoop = mTarget.Loop())
+				{
+					(void)pLoop->Post(*this);
+				}
+				else
+				{
+					mExecutor->Post(*this);
+				}
+			}
+
+			const Target&							mTarget;
+			std::shared_ptr<const void>				mKeepAlive;		// nur während eines Aufrufs gesetzt
+			std::shared_ptr<AsyncCompletion>		mCompletion;	// nur während eines Aufrufs gesetzt
+			std::deque<QueuedCall>					mQueuedCalls;	// nur während eines Aufrufs belegt
+			std::chrono::steady_clock::time_point	mLastStart;		// nur AsyncOverrunPolicy::RateLimit
+			ThreadPoolExecutor*						mExecutor	= nullptr;
+			SharedArguments							mArgs;
+			std::exception_ptr						mException;		// erste Exception der laufenden Aufrufe
+			std::mutex								mMutex;			// serialisiert Start und Abschluss
+			CompletionSlot							mResult;
+		};
+
+		///_________________________________________________________________________________________________
+		/// Begrenztes Postfach eines Targets. Die Ereignisse werden von einer eigenen, bei Bedarf in den
+		/// Executor (bzw. die EventLoop des Targets) eingestellten Aufgabe der Reihe nach zugestellt; je
+		/// Postfach läuft höchstens eine Zustellung gleichzeitig. Bei einem als Coroutine angemeldeten
+		/// Callback wird die Zustellung erst nach dem Ende der Coroutine fortgesetzt, ohne den Worker zu
+		/// blockieren.
+		template <class Target>
+		class Mailbox final : public ExecutorTask
+		{
+			static constexpr size_t MaxEventsPerRun = 64; // danach wird die Zustellung neu eingestellt
+
+		public:
+			using SharedArguments = std::shared_ptr<const typename Target::ArgumentTuple>;
+
+			Mailbox(const MailboxOptions& options, const Target& target)
+				: mEvents((options.overflowPolicy == MailboxOverflowPolicy::Coalesce) ? 1 : (std::max)(size_t(1), options.capacity))
+				, mOverflowPolicy(options.overflowPolicy)
+				, mTarget(target)
+			{}
+			///------------------------------------------------------------------------------------------
+			/// Legt ein Ereignis gemäß der Überlauf-Policy ab und plant ggf. die Zustellung ein, die einen
+			/// Anteil an "keepAlive" übernimmt. Gibt die Anzahl der dabei verworfenen Ereignisse zurück.
+			template <class KeepAlive>
+			size_t Post(ThreadPoolExecutor& executor, const KeepAlive& keepAlive, const SharedArguments& pArgs)
+			{
+				SharedArguments	event		= pArgs;
+				size_t			numDropped	= 0;
+
+				switch(mOverflowPolicy)
+				{
+				case MailboxOverflowPolicy::Block:
+					while(!mEvents.TryPush(std::move(event)))
+					{
+						mNumBlockedProducers.fetch_add(1, std::memory_order_seq_cst);
+						const uint32_t numPopped = mNumPopped.load(std::memory_order_seq_cst);
+						Schedule(executor, keepAlive);
+						if(mEvents.IsFull())
+						{
+							mNumPopped.wait(numPopped, std::memory_order_acquire);
+						}
+						mNumBlockedProducers.fetch_sub(1, std::memory_order_relaxed);
+					}
+					break;
+				case MailboxOverflowPolicy::DropNewest:
+					if(!mEvents.TryPush(std::move(event)))
+					{
+						numDropped++;
+					}
+					break;
+				case MailboxOverflowPolicy::DropOldest:
+				case MailboxOverflowPolicy::Coalesce:
+					while(!mEvents.TryPush(std::move(event)))
+					{
+						if(mEvents.TryPop().has_value())
+						{
+							numDropped++;
+						}
+					}
+					break;
+				}
+				mNumDropped.fetch_add(numDropped, std::memory_order_relaxed);
+				Schedule(executor, keepAlive);
+				return numDropped;
+			}
+			///------------------------------------------------------------------------------------------
+			void Run() override
+			{
+				for(size_t i = 0; i < MaxEventsPerRun; i++)
+				{
+					std::optional<SharedArguments> optEvent = mEvents.TryPop();
+					if(!optEvent.has_value())
+					{
+						break;
+					}
+					mNumPopped.fetch_add(1, std::memory_order_seq_cst);
+					if(mNumBlockedProducers.load(std::memory_order_seq_cst) != 0)
+					{
+						mNumPopped.notify_all();
+					}
+					if(mTarget.IsTask())
+					{
+						RunTask(std::move(*optEvent)); // setzt die Zustellung nach dem Ende fort
+						return;
+					}
+					try
+					{
+						mTarget.Invoke(**optEvent);
+					}
+					catch(...)
+					{
+						mNumFailed.fetch_add(1, std::memory_order_relaxed);
+					}
+				}
+				if(!mEvents.IsEmpty())
+				{
+					PostSelf();
+					return;
+				}
+				// der Anteil wird als letzte Aktion zerstört und gibt ggf. dieses Objekt frei
+				std::shared_ptr<const void> keepAlive = std::move(mKeepAlive);
+				mIsScheduled.store(false, std::memory_order_seq_cst);
+				mNumDrained.fetch_add(1, std::memory_order_seq_cst);
+				if(mNumDrainWaiters.load(std::memory_order_seq_cst) != 0)
+				{
+					mNumDrained.notify_all();
+					std::lock_guard lock(mDrainMutex);
+					mDrainCondition.notify_all();
+				}
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(!mEvents.IsEmpty() && !mIsScheduled.exchange(true, std::memory_order_acq_rel))
+				{
+					// zwischenzeitlich abgelegtes Ereignis, dessen Aufrufer die Zustellung nicht einplanen konnte
+					mKeepAlive = std::move(keepAlive);
+					PostSelf();
+				}
+			}
+			///------------------------------------------------------------------------------------------
+			/// true, wenn keine Zustellung eingeplant ist oder läuft
+			bool IsIdle() const
+			{
+				return !mIsScheduled.load(std::memory_order_acquire);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Wartet, bis keine Zustellung mehr eingeplant ist oder läuft. Geweckt wird über den
+			/// Zähler der abgeschlossenen Zustellungen; ohne "pDeadline" über mNumDrained.wait().
+			/// @return			false, wenn der Zeitpunkt *pDeadline erreicht wurde.
+			bool WaitUntilIdle(const std::chrono::steady_clock::time_point* pDeadline) const
+			{
+				if(IsIdle())
+				{
+					return true;
+				}
+				bool isIdle = false;
+				mNumDrainWaiters.fetch_add(1, std::memory_order_seq_cst);
+				if(pDeadline == nullptr)
+				{
+					for(;;)
+					{
+						const uint32_t numDrained = mNumDrained.load(std::memory_order_seq_cst);
+						if(!mIsScheduled.load(std::memory_order_seq_cst))
+						{
+							break;
+						}
+						mNumDrained.wait(numDrained, std::memory_order_seq_cst);
+					}
+					isIdle = true;
+				}
+				else
+				{
+					std::unique_lock lock(mDrainMutex);
+					isIdle = mDrainCondition.wait_until(lock, *pDeadline, [this]() { return !mIsScheduled.load(std::memory_order_seq_cst); });
+				}
+				mNumDrainWaiters.fetch_sub(1, std::memory_order_relaxed);
+				return isIdle;
+			}
+			///------------------------------------------------------------------------------------------
+			/// Anzahl der bisher verworfenen Ereignisse
+			size_t NumDropped() const
+			{
+				return mNumDropped.load(std::memory_order_relaxed);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Anzahl der Zustellungen, in denen der Callback eine Exception geworfen hat
+			size_t NumFailed() const
+			{
+				return mNumFailed.load(std::memory_order_relaxed);
+			}
+		private:
+			///------------------------------------------------------------------------------------------
+			/// Stellt die Zustellung in den Executor ein, sofern sie nicht bereits eingeplant ist
+			template <class KeepAlive>
+			void Schedule(ThreadPoolExecutor& executor, const KeepAlive& keepAlive)
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(!mIsScheduled.exchange(true, std::memory_order_acq_rel))
+				{
+					mKeepAlive	= keepAlive;
+					mExecutor	= &executor;
+					PostSelf();
+				}
+			}
+			///------------------------------------------------------------------------------------------
+			/// Stellt die Zustellung nach dem Ende der Coroutine des Callbacks erneut ein
+			DetachedCoroutine RunTask(SharedArguments pArgs)
+			{
+				try
+				{
+					co_await mTarget.InvokeTask(*pArgs);
+				}
+				catch(...)
+				{
+					mNumFailed.fetch_add(1, std::memory_order_relaxed);
+				}
+				PostSelf();
+			}
+			///------------------------------------------------------------------------------------------
+			/// Stellt die Zustellung in die EventLoop bzw. den Executor ein
+			void PostSelf()
+			{
+				if(EventLoop* const pLoop = mTarget.Loop())
+				{
+					(void)pLoop->Post(*this);
+				}
+				else
+				{
+					mExecutor->Post(*this);
+				}
+			}
+
+			container::LockFreeQueue<SharedArguments>	mEvents;
+			const MailboxOverflowPolicy				mOverflowPolicy;
+			const Target&							mTarget;
+			std::atomic_bool						mIsScheduled	= false;
+			std::atomic_uint32_t					mNumPopped		= 0;	// zum Warten bei MailboxOverflowPolicy::Block
+			std::atomic_uint32_t					mNumBlockedProducers = 0;
+			mutable std::atomic_uint32_t			mNumDrained		= 0;	// Anzahl abgeschlossener Zustellungen, für WaitUntilIdle()
+			mutable std::atomic_uint32_t			mNumDrainWaiters = 0;
+			mutable std::mutex						mDrainMutex;			// nur für WaitUntilIdle() mit Zeitlimit
+			mutable std::condition_variable			mDrainCondition;
+			std::atomic_size_t						mNumDropped		= 0;
+			std::atomic_size_t						mNumFailed		= 0;
+			std::shared_ptr<const void>				mKeepAlive;				// nur während eingeplanter Zustellung gesetzt
+			ThreadPoolExecutor*						mExecutor		= nullptr;
+		};
+
+		///_________________________________________________________________________________________________
+		/// Gemeinsamer Zustand mehrerer gleichzeitig erwarteter Coroutinen (siehe RunJoined()). Die
+		/// erwartende Coroutine wird nach dem letzten Abschluss fortgesetzt.
+		struct JoinState
+		{
+			std::coroutine_handle<>	continuation;
+			std::atomic_size_t		numOutstanding	= 1;	// +1, bis alle Coroutinen gestartet sind
+			std::atomic_bool		hasException	= false;
+			std::exception_ptr		exception;				// erste Exception der Runde
+
+			void SetException(std::exception_ptr e)
+			{
+				if(!hasException.exchange(true, std::memory_order_relaxed))
+				{
+					exception = std::move(e);
+				}
+			}
+			/// true für den letzten Abschluss der Runde
+			bool Finish()
+			{
+				return numOutstanding.fetch_sub(1, std::memory_order_acq_rel) == 1;
+			}
+		};
+
+		///_________________________________________________________________________________________________
+		/// Erwartet "task" im Rahmen einer Runde und setzt nach dem letzten Abschluss die erwartende
+		/// Coroutine fort. Der Aufrufer erhöht numOutstanding vor dem Start.
+		inline DetachedCoroutine RunJoined(CallbackTask task, std::shared_ptr<JoinState> pState)
+		{
+			try
+			{
+				co_await std::move(task);
+			}
+			catch(...)
+			{
+				pState->SetException(std::current_exception());
+			}
+			if(pState->Finish())
+			{
+				pState->continuation.resume();
+			}
+		}
+	} // namespace detail
+
+} // namespace tiel::concurrent
@@ -1,50 +1,575 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include <optional>
 #include <functional>
 #include <mutex>
-#include <future>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <tuple>
 #include <atomic>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "CallbackDispatch.h"
+#include "CallbackTask.h"
+#include "EventLoop.h"
+#include "HazardPointer.h"
+#include "InplaceFunction.h"
+#include "ThreadPoolExecutor.h"
 
 namespace tiel::concurrent
 {
+	//________________________________________________________________________________________________
+	/// @brief	Rückgabewert eines Callbacks der Prioritätskette (siehe
+	///			BasicCallbackHandler::AddPriorityCallback())
+	enum class CallbackResult
+	{
+		Continue,		// der nächste Callback der Kette wird aufgerufen
+		Stop			// der Durchlauf endet nach diesem Callback
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Speicher-Policy für BasicCallbackHandler: Callbacks werden als std::function abgelegt.
+	struct StdFunctionStorage
+	{
+		template <class Signature>
+		using FunctionType = std::function<Signature>;
+
+		static constexpr bool EnableProfiling = false;
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Speicher-Policy für BasicCallbackHandler: Callbacks werden ohne Heap-Allokation als
+	///			InplaceFunction mit der angegebenen Kapazität abgelegt. Zu große Callbacks werden beim
+	///			Übersetzen abgewiesen.
+	/// @remark	Das gilt für das Callable selbst. Der Handler legt weiterhin Blöcke, Listenköpfe und
+	///			ggf. SlotDispatch auf dem Heap an (siehe BasicCallbackHandler, Aufwand).
+	/// @tparam Capacity	max. Größe eines Callbacks (inklusive Captures) in Bytes
+	template <size_t Capacity = 64>
+	struct InplaceStorage
+	{
+		template <class Signature>
+		using FunctionType = InplaceFunction<Signature, Capacity>;
+
+		static constexpr bool EnableProfiling = false;
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Policy-Adapter für BasicCallbackHandler: ergänzt eine Speicher-Policy um die Laufzeitmessung
+	///			je Callback (siehe BasicCallbackHandler::GetCallbackProfile()).
+	/// @remark	Ohne diesen Adapter wird die Messung vollständig wegkompiliert, die Slots enthalten dann
+	///			keine zusätzlichen Daten.
+	/// @tparam StoragePolicy	Speicher-Policy der Callbacks (StdFunctionStorage, InplaceStorage<N>)
+	template <class StoragePolicy = StdFunctionStorage>
+	struct ProfilingPolicy : StoragePolicy
+	{
+		static constexpr bool EnableProfiling = true;
+	};
+
+	//________________________________________________________________________________________________
+	/// @brief	Laufzeitstatistik eines Callbacks (siehe ProfilingPolicy)
+	/// @remark	Histogramm: Bucket 0 zählt Aufrufe unter 1 us, Bucket i Aufrufe von 2^(i-1) bis unter
+	///			2^i us, der letzte Bucket zusätzlich alle längeren Aufrufe.
+	struct CallbackProfile
+	{
+		static constexpr size_t NumHistogramBuckets = 24;
+
+		uint64_t									numCalls			= 0;
+		uint64_t									numBudgetExceeded	= 0;	// Aufrufe über dem Zeitbudget
+		std::chrono::nanoseconds					totalTime			{ 0 };
+		std::chrono::nanoseconds					maxTime				{ 0 };
+		std::array<uint64_t, NumHistogramBuckets>	histogram			{};
+	};
+
 	//________________________________________________________________________________________________
 	/// @brief	Klasse zum threadsicheren Verwalten von Callback-Objekten
-	/// @remark	Die zu registrierenden Callbacks mssen die Signatur std::function<void(Args ...)> haben
-	//	@param	Args	Callback-Parameter
-	template <class ... Args>
-	class CallbackHandler final
+	/// @remark	Die zu registrierenden Callbacks müssen mit der Signatur void(const Args& ...) aufrufbar
+	///			sein. Die Argumente werden ohne Kopie an alle Callbacks weitergereicht, asynchrone
+	///			Aufrufe teilen sich eine einzige, unveränderliche Kopie der Argumente.
+	///			Aufbau: Die Callbacks liegen in Blöcken zu je 64 Slots. Ein Slot enthält nur, was CallAll()
+	///			je Callback liest: den Callback (mit InplaceStorage ohne weitere Indirektion), die
+	///			Generation und mit ProfilingPolicy die Laufzeitmessung. Eine Belegungsmaske je Block
+	///			überspringt freie Slots. Asynchroner Aufruf (CallAllAsync()), Postfach (CallAllQueued()),
+	///			Coroutine und EventLoop eines Callbacks liegen getrennt davon in einem SlotDispatch, der
+	///			erst bei Bedarf angelegt wird; die Zustellung selbst übernehmen die Bausteine aus
+	///			CallbackDispatch.h.
+	///			Nebenläufigkeit: Die Aufrufe arbeiten ohne Sperre. Die synchronen Aufrufe schützen die
+	///			veröffentlichte Liste mit einem HazardPointer, der nur in einen Slot des aufrufenden
+	///			Threads schreibt, sodass gleichzeitige CallAll()-Aufrufe ohne Cache-Line-Transfers
+	///			skalieren. AddCallback() beschreibt einen freien Slot an Ort und Stelle und veröffentlicht
+	///			ihn durch Setzen seines Masken-Bits (release). RemoveCallback() löscht das Bit und
+	///			veröffentlicht eine neue Liste, die sich die Blöcke mit der bisherigen teilt. Der Slot
+	///			wird erst geleert und wiederverwendet, wenn keine Liste mehr lebt, deren Leser ihn noch
+	///			sehen konnten (Friedhof je Liste, siehe Graveyard); ein laufender Aufruf kann einen
+	///			gerade entfernten Callback daher noch aufrufen.
+	///			Callbacks dürfen den eigenen Handler während des Aufrufs ändern. Die laufende Runde liest
+	///			die Maske eines Blocks einmal; Änderungen in bereits gelesenen Blöcken wirken ab dem
+	///			nächsten Aufruf, in noch nicht gelesenen Blöcken ggf. schon in der laufenden Runde.
+	///			Aufwand: AddCallback() O(1) ohne Kopie der Liste, beim Anhängen eines neuen Blocks (alle
+	///			64 Slots) zusätzlich O(Anzahl Blöcke) für die Blockzeiger. RemoveCallback() O(1), es wird
+	///			nur der Listenkopf (Blockzeiger, Kette, Einstellungen) neu angelegt. Mit InplaceStorage
+	///			wird der Callback selbst ohne Heap-Allokation abgelegt; Allokationen entstehen nur für
+	///			neue Blöcke, Listenköpfe, SlotDispatch und mit ProfilingPolicy die Laufzeitmessung.
+	///			AddPriorityCallback() und das Entfernen aus der Kette kopieren die Prioritätskette (O(K)).
+	///			Size() und die leeren Prüfungen zählen die Masken (O(Anzahl Blöcke)).
+	///			Ein Handle besteht aus Slot-Index und Generationszähler des Slots, ein veraltetes Handle
+	///			kann daher keinen später in denselben Slot eingetragenen Callback entfernen.
+	///			Zusätzlich gibt es eine nach Priorität sortierte Kette von Callbacks, die mit
+	///			CallUntilStop() der Reihe nach aufgerufen werden, bis ein Callback den Durchlauf beendet
+	///			(z.B. Filterketten).
+	//	@param	StoragePolicy	Speicher-Policy der Callbacks (StdFunctionStorage, InplaceStorage<N>,
+	//							ProfilingPolicy<...>)
+	//	@param	Args			Callback-Parameter
+	template <class StoragePolicy, class ... Args>
+	class BasicCallbackHandler final
 	{
+	public:
+		using CallbackType		= typename StoragePolicy::template FunctionType<void(const Args& ...)>;
+		using TaskCallbackType	= typename StoragePolicy::template FunctionType<CallbackTask(const Args& ...)>;
+		using PriorityCallbackType = typename StoragePolicy::template FunctionType<CallbackResult(const Args& ...)>;
+		using CallbackHandle	= int64_t;	// (Generation << 32) | Slot-Index, -1: ungültig
+		using ArgumentTuple		= std::tuple<std::decay_t<Args>...>;	// Argumente eines Ereignisses für CallAllBatch()
+		using SlowCallbackHook	= std::function<void(CallbackHandle handle, std::chrono::nanoseconds duration)>;
+
+		static constexpr bool IsProfilingEnabled = StoragePolicy::EnableProfiling;
+
+	private:
+		using SharedArguments	= std::shared_ptr<const ArgumentTuple>;	// von allen asynchronen Aufrufen eines Ereignisses geteilt
+		using SharedHook		= std::atomic<std::shared_ptr<const SlowCallbackHook>>;
+
 		///_________________________________________________________________________________________________
-		/// Hilfsklasse, die den reingereichten atomic_bool Status im Konstruktor auf true, und am Ende der
-		/// der Lebensdauer auf false setzt.
-		class AtomicStateGuard final
+		/// Laufzeitmessung eines Callback-Slots. Wird von allen Schnappschüssen geteilt, die Zähler
+		/// werden ohne Sperre aktualisiert.
+		class ProfileRecorder final
 		{
-			std::atomic_bool* pState;
 		public:
-			AtomicStateGuard(std::atomic_bool& stateRef) : pState(&stateRef)
+			///------------------------------------------------------------------------------------------
+			/// Misst die Laufzeit eines Aufrufs von der Konstruktion bis zur Destruktion
+			class Scope final
+			{
+			public:
+				explicit Scope(ProfileRecorder& recorder)
+					: mRecorder(recorder), mStart(std::chrono::steady_clock::now())
+				{}
+				~Scope()
+				{
+					mRecorder.Record(std::chrono::steady_clock::now() - mStart);
+				}
+			private:
+				ProfileRecorder&						mRecorder;
+				std::chrono::steady_clock::time_point	mStart;
+			};
+
+			ProfileRecorder(CallbackHandle handle, std::shared_ptr<SharedHook> pHook)
+				: mHandle(handle), mpHook(std::move(pHook))
+			{}
+			///------------------------------------------------------------------------------------------
+			/// Erfasst einen Aufruf und ruft bei Überschreiten des Zeitbudgets den Hook auf. Exceptions
+			/// des Hooks werden ignoriert.
+			void Record(std::chrono::nanoseconds duration) noexcept
+			{
+				const uint64_t ns = static_cast<uint64_t>((std::max)(duration.count(), std::chrono::nanoseconds::rep(0)));
+				mNumCalls.fetch_add(1, std::memory_order_relaxed);
+				mTotalNs.fetch_add(ns, std::memory_order_relaxed);
+				mHistogram[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+				uint64_t maxNs = mMaxNs.load(std::memory_order_relaxed);
+				while((ns > maxNs) && !mMaxNs.compare_exchange_weak(maxNs, ns, std::memory_order_relaxed))
+				{
+				}
+
+				const uint64_t budgetNs = mBudgetNs.load(std::memory_order_relaxed);
+				if((budgetNs != 0) && (ns > budgetNs))
+				{
+					mNumBudgetExceeded.fetch_add(1, std::memory_order_relaxed);
+					if(const std::shared_ptr<const SlowCallbackHook> pHook = mpHook->load(std::memory_order_acquire))
+					{
+						try
+						{
+							(*pHook)(mHandle, duration);
+						}
+						catch(...)
+						{
+						}
+					}
+				}
+			}
+			///------------------------------------------------------------------------------------------
+			/// Zeitbudget eines Aufrufs, 0: keine Überwachung
+			void SetBudget(std::chrono::nanoseconds budget)
+			{
+				mBudgetNs.store(static_cast<uint64_t>((std::max)(budget.count(), std::chrono::nanoseconds::rep(0))), std::memory_order_relaxed);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Gibt die bisher erfassten Werte zurück (bei gleichzeitigen Aufrufen nicht konsistent)
+			CallbackProfile Get() const
 			{
-				stateRef = true;
+				CallbackProfile profile;
+				profile.numCalls			= mNumCalls.load(std::memory_order_relaxed);
+				profile.numBudgetExceeded	= mNumBudgetExceeded.load(std::memory_order_relaxed);
+				profile.totalTime			= std::chrono::nanoseconds(mTotalNs.load(std::memory_order_relaxed));
+				profile.maxTime				= std::chrono::nanoseconds(mMaxNs.load(std::memory_order_relaxed));
+				for(size_t i = 0; i < profile.histogram.size(); i++)
+				{
+					profile.histogram[i] = mHistogram[i].load(std::memory_order_relaxed);
+				}
+				return profile;
 			}
-			~AtomicStateGuard()
+		private:
+			static size_t Bucket(uint64_t ns)
 			{
-				*pState = false;
+				return (std::min)(static_cast<size_t>(std::bit_width(ns/1000)), CallbackProfile::NumHistogramBuckets - 1);
 			}
+
+			const CallbackHandle													mHandle;
+			const std::shared_ptr<SharedHook>										mpHook;
+			std::atomic_uint64_t													mNumCalls			= 0;
+			std::atomic_uint64_t													mNumBudgetExceeded	= 0;
+			std::atomic_uint64_t													mTotalNs			= 0;
+			std::atomic_uint64_t													mMaxNs				= 0;
+			std::atomic_uint64_t													mBudgetNs			= 0;
+			std::array<std::atomic_uint64_t, CallbackProfile::NumHistogramBuckets>	mHistogram			{};
 		};
+		struct NoProfiling {};	// ersetzt die Messdaten ohne ProfilingPolicy
+		using ProfilePtr	= std::conditional_t<IsProfilingEnabled, std::shared_ptr<ProfileRecorder>, NoProfiling>;
+		using HookPtr		= std::conditional_t<IsProfilingEnabled, std::shared_ptr<SharedHook>, NoProfiling>;
 
-	public:
-		using CallbackType = std::function<void(Args ...)>;
+		///_________________________________________________________________________________________________
+		/// Hilfsklasse, die den reingereichten Zähler laufender Operationen im Konstruktor erhöht und am
+		/// Ende der Lebensdauer wieder verringert.
+		class PendingOperationGuard final
+		{
+			std::atomic_int* pCounter;
+		public:
+			PendingOperationGuard(std::atomic_int& counterRef) : pCounter(&counterRef)
+			{
+				counterRef.fetch_add(1, std::memory_order_relaxed);
+			}
+			~PendingOperationGuard()
+			{
+				pCounter->fetch_sub(1, std::memory_order_relaxed);
+			}
+		};
+		class SlotDispatch;
+		using AsyncCallType	= detail::AsyncCall<SlotDispatch>;
+		using MailboxType	= detail::Mailbox<SlotDispatch>;
+		static constexpr size_t SlotsPerBlock = 64;
+		///_________________________________________________________________________________________________
+		/// Slot der Callback-Liste, enthält nur die Daten, die CallAll() je Callback liest
+		struct CallbackSlot
+		{
+			CallbackType						callback;			// leer bei gebundenen und Coroutine-Callbacks (siehe SlotDispatch)
+			uint32_t							generation	= 0;	// wird bei jeder Belegung erhöht
+			[[no_unique_address]] ProfilePtr	pProfile;			// nur mit ProfilingPolicy
+		};
+		///_________________________________________________________________________________________________
+		/// Block von Slots, der an Ort und Stelle geändert wird. Ein Slot wird nur beschrieben, solange sein
+		/// Bit in liveMask gelöscht ist und ihn kein Leser mehr sehen kann; das Setzen des Bits
+		/// (release) veröffentlicht ihn.
+		struct SlotBlock
+		{
+			std::atomic_uint64_t									liveMask	= 0;
+			std::array<CallbackSlot, SlotsPerBlock>					slots;
+			std::array<std::atomic<SlotDispatch*>, SlotsPerBlock>	dispatch	{};	// nullptr, bis benötigt
+
+			SlotBlock() = default;
+			SlotBlock(const SlotBlock&) = delete;
+			SlotBlock& operator=(const SlotBlock&) = delete;
+			~SlotBlock()
+			{
+				for(std::atomic<SlotDispatch*>& pDispatch : dispatch)
+				{
+					delete pDispatch.load(std::memory_order_acquire);
+				}
+			}
+		};
+		using BlockList = std::vector<std::shared_ptr<SlotBlock>>;
+
+		///_________________________________________________________________________________________________
+		/// Selten benötigte Daten eines Slots. Sie liegen getrennt vom Slot, damit CallAll() je Callback
+		/// nur Callback und Generation liest. Für gebundene und Coroutine-Callbacks sowie abweichende
+		/// Postfach-Einstellungen beim Anmelden angelegt, sonst erst beim ersten CallAllAsync() bzw.
+		/// CallAllQueued(); asynchroner Aufruf und Postfach entstehen jeweils erst bei ihrer ersten
+		/// Verwendung. Aufrufziel von detail::AsyncCall und detail::Mailbox (siehe CallbackDispatch.h).
+		class SlotDispatch final
+		{
+		public:
+			using ArgumentTuple = BasicCallbackHandler::ArgumentTuple;
+
+			SlotDispatch(const CallbackSlot& slot, CallbackType boundCallback, TaskCallbackType taskCallback,
+						 EventLoop* pLoop, const MailboxOptions& mailboxOptions)
+				: mSlot(slot)
+				, mBoundCallback(std::move(boundCallback))
+				, mTaskCallback(std::move(taskCallback))
+				, mpLoop(pLoop)
+				, mMailboxOptions(mailboxOptions)
+			{}
+			explicit SlotDispatch(const CallbackSlot& slot)
+				: SlotDispatch(slot, CallbackType(), TaskCallbackType(), nullptr, {})
+			{}
+			SlotDispatch(const SlotDispatch&) = delete;
+			SlotDispatch& operator=(const SlotDispatch&) = delete;
+			~SlotDispatch()
+			{
+				delete mpAsyncCall.load(std::memory_order_acquire);
+				delete mpMailbox.load(std::memory_order_acquire);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Callback für synchrone Aufrufe, leer bei Coroutine-Callbacks
+			const CallbackType& Callback() const
+			{
+				return mBoundCallback ? mBoundCallback : mSlot.callback;
+			}
+			///------------------------------------------------------------------------------------------
+			/// true, wenn der Slot an eine EventLoop gebunden ist, die nicht im aufrufenden Thread läuft
+			bool IsBoundToOtherThread() const
+			{
+				return (mpLoop != nullptr) && !mpLoop->IsCurrentThread();
+			}
+			///------------------------------------------------------------------------------------------
+			/// Aufrufziel (siehe CallbackDispatch.h)
+			void Invoke(const ArgumentTuple& args) const
+			{
+				BasicCallbackHandler::Invoke(mSlot, Callback(), args);
+			}
+			bool IsTask() const
+			{
+				return static_cast<bool>(mTaskCallback);
+			}
+			CallbackTask InvokeTask(const ArgumentTuple& args) const
+			{
+				return std::apply(mTaskCallback, args);
+			}
+			EventLoop* Loop() const
+			{
+				return mpLoop;
+			}
+			///------------------------------------------------------------------------------------------
+			/// Gibt den asynchronen Aufruf bzw. das Postfach zurück und legt sie beim ersten Bedarf an
+			AsyncCallType& GetAsyncCall()
+			{
+				return GetOrCreate(mpAsyncCall, *this);
+			}
+			MailboxType& GetMailbox()
+			{
+				return GetOrCreate(mpMailbox, mMailboxOptions, *this);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Gibt den asynchronen Aufruf bzw. das Postfach zurück, nullptr, wenn nie verwendet
+			AsyncCallType* FindAsyncCall() const
+			{
+				return mpAsyncCall.load(std::memory_order_acquire);
+			}
+			MailboxType* FindMailbox() const
+			{
+				return mpMailbox.load(std::memory_order_acquire);
+			}
+		private:
+			const CallbackSlot&			mSlot;
+			const CallbackType			mBoundCallback;		// nur an eine EventLoop gebundene Callbacks
+			const TaskCallbackType		mTaskCallback;
+			EventLoop* const			mpLoop;				// Schleife, in der der Callback aufgerufen wird
+			const MailboxOptions		mMailboxOptions;
+			std::atomic<AsyncCallType*>	mpAsyncCall	= nullptr;
+			std::atomic<MailboxType*>	mpMailbox	= nullptr;
+		};
+
+		///_________________________________________________________________________________________________
+		/// Eintrag der Prioritätskette, die Kette ist absteigend nach Priorität und bei gleicher Priorität
+		/// nach der Reihenfolge der Anmeldung sortiert
+		struct PriorityEntry
+		{
+			PriorityCallbackType	callback;
+			int						priority	= 0;
+			CallbackHandle			handle		= -1;
+		};
+		using PriorityChain = std::vector<PriorityEntry>;
+		///_________________________________________________________________________________________________
+		/// Von den Friedhöfen freigegebene Slot-Indizes, bis AllocateHandle() sie übernimmt. Eigene
+		/// Sperre, da ein Friedhof in beliebigen Threads (auch unter mMutex) zerstört wird.
+		struct SlotInbox
+		{
+			std::mutex				mutex;
+			std::vector<uint32_t>	indices;
+		};
+		///_________________________________________________________________________________________________
+		/// Friedhof einer veröffentlichten Liste: Slots, die entfernt wurden, während die Liste aktuell war.
+		/// Leser dieser oder einer älteren Liste können sie noch aufrufen. Jeder Friedhof hält den der
+		/// nachfolgenden Liste, daher wird er erst zerstört, wenn auch alle älteren Listen freigegeben
+		/// sind. Erst dann werden die Slots geleert und zur Wiederverwendung freigegeben.
+		class Graveyard final
+		{
+		public:
+			Graveyard(std::shared_ptr<const BlockList> pBlocks, std::shared_ptr<SlotInbox> pInbox)
+				: mpBlocks(std::move(pBlocks))
+				, mpInbox(std::move(pInbox))
+			{}
+			Graveyard(const Graveyard&) = delete;
+			Graveyard& operator=(const Graveyard&) = delete;
+			~Graveyard()
+			{
+				Release();
+				// die Kette iterativ abbauen, da eine lange gehaltene Liste viele Nachfolger aufstauen kann
+				std::shared_ptr<Graveyard> pNext = TakeNext();
+				while((pNext != nullptr) && (pNext.use_count() == 1))
+				{
+					pNext = pNext->TakeNext();
+				}
+			}
+			///------------------------------------------------------------------------------------------
+			/// Nimmt den entfernten Slot "index" auf. mMutex muss gehalten werden.
+			void Add(uint32_t index)
+			{
+				mIndices.push_back(index);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Hängt den Friedhof der nachfolgenden Liste an. mMutex muss gehalten werden.
+			void Link(std::shared_ptr<Graveyard> pNext)
+			{
+				std::lock_guard lock(mpInbox->mutex);
+				mpNext = std::move(pNext);
+			}
+		private:
+			///------------------------------------------------------------------------------------------
+			/// Löst den Nachfolger. Die Sperre ordnet Link() davor ein, da use_count() im Destruktor
+			/// nicht synchronisiert.
+			std::shared_ptr<Graveyard> TakeNext()
+			{
+				std::lock_guard lock(mpInbox->mutex);
+				return std::move(mpNext);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Leert die Slots und gibt sie zur Wiederverwendung frei
+			void Release() noexcept
+			{
+				if(mIndices.empty())
+				{
+					return;
+				}
+				for(const uint32_t index : mIndices)
+				{
+					SlotBlock&		block		= *(*mpBlocks)[index/SlotsPerBlock];
+					const size_t	slotIndex	= index%SlotsPerBlock;
+					delete block.dispatch[slotIndex].exchange(nullptr, std::memory_order_acq_rel);
+					block.slots[slotIndex].callback	= nullptr;
+					block.slots[slotIndex].pProfile	= {};
+				}
+				std::lock_guard lock(mpInbox->mutex);
+				mpInbox->indices.insert(mpInbox->indices.end(), mIndices.begin(), mIndices.end());
+			}
+
+			const std::shared_ptr<const BlockList>	mpBlocks;
+			const std::shared_ptr<SlotInbox>		mpInbox;
+			std::vector<uint32_t>					mIndices;
+			std::shared_ptr<Graveyard>				mpNext;
+		};
+		///_________________________________________________________________________________________________
+		/// Veröffentlichte Callback-Liste. Die Blöcke werden an Ort und Stelle geändert und nur beim
+		/// Anhängen eines Blocks kopiert. Eine neue Liste wird nur für Entfernen, neue Blöcke,
+		/// Prioritätskette und Einstellungen veröffentlicht. Asynchrone Aufrufe und Postfächer
+		/// übernehmen per shared_from_this() einen Anteil, solange ein HazardPointer die Liste schützt.
+		struct CallbackList : std::enable_shared_from_this<CallbackList>
+		{
+			std::shared_ptr<const BlockList>		pBlocks;
+			std::shared_ptr<const PriorityChain>	pPriorityChain;	// nullptr: leere Kette
+			AsyncOverrunOptions						asyncOverrun;	// wird mit der Liste veröffentlicht
+			std::shared_ptr<Graveyard>				pGraveyard;		// von PublishList() gesetzt
+		};
+		using ListGuard = HazardPointer<const CallbackList>;	// schützt die Liste während eines Aufrufs
+
+		///_________________________________________________________________________________________________
+		/// Gemeinsamer Zustand einer CallAllAwaitable()-Runde. Hält Schnappschuss und Argumente, bis die
+		/// letzte Coroutine abgeschlossen ist.
+		struct AwaitState : detail::JoinState
+		{
+			std::shared_ptr<const CallbackList>	pCallbacks;
+			SharedArguments						pArgs;
+		};
+
+		///_________________________________________________________________________________________________
+		/// Awaitable von CallAllAwaitable()
+		class CallAllAwaiter final
+		{
+		public:
+			CallAllAwaiter(BasicCallbackHandler& handler, std::shared_ptr<AwaitState> pState)
+				: mHandler(handler)
+				, mState(std::move(pState))
+			{}
+			bool await_ready() const noexcept
+			{
+				return !HasCallbacks(*mState->pCallbacks);
+			}
+			bool await_suspend(std::coroutine_handle<> continuation)
+			{
+				AwaitState& state = *mState;
+				state.continuation = continuation;
+				ForEachSlot(*state.pCallbacks, [this, &state](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
+					{
+						try
+						{
+							if(slot.callback)
+							{
+								Invoke(slot, slot.callback, *state.pArgs);
+								return;
+							}
+							SlotDispatch& slotDispatch = *dispatch.load(std::memory_order_acquire);
+							if(slotDispatch.IsTask())
+							{
+								CallbackTask task = slotDispatch.InvokeTask(*state.pArgs);
+								state.numOutstanding.fetch_add(1, std::memory_order_relaxed);
+								detail::RunJoined(std::move(task), mState);
+							}
+							else if(slotDispatch.IsBoundToOtherThread())
+							{
+								mHandler.PostToLoop(*state.pCallbacks, slotDispatch, state.pArgs);
+							}
+							else
+							{
+								slotDispatch.Invoke(*state.pArgs);
+							}
+						}
+						catch(...)
+						{
+							state.SetException(std::current_exception());
+						}
+					});
+				// nach Finish() kann die Coroutine bereits in einem anderen Thread fortgesetzt werden
+				return !state.Finish();
+			}
+			void await_resume() const
+			{
+				if(mState->exception)
+				{
+					std::rethrow_exception(mState->exception);
+				}
+			}
+		private:
+			BasicCallbackHandler&		mHandler;
+			std::shared_ptr<AwaitState>	mState;
+		};
 
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Standard-Konstruktor, CallAllAsync() verwendet CallbackDispatchExecutor()
+		BasicCallbackHandler() = default;
 		///----------------------------------------------------------------------------------------------
-		/// Standard-Konstruktor
-		CallbackHandler() = default;
+		/// @brief Konstruktor
+		/// @param executor		Executor, über den CallAllAsync() die Callbacks aufruft. Muss den
+		///						CallbackHandler überleben.
+		explicit BasicCallbackHandler(ThreadPoolExecutor& executor)
+			: mExecutor(&executor)
+		{}
 		///----------------------------------------------------------------------------------------------
 		/// Typ ist nicht kopierbar
-		CallbackHandler(const CallbackHandler&) = delete;
-		CallbackHandler& operator=(const CallbackHandler&) = delete;
+		BasicCallbackHandler(const BasicCallbackHandler&) = delete;
+		BasicCallbackHandler& operator=(const BasicCallbackHandler&) = delete;
 		///----------------------------------------------------------------------------------------------
 		/// Destruktor
-		~CallbackHandler()
+		~BasicCallbackHandler()
 		{
 			//_ASSERT(false); // not tested
 			_ASSERT(!IsPendingOperation() && !IsAnyCallbackPending());
@@ -52,432 +577,1227 @@ namespace tiel::concurrent
 		}
 		///----------------------------------------------------------------------------------------------
 		/// @brief Move-Konstruktor
-		/// @param mv_other		CallbackHandler, dessen Callbacks bernommen werden. Dessen Calbback-Liste
-		///						ist anschlieend leer.
-		CallbackHandler(CallbackHandler&& mv_other) noexcept
+		/// @param mv_other		CallbackHandler, dessen Callbacks übernommen werden. Dessen Calbback-Liste
+		///						ist anschließend leer.
+		BasicCallbackHandler(BasicCallbackHandler&& mv_other) noexcept
 		{
 			//_ASSERT(false); // not tested
-			std::lock_guard lock(mMutex);
-			mCallbacks			= std::move(mv_other.mCallbacks);
-			mCallbackFutures	= std::move(mv_other.mCallbackFutures);
+			std::scoped_lock lock(mMutex, mv_other.mMutex);
+			TakeCallbacks(mv_other);
 
-			mIsPendingOperation.store(mv_other.mIsPendingOperation.load(std::memory_order_acquire));
-			mv_other.mIsPendingOperation.store(false, std::memory_order_relaxed);
+			mNumPendingOperations.store(mv_other.mNumPendingOperations.exchange(0));
 		}
 		///----------------------------------------------------------------------------------------------
 		/// @brief Move-Zuweisungsoperator
-		/// @param mv_rhs		CallbackHandler, dessen Callbacks bernommen werden. Dessen Calbback-Liste
-		///						ist anschlieend leer.
-		CallbackHandler& operator=(CallbackHandler&& mv_rhs) noexcept
+		/// @remark	Die bisherigen Callbacks werden wie im Destruktor entfernt, es dürfen daher keine
+		///			Aufrufe mehr laufen. Eine Selbstzuweisung ändert nichts.
+		/// @param mv_rhs		CallbackHandler, dessen Callbacks übernommen werden. Dessen Calbback-Liste
+		///						ist anschließend leer.
+		BasicCallbackHandler& operator=(BasicCallbackHandler&& mv_rhs) noexcept
 		{
 			//_ASSERT(false); // not tested
+			if(this == &mv_rhs)
+			{
+				return *this;
+			}
+			// die bisherigen Callbacks wie im Destruktor entfernen
+			_ASSERT(!IsPendingOperation() && !IsAnyCallbackPending());
+			RemoveAllCallbacks();
+
 			std::scoped_lock lock(mMutex, mv_rhs.mMutex);
-			mCallbacks			= std::move(mv_rhs.mCallbacks);
-			mCallbackFutures	= std::move(mv_rhs.mCallbackFutures);
+			TakeCallbacks(mv_rhs);
 
-			mIsPendingOperation.store(mv_rhs.mIsPendingOperation.load(std::memory_order_acquire));
-			mv_rhs.mIsPendingOperation.store(false, std::memory_order_relaxed);
+			mNumPendingOperations.store(mv_rhs.mNumPendingOperations.exchange(0));
 			return *this;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Ruft alle angemeldeten Callbacks mit den bergebenen Argumenten nacheinander auf.
-		/// @remark	Exception innerhalb der Callbacks werden nicht behandelt
+		/// @brief	Ruft alle angemeldeten Callbacks mit den übergebenen Argumenten nacheinander auf.
+		/// @remark	Exception innerhalb der Callbacks werden nicht behandelt.
+		///			Es wird keine Sperre gehalten, mehrere Threads können gleichzeitig CallAll() aufrufen.
 		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
-		///						von CallbackHandler<... Args> bereinstimmen muss.
-		void CallAll(Args... args)
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		void CallAll(const Args&... args)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
+			const ListGuard								pCallbacks = ReadListForCall();
+			SharedArguments								pArgs;		// nur für gebundene Callbacks
 
-			std::lock_guard		lock(mMutex);
-			const size_t		numAvailableCallbacks = mCallbacks.size();
-			AtomicStateGuard	stateGuard(mIsPendingOperation);
-
-			for(size_t i = 0; i < numAvailableCallbacks; i++)
-			{
-				if(mCallbacks[i].has_value())
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
 				{
-					// vorherige asynchrone Callbackl per CallAllAsync() sollten abgeschlossen sein
-					_ASSERT(!mCallbackFutures[i].valid() ||	(mCallbackFutures[i].wait_for(0ms) == std::future_status::ready));
-					try
-					{
-						mCallbacks[i].value()(args...);
-					}
-					catch(const std::exception&)
-					{
-						throw;
-					}
-				}
-			}
+					InvokeOrPost(*pCallbacks, slot, dispatch, pArgs, args...);
+				});
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Ruft alle angemeldeten Callbacks mit den bergebenen Argumenten nacheinander auf.
+		/// @brief Ruft alle angemeldeten Callbacks mit den übergebenen Argumenten nacheinander auf.
 		/// @remark	Exception innerhalb der Callbacks werden gefangen.
+		///			Es wird keine Sperre gehalten, mehrere Threads können gleichzeitig CallAllNoExcept()
+		///			aufrufen.
 		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
-		///						von CallbackHandler<... Args> bereinstimmen muss.
+		///						von CallbackHandler<... Args> übereinstimmen muss.
 		/// @return				true, wenn alle registrierten Callbacks erfolgreich aufgerufen wurden.
-		///						false, wenn in mindestens einem Callback eine Ausnahme ausgelst wurde
-		bool CallAllNoExcept(Args... args)
+		///						false, wenn in mindestens einem Callback eine Ausnahme ausgelöst wurde
+		bool CallAllNoExcept(const Args&... args)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
+			const ListGuard								pCallbacks = ReadListForCall();
+			SharedArguments								pArgs;		// nur für gebundene Callbacks
+			bool										success = true;
 
-			std::lock_guard		lock(mMutex);
-			AtomicStateGuard	stateGuard(mIsPendingOperation);
-			const size_t		numAvailableCallbacks = mCallbacks.size();
-			bool				success = true;
-
-			for(size_t i = 0; i < numAvailableCallbacks; i++)
-			{
-				if(mCallbacks[i].has_value())
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
 				{
-					// vorherige asynchrone Callback per CallAllAsync() sollten abgeschlossen sein
-					_ASSERT(!mCallbackFutures[i].valid() ||	(mCallbackFutures[i].wait_for(0ms) == std::future_status::ready));
 					try
 					{
-						mCallbacks[i].value()(args...);
+						InvokeOrPost(*pCallbacks, slot, dispatch, pArgs, args...);
 					}
 					catch(const std::exception&)
 					{
 						success = false;
 					}
-				}
-			}
+				});
 			return success;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Ruft jeden angemeldeten Callback mit den bergebenen Argumenten ber den ThreadPool auf.
-		/// @remark				Wenn ein asynchron aufgerufener Callback noch nicht wieder zurckgekehrt
-		///						ist, wird er in diesem Aufruf nicht erneut aufgerufen, da CallAllAsync()
-		///						sonst blockieren wrde.
-		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
-		///						von CallbackHandler<... Args> bereinstimmen muss.
-		/// @return				true, wenn alle registrierten Callbacks asynchron aufgerufen wurden.
-		///						false, wenn mindestens ein registrierter Callback von einem vorherigen
-		///						Aufruf durch CallAllAsync() noch nicht wieder zurckgekehrt ist.
-		bool CallAllAsync(Args... args)
+		/// @brief	Ruft alle angemeldeten Callbacks für jedes Ereignis der übergebenen Folge auf.
+		/// @remark	Jeder Callback arbeitet die gesamte Folge ab, bevor der nächste Callback aufgerufen
+		///			wird. Code und Daten eines Callbacks bleiben so im Cache, der Schnappschuss der
+		///			Callback-Liste wird nur einmal je Folge geladen.
+		///			Exception innerhalb der Callbacks werden nicht behandelt.
+		/// @param batch		zusammenhängende Folge von Argument-Tupeln
+		void CallAllBatch(std::span<const ArgumentTuple> batch)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
-
-			std::lock_guard lock(mMutex);
-			bool			arePendingCalls = false;
-			const size_t	numAvailableCallbacks = mCallbacks.size();
+			const ListGuard								pCallbacks = ReadListForCall();
 
-			for(size_t i = 0; i < numAvailableCallbacks; i++)
-			{
-				if(mCallbacks[i].has_value())
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
 				{
-					if(		!mCallbackFutures[i].valid()
-						||	(mCallbackFutures[i].wait_for(0ms) == std::future_status::ready))
+					const CallbackType* const pCallback = LocalCallback(*pCallbacks, slot, dispatch, batch);
+					if(pCallback == nullptr)
 					{
-						mCallbackFutures[i] = std::async(std::launch::async, mCallbacks[i].value(), args...);
+						return;
 					}
-				}
-				else
-				{
-					arePendingCalls = true;
-				}
-			}
-			return !arePendingCalls;
+					for(const ArgumentTuple& args : batch)
+					{
+						Invoke(slot, *pCallback, args);
+					}
+				});
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Fgt ein neues aufrufbares Objekt der internen Callback-Liste hinzu.
-		/// @remark	Als aufrufbare Objekte knnen (Member-)Funktionen, Lambdas, std::function<void(...)
-		///			und Klassenobjekte von Klassen, die den entsprechenden function call operator(...) 
-		///			definieren, verwendet werden.
-		/// @param callback		aufrufbares Objekt ()
-		/// @return				Handle des hinzugefgten Callbacks, ber den "callback" mit RemoveCallback()
-		///						wieder entfernt werden kann.
-		[[nodiscard]] int AddCallback(CallbackType callback)
+		/// @brief	Ruft alle angemeldeten Callbacks für jedes Ereignis der übergebenen Folge auf.
+		/// @remark	Wie CallAllBatch(), Exception innerhalb der Callbacks werden jedoch gefangen. Ein
+		///			fehlgeschlagener Aufruf bricht die Folge für diesen Callback nicht ab.
+		/// @param batch		zusammenhängende Folge von Argument-Tupeln
+		/// @return				true, wenn alle Aufrufe erfolgreich waren.
+		///						false, wenn in mindestens einem Aufruf eine Ausnahme ausgelöst wurde
+		bool CallAllBatchNoExcept(std::span<const ArgumentTuple> batch)
 		{
 			//_ASSERT(false); // not tested
-			std::lock_guard lock(mMutex);
-			_ASSERT(mCallbackFutures.size() == mCallbacks.size());
-			const int numAvailableCallbacks = static_cast<int>(mCallbacks.size());
+			const ListGuard								pCallbacks = ReadListForCall();
+			bool										success = true;
 
-			for(int i = 0; i < numAvailableCallbacks; i++)
-			{
-				if(!mCallbacks[i].has_value())
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
 				{
-					mCallbacks[i] = callback;
-					_ASSERT(!mCallbackFutures[i].valid()); // wieso wurde Future in RemoveCallback() nicht entfernt?
-					mCallbackFutures[i] = {};
-					return i;
-				}
-			}
-			mCallbacks.emplace_back(callback);
-			mCallbackFutures.emplace_back();
-			return static_cast<int>(mCallbacks.size()-1);
+					const CallbackType* const pCallback = LocalCallback(*pCallbacks, slot, dispatch, batch);
+					if(pCallback == nullptr)
+					{
+						return;
+					}
+					for(const ArgumentTuple& args : batch)
+					{
+						try
+						{
+							Invoke(slot, *pCallback, args);
+						}
+						catch(const std::exception&)
+						{
+							success = false;
+						}
+					}
+				});
+			return success;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Entfernt das Callback-Objekt mit dem angegebenen Handle aus der internen Callback-Liste
-		/// @param handle		Handle des Callback-Objekts, das entfernt werden soll
-		/// @return				true, wenn ein Callback-Objekt mit dem angegebenen Handle existierte.
-		bool RemoveCallback(int handle)
+		/// @brief	Ruft alle angemeldeten Callbacks parallel über den Executor auf und kehrt zurück, wenn
+		///			alle Aufrufe abgeschlossen sind (Fork-Join).
+		/// @remark	Die Laufzeit entspricht etwa der des langsamsten Callbacks statt der Summe aller
+		///			Callbacks. Der aufrufende Thread arbeitet mit. Die Argumente werden von allen Callbacks
+		///			gleichzeitig gelesen. An eine andere EventLoop gebundene Callbacks werden dort
+		///			eingestellt und nicht abgewartet.
+		///			Wirft ein Callback eine Exception, werden keine weiteren Callbacks begonnen und die erste
+		///			Exception wird nach dem Abschluss der laufenden Callbacks erneut geworfen.
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		void CallAllParallel(const Args&... args)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
+			const ListGuard								pCallbacks	= ReadListForCall();
+			const std::vector<LocalCall>				calls		= LocalCalls(*pCallbacks, args...);
 
-			std::lock_guard lock(mMutex);
-			_ASSERT(mCallbackFutures.size() == mCallbackFutures.size());
+			mExecutor->ParallelFor(0, calls.size(), [&](size_t i)
+				{
+					Invoke(*calls[i].pSlot, *calls[i].pCallback, args...);
+				}, 1);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft alle angemeldeten Callbacks parallel über den Executor auf und kehrt zurück, wenn
+		///			alle Aufrufe abgeschlossen sind (Fork-Join).
+		/// @remark	Exception innerhalb der Callbacks werden gefangen, alle Callbacks werden aufgerufen.
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		/// @return				true, wenn alle registrierten Callbacks erfolgreich aufgerufen wurden.
+		///						false, wenn in mindestens einem Callback eine Ausnahme ausgelöst wurde
+		bool CallAllParallelNoExcept(const Args&... args)
+		{
+			//_ASSERT(false); // not tested
+			const ListGuard								pCallbacks	= ReadListForCall();
+			const std::vector<LocalCall>				calls		= LocalCalls(*pCallbacks, args...);
+			std::atomic_bool							success		= true;
 
-			if((handle < 0) || handle >= static_cast<int>(mCallbacks.size()))
-			{
-				return false;
-			}
-			_ASSERT(	!mCallbackFutures[handle].valid() 
-					||	mCallbackFutures[handle].wait_for(0ms) == std::future_status::ready);
+			mExecutor->ParallelFor(0, calls.size(), [&](size_t i)
+				{
+					try
+					{
+						Invoke(*calls[i].pSlot, *calls[i].pCallback, args...);
+					}
+					catch(const std::exception&)
+					{
+						success.store(false, std::memory_order_relaxed);
+					}
+				}, 1);
+			return success.load(std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft die per AddPriorityCallback() angemeldeten Callbacks in absteigender Priorität
+		///			nacheinander auf, bis ein Callback CallbackResult::Stop zurückgibt.
+		/// @remark	Die Kette liegt sortiert in einem zusammenhängenden Array, nachrangige Callbacks werden
+		///			nach einem Stop nicht mehr berührt. Gewöhnliche Callbacks werden nicht aufgerufen.
+		///			Exception innerhalb der Callbacks werden nicht behandelt und beenden den Durchlauf.
+		///			Es wird keine Sperre gehalten, mehrere Threads können gleichzeitig CallUntilStop()
+		///			aufrufen.
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		/// @return				CallbackResult::Stop, wenn ein Callback den Durchlauf beendet hat
+		CallbackResult CallUntilStop(const Args&... args)
+		{
+			//_ASSERT(false); // not tested
+			const ListGuard								pCallbacks = ReadListForCall();
 
-			if(mCallbackFutures[handle].valid())
+			if(pCallbacks->pPriorityChain != nullptr)
 			{
-				mCallbackFutures[handle].get();
+				for(const PriorityEntry& entry : *pCallbacks->pPriorityChain)
+				{
+					if(entry.callback(args...) == CallbackResult::Stop)
+					{
+						return CallbackResult::Stop;
+					}
+				}
 			}
-			mCallbacks[handle]			= {};
-			mCallbackFutures[handle]	= {};
-			return true;
+			return CallbackResult::Continue;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Entfernt alle Callback-Objekte aus der internen Callback-Liste
-		void RemoveAllCallbacks()
+		/// @brief	Legt das Ereignis im Postfach jedes angemeldeten Callbacks ab. Die Callbacks werden
+		///			unabhängig voneinander über den Executor aufgerufen, jeder Callback erhält seine
+		///			Ereignisse in der Reihenfolge der Aufrufe.
+		/// @remark	Ist ein Postfach voll, wird gemäß dessen MailboxOverflowPolicy (siehe AddCallback())
+		///			gewartet bzw. ein Ereignis verworfen. Mit MailboxOverflowPolicy::Block darf
+		///			CallAllQueued() nicht aus einem Callback desselben Handlers aufgerufen werden.
+		///			Exception innerhalb der Callbacks werden gefangen.
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		/// @return				true, wenn das Ereignis in allen Postfächern abgelegt wurde, ohne dass
+		///						ein Ereignis verworfen wurde.
+		bool CallAllQueued(const Args&... args)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
+			const std::shared_ptr<const CallbackList>	pCallbacks	= Snapshot();
+			SharedArguments								pArgs;
+			size_t										numDropped	= 0;
 
-			std::lock_guard lock(mMutex);
-			_ASSERT(std::count_if(mCallbackFutures.begin(), mCallbackFutures.end(),
-				[](const std::future<void>& f)
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
 				{
-					return f.valid() && (f.wait_for(0ms) != std::future_status::ready);
-				}) == 0);
-			mCallbacks.clear();
-			mCallbackFutures.clear();
+					numDropped += DispatchOf(slot, dispatch).GetMailbox().Post(*mExecutor, pCallbacks, LazyArguments(pArgs, args...));
+				});
+			if(numDropped != 0)
+			{
+				mNumDroppedEvents.fetch_add(numDropped, std::memory_order_relaxed);
+			}
+			return numDropped == 0;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Gibt die Anzahl der intern verwalteten Callback-Objekte zurck.
-		/// @return			Anzahl der intern verwalteten Callback-Objekte.
-		[[nodiscard]] size_t Size() const
+		/// @brief	Gibt die Anzahl der von CallAllQueued() bzw. beim Einstellen in eine EventLoop insgesamt
+		///			verworfenen Ereignisse zurück.
+		[[nodiscard]] size_t NumDroppedEvents() const
 		{
-			std::lock_guard lock(mMutex);
-			return mCallbacks.size();
+			return mNumDroppedEvents.load(std::memory_order_relaxed);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft (NICHT blockierend), ob die Schnittstelle fr unbestimmte Zeit blockiert ist.
-		/// @remark	Gilt fr synchrone CallAll()- und WaitForXXX-Methoden, die fr umbestimmte Zeit die
-		///			gesamte Schnittstelle blockieren knnen.
-		/// @return			true, wenn die Schnittstelle fr umbestimmte Zeit blockiert ist.
-		[[nodiscard]] bool IsPendingOperation() const
+		/// @brief	Gibt die Anzahl der im Postfach des angegebenen Callbacks verworfenen Ereignisse zurück.
+		/// @param handle	Callback-Handle
+		/// @return			Anzahl verworfener Ereignisse, 0 bei ungültigem Handle
+		[[nodiscard]] size_t NumDroppedEvents(CallbackHandle handle) const
 		{
-			return mIsPendingOperation.load(std::memory_order_relaxed);
+			const ListGuard		pCallbacks	= ReadList();
+			const MailboxType*	pMailbox	= FindMailbox(*pCallbacks, handle);
+			return (pMailbox != nullptr) ? pMailbox->NumDropped() : 0;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Prft, ob das Callback-Handle auf ein gltiges Callback-Objekt verweist.
-		/// @param handle	Callback-Handle dessen Gltigkeit berprft wird
-		/// @return			true, wenn das Callback-Handle auf ein gltiges Callback-Objekt verweist
-		[[nodiscard]] bool IsCallbackHandleValid(int handle) const
+		/// @brief	Gibt die Anzahl der per CallAllQueued() zugestellten Ereignisse zurück, bei denen der
+		///			angegebene Callback eine Exception geworfen hat.
+		/// @param handle	Callback-Handle
+		/// @return			Anzahl fehlgeschlagener Zustellungen, 0 bei ungültigem Handle
+		[[nodiscard]] size_t NumFailedQueuedCalls(CallbackHandle handle) const
 		{
-			//_ASSERT(false); // not tested
-			std::lock_guard lock(mMutex);
-			return (handle >= 0) && (handle < mCallbacks.size()) && (mCallbacks[handle].has_value());
+			const ListGuard		pCallbacks	= ReadList();
+			const MailboxType*	pMailbox	= FindMailbox(*pCallbacks, handle);
+			return (pMailbox != nullptr) ? pMailbox->NumFailed() : 0;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft, das Callback-Objekt mit dem angegebenen Handle asynchron aufgerufen und
-		///			noch nicht zurckgekehrt ist.
-		/// @param handle	Callback-Handle dessen Status berprft wird
-		/// @return			true, wenn ein asynchroner Aufruf des Callback-Objekt noch nicht abgeschlossen ist
-		[[nodiscard]] bool IsCallbackPending(int handle) const
+		/// @brief	Wartet, bis alle per CallAllQueued() abgelegten Ereignisse zugestellt sind.
+		/// @param timeoutMs [in]		Timeout in Millisekunden, -1, wenn kein Timeout verwendet werden soll.
+		/// @return						true, wenn alle Postfächer innerhalb der vorgegebenen Zeit geleert
+		///								wurden
+		bool WaitForMailboxesDrained(int timeoutMs = -1)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
+			using namespace std::chrono;
+			PendingOperationGuard						operationGuard(mNumPendingOperations);
+			const std::shared_ptr<const CallbackList>	pCallbacks	= Snapshot();
+			const steady_clock::time_point				deadline	= steady_clock::now() + milliseconds(timeoutMs);
+			bool										isIdle		= true;
 
-			std::lock_guard lock(mMutex);
-			if((handle >= 0) && (handle < mCallbacks.size()) && mCallbacks[handle].has_value())
-			{
-				return		mCallbackFutures[handle].valid() 
-						&&	(mCallbackFutures[handle].wait_for(0ms) != std::future_status::ready);
-			}
-			return false;
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot&, std::atomic<SlotDispatch*>& dispatch)
+				{
+					if(const MailboxType* pMailbox = FindMailbox(dispatch))
+					{
+						isIdle = isIdle && pMailbox->WaitUntilIdle((timeoutMs >= 0) ? &deadline : nullptr);
+					}
+				});
+			return isIdle;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft, ob mindestens ein Callback-Objekt asynchron aufgerufen aber noch nicht
-		///			zurckgekehrt ist.
-		/// @remark	Whrend hier auf den Abschluss aller asynchron aufgerufenen Callbacks gewartet wird
-		///			blockieren alle brigen Schnittstellenmethoden auer IsPendingOperation().
-		/// @return			true, wenn mindestens ein asynchron aufgerufenens Callback-Objekt noch 
-		///					nicht zurckgekehrt ist
-		[[nodiscard]] bool IsAnyCallbackPending() const
+		/// @brief Ruft jeden angemeldeten Callback mit den übergebenen Argumenten über den ThreadPool auf.
+		/// @remark				Wenn ein asynchron aufgerufener Callback noch nicht wieder zurückgekehrt
+		///						ist, wird er in diesem Aufruf nicht direkt erneut aufgerufen, da
+		///						CallAllAsync() sonst blockieren würde. Das Ereignis wird gemäß der
+		///						AsyncOverrunPolicy (siehe SetAsyncOverrunOptions()) verworfen oder
+		///						eingereiht, ohne dass der Aufrufer wartet.
+		///						Die Aufrufe laufen über den Executor des CallbackHandlers, das Objekt für
+		///						den Abschluss eines Aufrufs wird je Callback wiederverwendet.
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		/// @return				true, noch nicht zurückgekehrte Callbacks werden übersprungen und nicht als
+		///						Fehler gewertet.
+		bool CallAllAsync(const Args&... args)
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono_literals;
+			const std::shared_ptr<const CallbackList>	pCallbacks	= Snapshot();
+			SharedArguments								pArgs;
 
-			std::lock_guard lock(mMutex);
-			const size_t	numAvailableCallbacks	= mCallbacks.size();
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
+				{
+					CountOverrun(DispatchOf(slot, dispatch).GetAsyncCall().TryStart(*mExecutor, pCallbacks, pCallbacks->asyncOverrun,
+																				 LazyArguments(pArgs, args...)));
+				});
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt fest, wie CallAllAsync() mit einem Callback verfährt, dessen vorheriger
+		///			asynchroner Aufruf noch nicht zurückgekehrt ist.
+		/// @remark	Die Einstellung wird wie die Callback-Liste veröffentlicht und gilt ab dem nächsten
+		///			CallAllAsync()-Aufruf. Bereits eingereihte Ereignisse werden weiterhin zugestellt.
+		/// @param options		Policy und deren Parameter
+		void SetAsyncOverrunOptions(const AsyncOverrunOptions& options)
+		{
+			//_ASSERT(false); // not tested
+			std::lock_guard	lock(mMutex);
+			auto			pNewCallbacks = std::make_shared<CallbackList>(*mpOwnedCallbackList);
+
+			pNewCallbacks->asyncOverrun = options;
+			PublishList(std::move(pNewCallbacks));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die aktuelle Einstellung für CallAllAsync() zurück.
+		[[nodiscard]] AsyncOverrunOptions GetAsyncOverrunOptions() const
+		{
+			return ReadList()->asyncOverrun;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der Ereignisse von CallAllAsync() zurück, die ein noch nicht
+		///			zugestelltes Ereignis ersetzt haben (AsyncOverrunPolicy::Coalesce).
+		[[nodiscard]] size_t NumCoalescedAsyncCalls() const
+		{
+			return mNumCoalescedAsyncCalls.load(std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der von CallAllAsync() für einzelne Callbacks verworfenen Ereignisse
+		///			zurück.
+		[[nodiscard]] size_t NumDroppedAsyncCalls() const
+		{
+			return mNumDroppedAsyncCalls.load(std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wie CallAllAsync(), gibt zusätzlich ein Objekt zurück, über das auf den Abschluss der
+		///			in dieser Runde gestarteten Aufrufe gewartet werden kann (WaitAll(), WaitAny(),
+		///			OnComplete()).
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		/// @return				Abschluss-Tracker der Runde, nie nullptr
+		[[nodiscard]] std::shared_ptr<AsyncCompletion> CallAllAsyncTracked(const Args&... args)
+		{
+			//_ASSERT(false); // not tested
+			const std::shared_ptr<const CallbackList>	pCallbacks	= Snapshot();
+			SharedArguments								pArgs;
+			auto										pCompletion	= std::make_shared<AsyncCompletion>();
+
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
+				{
+					CountOverrun(DispatchOf(slot, dispatch).GetAsyncCall().TryStart(*mExecutor, pCallbacks, pCallbacks->asyncOverrun,
+																				 LazyArguments(pArgs, args...), pCompletion));
+				});
+			pCompletion->Seal();
+			return pCompletion;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft alle angemeldeten Callbacks auf und setzt die erwartende Coroutine fort, wenn alle
+		///			abgeschlossen sind: co_await handler.CallAllAwaitable(args...);
+		/// @remark	Als Coroutine angemeldete Callbacks werden nacheinander gestartet und laufen bis zu ihrem
+		///			ersten Unterbrechungspunkt im aufrufenden Thread, danach dort, wo sie fortgesetzt
+		///			werden (z.B. co_await ResumeOn(executor)). Während sie warten, belegen sie keinen
+		///			Thread. Gewöhnliche Callbacks werden direkt aufgerufen, an eine andere EventLoop
+		///			gebundene Callbacks werden dort eingestellt und nicht abgewartet.
+		///			Die erwartende Coroutine wird im Thread der zuletzt abgeschlossenen Coroutine
+		///			fortgesetzt. Die Argumente werden einmalig kopiert und bleiben bis dahin gültig.
+		///			Alle Callbacks werden aufgerufen, die erste Exception wird beim Fortsetzen geworfen.
+		/// @param ...args		Variable Argumentenliste, deren Anzahl und Typ mit dem Template-Parametern
+		///						von CallbackHandler<... Args> übereinstimmen muss.
+		/// @return				Awaitable der Runde
+		[[nodiscard]] CallAllAwaiter CallAllAwaitable(const Args&... args)
+		{
+			//_ASSERT(false); // not tested
+			auto pState = std::make_shared<AwaitState>();
+			pState->pCallbacks	= Snapshot();
+			pState->pArgs		= std::make_shared<const ArgumentTuple>(args...);
+			return CallAllAwaiter(*this, std::move(pState));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt ein neues aufrufbares Objekt der internen Callback-Liste hinzu.
+		/// @remark	Als aufrufbare Objekte können (Member-)Funktionen, Lambdas, std::function<void(...)
+		///			und Klassenobjekte von Klassen, die den entsprechenden function call operator(...)
+		///			definieren, verwendet werden.
+		///			Laufende CallAll()-Aufrufe werden nicht abgewartet, der neue Callback wird ab dem
+		///			nächsten Aufruf berücksichtigt.
+		/// @param callback			aufrufbares Objekt ()
+		/// @param mailboxOptions	Größe und Überlauf-Policy des Postfachs für CallAllQueued()
+		/// @return					Handle des hinzugefügten Callbacks, über den "callback" mit
+		///							RemoveCallback() wieder entfernt werden kann.
+		[[nodiscard]] CallbackHandle AddCallback(CallbackType callback, const MailboxOptions& mailboxOptions = {})
+		{
+			//_ASSERT(false); // not tested
+			return AddSlot(std::move(callback), nullptr, mailboxOptions, nullptr);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt ein neues aufrufbares Objekt der internen Callback-Liste hinzu, das immer im
+		///			Thread der angegebenen EventLoop aufgerufen wird.
+		/// @remark	Erfolgt ein CallAllXXX()-Aufruf im Thread der Schleife, wird der Callback dort direkt
+		///			aufgerufen. Aus anderen Threads wird der Aufruf über das Postfach des Callbacks in die
+		///			Schleife eingestellt (siehe MailboxOverflowPolicy), CallAll() und die anderen
+		///			synchronen Methoden warten dann nicht auf den Aufruf und melden keine Exceptions.
+		///			Fehlgeschlagene Aufrufe zählt NumFailedQueuedCalls(), auch CallAllAsync() stellt in
+		///			die Schleife ein.
+		/// @param callback			aufrufbares Objekt
+		/// @param loop				Schleife, die alle Aufrufe ausführt. Muss den Callback überleben und
+		///							bis zum Entfernen des Callbacks abgearbeitet werden.
+		/// @param mailboxOptions	Größe und Überlauf-Policy des Postfachs
+		/// @return					Handle des hinzugefügten Callbacks, über den "callback" mit
+		///							RemoveCallback() wieder entfernt werden kann.
+		[[nodiscard]] CallbackHandle AddCallback(CallbackType callback, EventLoop& loop, const MailboxOptions& mailboxOptions = {})
+		{
+			//_ASSERT(false); // not tested
+			return AddSlot(std::move(callback), nullptr, mailboxOptions, &loop);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt einen als Coroutine implementierten Callback (Rückgabetyp CallbackTask) der
+		///			internen Callback-Liste hinzu.
+		/// @remark	CallAllAwaitable() wartet auf den Abschluss der Coroutine, ohne einen Thread zu
+		///			blockieren. Mit CallAllAsync(), CallAllAsyncTracked() und CallAllQueued() gilt der
+		///			Aufruf erst mit dem Ende der Coroutine als abgeschlossen, ohne dass ein Worker wartet.
+		///			Die synchronen Methoden (CallAll(), CallAllBatch(), CallAllParallel() usw.) weisen den
+		///			Callback mit std::logic_error ab: Ein blockierendes Warten würde den Executor
+		///			verklemmen, sobald die Coroutine dort fortgesetzt wird.
+		/// @param callback			aufrufbares Objekt, das einen CallbackTask zurückgibt
+		/// @param mailboxOptions	Größe und Überlauf-Policy des Postfachs für CallAllQueued()
+		/// @return					Handle des hinzugefügten Callbacks, über den "callback" mit
+		///							RemoveCallback() wieder entfernt werden kann.
+		template <class Callback>
+			requires std::is_same_v<std::invoke_result_t<Callback&, const Args& ...>, CallbackTask>
+		[[nodiscard]] CallbackHandle AddCallback(Callback&& callback, const MailboxOptions& mailboxOptions = {})
+		{
+			//_ASSERT(false); // not tested
+			return AddSlot(nullptr, TaskCallbackType(std::forward<Callback>(callback)), mailboxOptions, nullptr);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt einen Callback mit der angegebenen Priorität in die Prioritätskette ein, die von
+		///			CallUntilStop() durchlaufen wird.
+		/// @remark	Callbacks höherer Priorität werden zuerst aufgerufen, bei gleicher Priorität in der
+		///			Reihenfolge der Anmeldung. Eine Änderung der Kette kopiert diese, gewöhnliche
+		///			Callbacks teilen sich die Kette ohne Kopie.
+		/// @param callback		aufrufbares Objekt, das CallbackResult::Continue oder CallbackResult::Stop
+		///						zurückgibt
+		/// @param priority		Priorität, z.B. hoch für günstige Filter, die die meisten Ereignisse abweisen
+		/// @return				Handle des hinzugefügten Callbacks, über den "callback" mit
+		///						RemoveCallback() wieder entfernt werden kann.
+		[[nodiscard]] CallbackHandle AddPriorityCallback(PriorityCallbackType callback, int priority)
+		{
+			//_ASSERT(false); // not tested
+			std::lock_guard			lock(mMutex);
+			const CallbackHandle	handle = AllocateHandle();
 
-			for(size_t i = 0; i < numAvailableCallbacks; i++)
+			PublishModifiedChain([&](PriorityChain& chain)
+				{
+					// hinter allen Einträgen gleicher oder höherer Priorität einfügen
+					const auto it = std::upper_bound(chain.begin(), chain.end(), priority,
+						[](int newPriority, const PriorityEntry& entry) { return newPriority > entry.priority; });
+					chain.insert(it, PriorityEntry{ std::move(callback), priority, handle });
+				});
+			return handle;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entfernt das Callback-Objekt mit dem angegebenen Handle aus der internen Callback-Liste
+		/// @remark	Ein gleichzeitig laufender CallAll()-Aufruf kann den Callback noch aufrufen.
+		///			Darf auch aus einem Callback desselben Handlers aufgerufen werden. Entfernt sich ein per
+		///			CallAllAsync() aufgerufener Callback selbst, wird nicht auf dessen Abschluss gewartet
+		///			und das Ergebnis verworfen.
+		/// @param handle		Handle des Callback-Objekts, das entfernt werden soll
+		/// @return				true, wenn ein Callback-Objekt mit dem angegebenen Handle existierte.
+		bool RemoveCallback(CallbackHandle handle)
+		{
+			//_ASSERT(false); // not tested
+			std::shared_ptr<const CallbackList>	pRemovedFrom;	// hält den SlotDispatch des Slots am Leben
+			AsyncCallType*						pRemoved	= nullptr;
 			{
-				if(mCallbacks[i].has_value())
+				std::lock_guard lock(mMutex);
+				const CallbackList&	callbacks	= *mpOwnedCallbackList;
+				const uint32_t		index		= static_cast<uint32_t>(handle);
+				SlotBlock* const	pBlock		= FindBlock(callbacks, handle);
+				if(pBlock == nullptr)
 				{
-					if(mCallbackFutures[i].valid() && (mCallbackFutures[i].wait_for(0ms) != std::future_status::ready))
+					if(FindPriorityEntry(callbacks, handle) == nullptr)
 					{
-						return true;
+						return false;
 					}
+					PublishModifiedChain([handle](PriorityChain& chain)
+						{
+							std::erase_if(chain, [handle](const PriorityEntry& entry) { return entry.handle == handle; });
+						});
+					mFreeSlots.push_back(index);
+					return true;
 				}
+				// Bit löschen, der Slot wird über den Friedhof der bisherigen Liste freigegeben
+				pBlock->liveMask.fetch_and(~(uint64_t(1) << (index%SlotsPerBlock)), std::memory_order_seq_cst);
+				if(const SlotDispatch* pDispatch = pBlock->dispatch[index%SlotsPerBlock].load(std::memory_order_acquire))
+				{
+					pRemoved = pDispatch->FindAsyncCall();
+				}
+				callbacks.pGraveyard->Add(index);
+				pRemovedFrom = mpOwnedCallbackList;
+				PublishList(std::make_shared<CallbackList>(callbacks));
 			}
-			return false;
+			if((pRemoved == nullptr) || pRemoved->IsRunningOnCurrentThread())
+			{
+				return true; // nie asynchron aufgerufen bzw. Aufruf aus dem eigenen asynchronen Aufruf, der Schnappschuss hält ihn am Leben
+			}
+			_ASSERT(!pRemoved->IsPending());
+			if(pRemoved->HasResult())
+			{
+				pRemoved->Get();
+			}
+			return true;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Wartet bis alle registrierten Callbacks, die ggf. mittels CallAllAsync() ber den
-		///			Threadpool aufgrufen wurde, abgeschlossen sind.
-		/// @remark	Whrend hier auf den Abschluss aller asynchron aufgerufenen Callbacks gewartet wird
-		///			blockieren alle brigen Schnittstellenmethoden auer IsPendingOperation().
-		/// @param handleException [in]	true, Callback-Ausnahmen, gefangen werden sollen
-		/// @param timeoutMs [in]		Timeout in Millisekunden, bis dieser Aufruf sptestens zurckkert.
-		///								-1, wenn kein Timout verwendet werden soll.
-		/// @return						true, wenn alle Callbacks innerhalb der vorgegebenen Zeit 
-		///								fehlerfrei abgeschlossen wurden, sonst false
-		bool WaitForAsyncCallbacksFinished(bool handleException, int timeoutMs = -1)
+		/// @brief	Entfernt alle Callback-Objekte aus der internen Callback-Liste
+		void RemoveAllCallbacks()
 		{
 			//_ASSERT(false); // not tested
-			using namespace std::chrono;
-			bool isSuccess = true;
-
-			if(timeoutMs > 0)
+			std::shared_ptr<const CallbackList>	pRemovedFrom;	// hält die SlotDispatch der Slots am Leben
+			std::vector<const AsyncCallType*>	removedCalls;
 			{
-				auto			startTime	 = high_resolution_clock::now();
-				milliseconds	remainingMs { timeoutMs };
-
 				std::lock_guard		lock(mMutex);
-				AtomicStateGuard	stateGuard(mIsPendingOperation);
-				const size_t		numAvailableCallbacks = mCallbacks.size();
+				const CallbackList&	callbacks	= *mpOwnedCallbackList;
+				const BlockList&	blocks		= *callbacks.pBlocks;
+				auto				pEmpty		= std::make_shared<CallbackList>();
 
-				for(size_t i = 0; i < numAvailableCallbacks; i++)
+				// alle Bits löschen, die Slots werden über den Friedhof der bisherigen Liste freigegeben,
+				// die Generationen bleiben erhalten
+				for(size_t blockIndex = 0; blockIndex < blocks.size(); blockIndex++)
 				{
-					if(mCallbacks[i].has_value() && mCallbackFutures[i].valid())
+					SlotBlock& block = *blocks[blockIndex];
+					for(uint64_t liveMask = block.liveMask.exchange(0, std::memory_order_seq_cst); liveMask != 0; liveMask &= liveMask - 1)
 					{
-						if((mCallbackFutures[i].wait_for(milliseconds(timeoutMs)) == std::future_status::ready))
+						const size_t slotIndex = static_cast<size_t>(std::countr_zero(liveMask));
+						callbacks.pGraveyard->Add(static_cast<uint32_t>(blockIndex*SlotsPerBlock + slotIndex));
+						const SlotDispatch* const pDispatch = block.dispatch[slotIndex].load(std::memory_order_acquire);
+						if((pDispatch != nullptr) && (pDispatch->FindAsyncCall() != nullptr))
 						{
-							try
-							{
-								mCallbackFutures[i].get(); // prfen, ob Exception in Callback aufgetreten ist
-							}
-							catch(const std::exception&)
-							{
-								if(!handleException)
-								{
-									throw;
-								}
-								isSuccess &= false;
-							}
+							removedCalls.push_back(pDispatch->FindAsyncCall());
 						}
-						else
-						{
-							isSuccess &= false;
-						}
-						remainingMs -= duration_cast<milliseconds>(high_resolution_clock::now() - startTime);
 					}
-					if(remainingMs.count() <= 0)
+				}
+				// Indizes der Kette sind sofort frei, da die Kette selbst kopiert wird
+				if(callbacks.pPriorityChain != nullptr)
+				{
+					for(const PriorityEntry& entry : *callbacks.pPriorityChain)
 					{
-						break;
+						mFreeSlots.push_back(static_cast<uint32_t>(entry.handle));
 					}
 				}
+				pEmpty->pBlocks			= callbacks.pBlocks;
+				pEmpty->asyncOverrun	= callbacks.asyncOverrun;
+				pRemovedFrom = mpOwnedCallbackList;
+				PublishList(std::move(pEmpty));
 			}
-			else
+			bool isAnyPending = false;
+			for(const AsyncCallType* pRemoved : removedCalls)
 			{
-				std::lock_guard		lock(mMutex);
-				AtomicStateGuard	stateGuard(mIsPendingOperation);
-				const size_t		numAvailableCallbacks = mCallbacks.size();
+				isAnyPending |= pRemoved->IsPending() && !pRemoved->IsRunningOnCurrentThread();
+			}
+			_ASSERT(!isAnyPending);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der intern verwalteten Callback-Objekte zurück.
+		/// @return			Anzahl der intern verwalteten Callback-Objekte.
+		[[nodiscard]] size_t Size() const
+		{
+			const ListGuard pCallbacks = ReadList();
+			return NumCallbacks(*pCallbacks) + ((pCallbacks->pPriorityChain != nullptr) ? pCallbacks->pPriorityChain->size() : 0);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft (NICHT blockierend), ob die Schnittstelle für unbestimmte Zeit blockiert ist.
+		/// @remark	Gilt für synchrone CallAll()- und WaitForXXX-Methoden, die für umbestimmte Zeit
+		///			blockieren können. Laufende CallAll()-Aufrufe werden über die HazardPointer-Slots aller
+		///			Threads erkannt, die Abfrage ist daher deutlich teurer als ein Aufruf.
+		/// @return			true, wenn die Schnittstelle für umbestimmte Zeit blockiert ist.
+		[[nodiscard]] bool IsPendingOperation() const
+		{
+			return (mNumPendingOperations.load(std::memory_order_relaxed) != 0) || ListGuard::IsOwnerActive(this);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Prüft, ob das Callback-Handle auf ein gültiges Callback-Objekt verweist.
+		/// @param handle	Callback-Handle dessen Gültigkeit überprüft wird
+		/// @return			true, wenn das Callback-Handle auf ein gültiges Callback-Objekt verweist
+		[[nodiscard]] bool IsCallbackHandleValid(CallbackHandle handle) const
+		{
+			//_ASSERT(false); // not tested
+			const ListGuard pCallbacks = ReadList();
+			return (FindSlot(*pCallbacks, handle) != nullptr) || (FindPriorityEntry(*pCallbacks, handle) != nullptr);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, das Callback-Objekt mit dem angegebenen Handle asynchron aufgerufen und
+		///			noch nicht zurückgekehrt ist.
+		/// @param handle	Callback-Handle dessen Status überprüft wird
+		/// @return			true, wenn ein asynchroner Aufruf des Callback-Objekt noch nicht abgeschlossen ist
+		[[nodiscard]] bool IsCallbackPending(CallbackHandle handle) const
+		{
+			//_ASSERT(false); // not tested
+			const ListGuard			pCallbacks	= ReadList();
+			const AsyncCallType*	pAsyncCall	= FindAsyncCall(*pCallbacks, handle);
+			return (pAsyncCall != nullptr) && pAsyncCall->IsPending();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob mindestens ein Callback-Objekt asynchron aufgerufen aber noch nicht
+		///			zurückgekehrt ist.
+		/// @return			true, wenn mindestens ein asynchron aufgerufenens Callback-Objekt noch
+		///					nicht zurückgekehrt ist
+		[[nodiscard]] bool IsAnyCallbackPending() const
+		{
+			//_ASSERT(false); // not tested
+			bool isAnyPending = false;
+			ForEachSlot(*ReadList(), [&](const CallbackSlot&, std::atomic<SlotDispatch*>& dispatch)
+				{
+					const AsyncCallType* const pAsyncCall = FindAsyncCall(dispatch);
+					isAnyPending = isAnyPending || ((pAsyncCall != nullptr) && pAsyncCall->IsPending());
+				});
+			return isAnyPending;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet bis alle registrierten Callbacks, die ggf. mittels CallAllAsync() über den
+		///			Threadpool aufgrufen wurde, abgeschlossen sind.
+		/// @remark	Der Timeout gilt für den gesamten Aufruf, nicht je Callback. Es wird keine Sperre
+		///			gehalten, AddCallback() und RemoveCallback() blockieren nicht.
+		///			Zum Warten auf eine bestimmte Runde siehe CallAllAsyncTracked().
+		/// @param handleException [in]	true, Callback-Ausnahmen, gefangen werden sollen
+		/// @param timeoutMs [in]		Timeout in Millisekunden, bis dieser Aufruf spätestens zurückkert.
+		///								-1, wenn kein Timout verwendet werden soll.
+		/// @return						true, wenn alle Callbacks innerhalb der vorgegebenen Zeit
+		///								fehlerfrei abgeschlossen wurden, sonst false
+		bool WaitForAsyncCallbacksFinished(bool handleException, int timeoutMs = -1)
+		{
+			//_ASSERT(false); // not tested
+			using namespace std::chrono;
+			PendingOperationGuard						operationGuard(mNumPendingOperations);
+			const std::shared_ptr<const CallbackList>	pCallbacks	= Snapshot();
+			const auto									deadline	= steady_clock::now() + milliseconds((std::max)(timeoutMs, 0));
+			bool										isSuccess	= true;
 
-				for(size_t i = 0; i < numAvailableCallbacks; i++)
+			ForEachSlot(*pCallbacks, [&](const CallbackSlot&, std::atomic<SlotDispatch*>& dispatch)
 				{
-					if(mCallbacks[i].has_value() && mCallbackFutures[i].valid())
+					if(AsyncCallType* pAsyncCall = FindAsyncCall(dispatch))
 					{
-						try
-						{
-							mCallbackFutures[i].get(); // prfen, ob Exception in Callback aufgetreten ist
-						}
-						catch(const std::exception&)
-						{
-							if(!handleException)
-							{
-								throw;
-							}
-							isSuccess &= false;
-						}
+						isSuccess &= WaitForResult(*pAsyncCall, handleException, (timeoutMs > 0), deadline);
 					}
-				}
-			}
+				});
 			return isSuccess;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Wartet bis alle registrierten Callbacks, die ggf. mittels CallAllAsync() ber den
+		/// @brief	Wartet bis alle registrierten Callbacks, die ggf. mittels CallAllAsync() über den
 		///			Threadpool aufgrufen wurde, abgeschlossen sind.
-		/// @remark	Whrend hier auf den Abschluss des asynchron aufgerufenen Callbacks gewartet wird
-		///			blockieren alle brigen Schnittstellenmethoden, auer IsPendingOperation().
+		/// @remark	Es wird keine Sperre gehalten, AddCallback() und RemoveCallback() blockieren nicht.
 		/// @param handle [in]			Handle des Callback, auf dessen Abschluss gewartet wird.
 		/// @param handleException [in]	true, wenn Callback-Ausnahmen gefangen werden sollen.
-		/// @param timeoutMs [in]		Timeout in Millisekunden, bis dieser Aufruf sptestens zurckkert.
+		/// @param timeoutMs [in]		Timeout in Millisekunden, bis dieser Aufruf spätestens zurückkert.
 		///								-1, wenn kein Timout verwendet werden soll.
-		/// @return						true, wenn der angegebene Callback innerhalb der vorgegebenen Zeit 
+		/// @return						true, wenn der angegebene Callback innerhalb der vorgegebenen Zeit
 		///								fehlerfrei abgeschlossen werden konnte
-		bool WaitForAsyncCallbackFinished(int handle, bool handleException, int timeoutMs = -1)
+		bool WaitForAsyncCallbackFinished(CallbackHandle handle, bool handleException, int timeoutMs = -1)
 		{
 			//_ASSERT(false); // not tested
 			using namespace std::chrono;
+			PendingOperationGuard						operationGuard(mNumPendingOperations);
+			const std::shared_ptr<const CallbackList>	pCallbacks	= Snapshot();	// hält den asynchronen Aufruf am Leben
+			AsyncCallType* const						pEntry		= FindAsyncCall(*pCallbacks, handle);
+			const auto									deadline	= steady_clock::now() + milliseconds((std::max)(timeoutMs, 0));
 
-			std::lock_guard		lock(mMutex);
-			AtomicStateGuard	stateGuard(mIsPendingOperation);
-			bool				isSuccess = true;
+			return (pEntry == nullptr) || WaitForResult(*pEntry, handleException, (timeoutMs > 0), deadline);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Laufzeitstatistik des angegebenen Callbacks zurück (nur mit ProfilingPolicy).
+		/// @remark	Erfasst werden die Aufrufe über alle CallAllXXX()-Methoden. Während gleichzeitiger
+		///			Aufrufe sind die einzelnen Werte nicht zwingend untereinander konsistent.
+		/// @param handle	Callback-Handle
+		/// @return			Statistik, kein Wert bei ungültigem Handle
+		[[nodiscard]] std::optional<CallbackProfile> GetCallbackProfile(CallbackHandle handle) const
+			requires IsProfilingEnabled
+		{
+			//_ASSERT(false); // not tested
+			const ListGuard		pCallbacks	= ReadList();
+			const CallbackSlot*	pSlot		= FindSlot(*pCallbacks, handle);
+			return (pSlot != nullptr) ? std::optional(pSlot->pProfile->Get()) : std::nullopt;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt das Zeitbudget eines Aufrufs des angegebenen Callbacks fest (nur mit ProfilingPolicy).
+		/// @remark	Dauert ein Aufruf länger, wird der per SetSlowCallbackHook() gesetzte Hook aufgerufen.
+		/// @param handle	Callback-Handle
+		/// @param budget	max. Laufzeit eines Aufrufs, 0: keine Überwachung
+		/// @return			false bei ungültigem Handle
+		bool SetCallbackBudget(CallbackHandle handle, std::chrono::nanoseconds budget)
+			requires IsProfilingEnabled
+		{
+			//_ASSERT(false); // not tested
+			const ListGuard		pCallbacks	= ReadList();
+			const CallbackSlot*	pSlot		= FindSlot(*pCallbacks, handle);
+			if(pSlot == nullptr)
+			{
+				return false;
+			}
+			pSlot->pProfile->SetBudget(budget);
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt die Funktion fest, die aufgerufen wird, wenn ein Callback sein Zeitbudget
+		///			überschreitet (nur mit ProfilingPolicy).
+		/// @remark	Der Hook läuft direkt nach dem langsamen Aufruf im selben Thread, ggf. gleichzeitig in
+		///			mehreren Threads. Exceptions des Hooks werden ignoriert.
+		/// @param hook		Funktion mit Handle und Laufzeit des Aufrufs, nullptr entfernt den Hook
+		void SetSlowCallbackHook(SlowCallbackHook hook)
+			requires IsProfilingEnabled
+		{
+			//_ASSERT(false); // not tested
+			std::shared_ptr<const SlowCallbackHook> pHook;
+			if(hook)
+			{
+				pHook = std::make_shared<const SlowCallbackHook>(std::move(hook));
+			}
+			mpSlowCallbackHook->store(std::move(pHook), std::memory_order_release);
+		}
 
-			if(		(handle >= 0)
-				&&	(handle < mCallbacks.size()) 
-				&&	mCallbacks[handle].has_value()
-				&&	mCallbackFutures[handle].valid())
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Gibt einen Anteil am aktuellen Schnappschuss der Callback-Liste zurück (für Aufrufe, die die
+		/// Liste über das Ende der Methode hinaus benötigen)
+		std::shared_ptr<const CallbackList> Snapshot() const
+		{
+			return ReadList()->shared_from_this();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Schützt den aktuellen Schnappschuss der Callback-Liste bis zum Ende des Gültigkeitsbereichs
+		ListGuard ReadList() const
+		{
+			return ListGuard(mpCallbackList);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Wie ReadList(), bis zum Ende des Gültigkeitsbereichs gibt IsPendingOperation() true zurück. Es
+		/// wird nur in den Slot des aufrufenden Threads geschrieben.
+		ListGuard ReadListForCall() const
+		{
+			return ListGuard(mpCallbackList, this);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Ruft "callback" des Slots auf, mit ProfilingPolicy wird dabei die Laufzeit erfasst. Als
+		/// Coroutine angemeldete Callbacks (leerer "callback") werden mit std::logic_error abgewiesen
+		/// (siehe AddCallback()).
+		static void Invoke(const CallbackSlot& slot, const CallbackType& callback, const Args& ... args)
+		{
+			if constexpr(IsProfilingEnabled)
+			{
+				const typename ProfileRecorder::Scope scope(*slot.pProfile);
+				InvokeCallback(callback, args...);
+			}
+			else
+			{
+				InvokeCallback(callback, args...);
+			}
+		}
+		static void InvokeCallback(const CallbackType& callback, const Args& ... args)
+		{
+			if(callback)
+			{
+				callback(args...);
+			}
+			else
+			{
+				throw std::logic_error("BasicCallbackHandler: Coroutine-Callbacks nur über CallAllAwaitable(), CallAllAsync() oder CallAllQueued() aufrufen");
+			}
+		}
+		static void Invoke(const CallbackSlot& slot, const CallbackType& callback, const ArgumentTuple& args)
+		{
+			std::apply([&slot, &callback](const auto& ... unpacked) { Invoke(slot, callback, unpacked...); }, args);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Legt das Objekt beim ersten Bedarf an, gleichzeitig angelegte Objekte werden verworfen
+		template <class T, class ... CtorArgs>
+		static T& GetOrCreate(std::atomic<T*>& pObject, const CtorArgs& ... ctorArgs)
+		{
+			T* pCurrent = pObject.load(std::memory_order_acquire);
+			if(pCurrent == nullptr)
 			{
-				if(timeoutMs > 0)
+				T* const pNew = new T(ctorArgs...);
+				if(pObject.compare_exchange_strong(pCurrent, pNew, std::memory_order_acq_rel, std::memory_order_acquire))
 				{
-					isSuccess = (mCallbackFutures[handle].wait_for(milliseconds(timeoutMs)) == std::future_status::ready);
-					if(isSuccess)
-					{
-						try
-						{
-							mCallbackFutures[handle].get(); // prfen, ob Exception in Callback aufgetreten ist
-						}
-						catch(const std::exception&)
-						{
-							if(!handleException)
-							{
-								throw;
-							}
-							isSuccess = false;
-						}
-					}
+					return *pNew;
+				}
+				delete pNew;
+			}
+			return *pCurrent;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt die selten benötigten Daten des Slots zurück und legt sie beim ersten Bedarf an
+		static SlotDispatch& DispatchOf(const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
+		{
+			return GetOrCreate(dispatch, slot);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt den asynchronen Aufruf bzw. das Postfach des Slots zurück, nullptr, wenn nie verwendet
+		static AsyncCallType* FindAsyncCall(const std::atomic<SlotDispatch*>& dispatch)
+		{
+			const SlotDispatch* const pDispatch = dispatch.load(std::memory_order_acquire);
+			return (pDispatch != nullptr) ? pDispatch->FindAsyncCall() : nullptr;
+		}
+		static MailboxType* FindMailbox(const std::atomic<SlotDispatch*>& dispatch)
+		{
+			const SlotDispatch* const pDispatch = dispatch.load(std::memory_order_acquire);
+			return (pDispatch != nullptr) ? pDispatch->FindMailbox() : nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Wie oben, zum Handle (nullptr, wenn das Handle ungültig oder veraltet ist)
+		static AsyncCallType* FindAsyncCall(const CallbackList& callbacks, CallbackHandle handle)
+		{
+			SlotBlock* const pBlock = FindBlock(callbacks, handle);
+			return (pBlock != nullptr) ? FindAsyncCall(pBlock->dispatch[static_cast<uint32_t>(handle)%SlotsPerBlock]) : nullptr;
+		}
+		static MailboxType* FindMailbox(const CallbackList& callbacks, CallbackHandle handle)
+		{
+			SlotBlock* const pBlock = FindBlock(callbacks, handle);
+			return (pBlock != nullptr) ? FindMailbox(pBlock->dispatch[static_cast<uint32_t>(handle)%SlotsPerBlock]) : nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt den Block des belegten Slots zum Handle zurück bzw. nullptr, wenn das Handle ungültig oder
+		/// veraltet ist. Die Generation wird erst nach dem Bit gelesen, das den Slot veröffentlicht.
+		static SlotBlock* FindBlock(const CallbackList& callbacks, CallbackHandle handle)
+		{
+			if(handle < 0)
+			{
+				return nullptr;
+			}
+			const uint32_t	index		= static_cast<uint32_t>(handle);
+			const uint32_t	generation	= static_cast<uint32_t>(handle >> 32);
+			const size_t	blockIndex	= index/SlotsPerBlock;
+			const size_t	slotIndex	= index%SlotsPerBlock;
+			if(blockIndex >= callbacks.pBlocks->size())
+			{
+				return nullptr;
+			}
+			SlotBlock&	block	= *(*callbacks.pBlocks)[blockIndex];
+			const bool	isLive	= (block.liveMask.load(std::memory_order_acquire) & (uint64_t(1) << slotIndex)) != 0;
+			return (isLive && (block.slots[slotIndex].generation == generation)) ? &block : nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt den belegten Slot zum Handle zurück bzw. nullptr, wenn das Handle ungültig oder veraltet ist
+		static const CallbackSlot* FindSlot(const CallbackList& callbacks, CallbackHandle handle)
+		{
+			const SlotBlock* const pBlock = FindBlock(callbacks, handle);
+			return (pBlock != nullptr) ? &pBlock->slots[static_cast<uint32_t>(handle)%SlotsPerBlock] : nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt den Eintrag der Prioritätskette zum Handle zurück bzw. nullptr
+		static const PriorityEntry* FindPriorityEntry(const CallbackList& callbacks, CallbackHandle handle)
+		{
+			if((handle < 0) || (callbacks.pPriorityChain == nullptr))
+			{
+				return nullptr;
+			}
+			const auto it = std::find_if(callbacks.pPriorityChain->begin(), callbacks.pPriorityChain->end(),
+										 [handle](const PriorityEntry& entry) { return entry.handle == handle; });
+			return (it != callbacks.pPriorityChain->end()) ? &*it : nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Ruft func(slot, dispatch) für jeden belegten Slot in der Reihenfolge der Slot-Indizes auf,
+		/// freie Slots werden über die Belegungsmaske übersprungen. Die Maske eines Blocks wird einmal
+		/// gelesen (acquire), danach sind die Daten der gesetzten Slots sichtbar.
+		template <class Func>
+		static void ForEachSlot(const CallbackList& callbacks, Func&& func)
+		{
+			for(const std::shared_ptr<SlotBlock>& pBlock : *callbacks.pBlocks)
+			{
+				for(uint64_t liveMask = pBlock->liveMask.load(std::memory_order_acquire); liveMask != 0; liveMask &= liveMask - 1)
+				{
+					const size_t slotIndex = static_cast<size_t>(std::countr_zero(liveMask));
+					func(std::as_const(pBlock->slots[slotIndex]), pBlock->dispatch[slotIndex]);
 				}
-				else
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Anzahl der belegten Slots
+		static size_t NumCallbacks(const CallbackList& callbacks)
+		{
+			size_t numCallbacks = 0;
+			for(const std::shared_ptr<SlotBlock>& pBlock : *callbacks.pBlocks)
+			{
+				numCallbacks += static_cast<size_t>(std::popcount(pBlock->liveMask.load(std::memory_order_acquire)));
+			}
+			return numCallbacks;
+		}
+		static bool HasCallbacks(const CallbackList& callbacks)
+		{
+			return std::any_of(callbacks.pBlocks->begin(), callbacks.pBlocks->end(),
+							   [](const std::shared_ptr<SlotBlock>& pBlock) { return pBlock->liveMask.load(std::memory_order_acquire) != 0; });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Wartet (ggf. bis "deadline") auf das Ergebnis eines asynchronen Aufrufs und holt es ab
+		/// @return		false bei Timeout oder wenn der Callback eine Exception geworfen hat
+		static bool WaitForResult(AsyncCallType& asyncCall, bool handleException, bool hasDeadline,
+								  const std::chrono::steady_clock::time_point& deadline)
+		{
+			if(!asyncCall.HasResult() || asyncCall.IsRunningOnCurrentThread())
+			{
+				return true; // auf den eigenen Aufruf kann nicht gewartet werden
+			}
+			if(hasDeadline && !asyncCall.WaitUntil(deadline))
+			{
+				return false;
+			}
+			try
+			{
+				asyncCall.Get(); // prüfen, ob Exception in Callback aufgetreten ist
+			}
+			catch(const std::exception&)
+			{
+				if(!handleException)
 				{
-					try
+					throw;
+				}
+				return false;
+			}
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Im aufrufenden Thread aufzurufender Callback eines Slots für CallAllParallel()
+		struct LocalCall
+		{
+			const CallbackSlot*	pSlot;
+			const CallbackType*	pCallback;
+		};
+		///----------------------------------------------------------------------------------------------
+		/// Gibt die Aufrufe der belegten Slots in der Reihenfolge der Slot-Indizes zurück, die im
+		/// aufrufenden Thread erfolgen. An eine andere EventLoop gebundene Slots werden dort eingestellt.
+		std::vector<LocalCall> LocalCalls(const CallbackList& callbacks, const Args& ... args)
+		{
+			std::vector<LocalCall>	calls;
+			SharedArguments			pArgs;
+			calls.reserve(NumCallbacks(callbacks));
+			ForEachSlot(callbacks, [&](const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch)
+				{
+					if(slot.callback)
 					{
-						mCallbackFutures[handle].get(); // prfen, ob Exception in Callback aufgetreten ist
+						calls.push_back({ &slot, &slot.callback });
+						return;
 					}
-					catch(const std::exception&)
+					SlotDispatch& slotDispatch = *dispatch.load(std::memory_order_acquire);
+					if(slotDispatch.IsBoundToOtherThread())
 					{
-						if(!handleException)
-						{
-							throw;
-						}
-						isSuccess = false;
+						PostToLoop(callbacks, slotDispatch, LazyArguments(pArgs, args...));
+					}
+					else
+					{
+						calls.push_back({ &slot, &slotDispatch.Callback() });
 					}
+				});
+			return calls;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt den im aufrufenden Thread aufzurufenden Callback des Slots für CallAllBatch() zurück. Ist
+		/// der Slot an eine andere EventLoop gebunden, wird die Folge dort eingestellt (nullptr).
+		const CallbackType* LocalCallback(const CallbackList& callbacks, const CallbackSlot& slot,
+										  std::atomic<SlotDispatch*>& dispatch, std::span<const ArgumentTuple> batch)
+		{
+			if(slot.callback)
+			{
+				return &slot.callback;
+			}
+			SlotDispatch& slotDispatch = *dispatch.load(std::memory_order_acquire);
+			if(slotDispatch.IsBoundToOtherThread())
+			{
+				for(const ArgumentTuple& args : batch)
+				{
+					PostToLoop(callbacks, slotDispatch, std::make_shared<const ArgumentTuple>(args));
 				}
+				return nullptr;
+			}
+			return &slotDispatch.Callback();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Zählt ersetzte bzw. verworfene Ereignisse von CallAllAsync()
+		void CountOverrun(typename AsyncCallType::StartResult result)
+		{
+			if(result == AsyncCallType::StartResult::Coalesced)
+			{
+				mNumCoalescedAsyncCalls.fetch_add(1, std::memory_order_relaxed);
+			}
+			else if(result == AsyncCallType::StartResult::Dropped)
+			{
+				mNumDroppedAsyncCalls.fetch_add(1, std::memory_order_relaxed);
 			}
-			return isSuccess;
 		}
+		///----------------------------------------------------------------------------------------------
+		/// Kopiert die Argumente beim ersten Bedarf und gibt sie zurück
+		static const SharedArguments& LazyArguments(SharedArguments& pArgs, const Args& ... args)
+		{
+			if(pArgs == nullptr)
+			{
+				pArgs = std::make_shared<const ArgumentTuple>(args...);
+			}
+			return pArgs;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Ruft den Slot direkt auf bzw. stellt den Aufruf in dessen EventLoop ein. Gewöhnliche
+		/// Callbacks liegen im Slot, nur gebundene und Coroutine-Callbacks lesen den SlotDispatch.
+		void InvokeOrPost(const CallbackList& callbacks, const CallbackSlot& slot, std::atomic<SlotDispatch*>& dispatch,
+						  SharedArguments& pArgs, const Args& ... args)
+		{
+			if(slot.callback)
+			{
+				Invoke(slot, slot.callback, args...);
+				return;
+			}
+			SlotDispatch& slotDispatch = *dispatch.load(std::memory_order_acquire); // beim Anmelden angelegt
+			if(slotDispatch.IsBoundToOtherThread())
+			{
+				PostToLoop(callbacks, slotDispatch, LazyArguments(pArgs, args...));
+			}
+			else
+			{
+				Invoke(slot, slotDispatch.Callback(), args...);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Stellt den Aufruf über das Postfach des Slots in dessen EventLoop ein. Das Postfach übernimmt
+		/// einen Anteil an der (per HazardPointer geschützten) Liste.
+		void PostToLoop(const CallbackList& callbacks, SlotDispatch& dispatch, const SharedArguments& pArgs)
+		{
+			if(const size_t numDropped = dispatch.GetMailbox().Post(*mExecutor, callbacks.shared_from_this(), pArgs))
+			{
+				mNumDroppedEvents.fetch_add(numDropped, std::memory_order_relaxed);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Kopiert die Prioritätskette, wendet modify darauf an und veröffentlicht die neue Liste.
+		/// mMutex muss gehalten werden.
+		template <class Modify>
+		void PublishModifiedChain(Modify&& modify)
+		{
+			auto pNewCallbacks	= std::make_shared<CallbackList>(*mpOwnedCallbackList);
+			auto pNewChain		= (pNewCallbacks->pPriorityChain != nullptr) ? std::make_shared<PriorityChain>(*pNewCallbacks->pPriorityChain)
+																		 : std::make_shared<PriorityChain>();
+			modify(*pNewChain);
+			pNewCallbacks->pPriorityChain = pNewChain->empty() ? nullptr : std::move(pNewChain);
+			PublishList(std::move(pNewCallbacks));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Veröffentlicht die neue Liste und gibt die abgelöste zurück, die noch von laufenden Aufrufen
+		/// gelesen werden kann. mMutex muss gehalten werden.
+		std::shared_ptr<const CallbackList> ExchangeList(std::shared_ptr<const CallbackList> pNewCallbacks)
+		{
+			mpCallbackList.store(pNewCallbacks.get(), std::memory_order_seq_cst);
+			return std::exchange(mpOwnedCallbackList, std::move(pNewCallbacks));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Veröffentlicht die neue Liste mit einem eigenen Friedhof, der an den der abgelösten Liste
+		/// angehängt wird. Die abgelöste Liste wird freigegeben, sobald sie kein HazardPointer mehr
+		/// schützt. mMutex muss gehalten werden.
+		void PublishList(std::shared_ptr<CallbackList> pNewCallbacks)
+		{
+			pNewCallbacks->pGraveyard = std::make_shared<Graveyard>(pNewCallbacks->pBlocks, mpSlotInbox);
+			mpOwnedCallbackList->pGraveyard->Link(pNewCallbacks->pGraveyard);
+			mRetiredCallbackLists.Retire(ExchangeList(std::move(pNewCallbacks)));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Übernimmt die Callbacks von "other" (Move-Konstruktor und -Zuweisung), beide Sperren müssen
+		/// gehalten werden. Die Friedhöfe der übernommenen Listen geben ihre Slots an diesen Handler
+		/// frei, "other" erhält eine leere Liste mit neuer Freiliste.
+		void TakeCallbacks(BasicCallbackHandler& other)
+		{
+			mExecutor			= other.mExecutor;
+			mpSlowCallbackHook	= other.mpSlowCallbackHook;
+			mFreeSlots			= std::exchange(other.mFreeSlots, {});
+			mGenerations		= std::exchange(other.mGenerations, {});
+			mpSlotInbox			= std::exchange(other.mpSlotInbox, std::make_shared<SlotInbox>());
+			mRetiredCallbackLists.Retire(ExchangeList(other.ExchangeList(other.EmptyList())));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Vergibt Slot-Index und Generation für einen neuen Callback. Ist die Freiliste leer, werden die
+		/// von den Friedhöfen freigegebenen Slots übernommen (niedrigster Index zuerst). mMutex muss
+		/// gehalten werden.
+		CallbackHandle AllocateHandle()
+		{
+			uint32_t index;
 
-	private:
-		using OptionalCallback = std::optional<CallbackType>;
+			if(mFreeSlots.empty())
+			{
+				std::lock_guard lock(mpSlotInbox->mutex);
+				mFreeSlots.swap(mpSlotInbox->indices);
+				std::sort(mFreeSlots.begin(), mFreeSlots.end(), std::greater<>());
+			}
+			if(!mFreeSlots.empty())
+			{
+				index = mFreeSlots.back();
+				mFreeSlots.pop_back();
+			}
+			else
+			{
+				index = static_cast<uint32_t>(mGenerations.size());
+				mGenerations.push_back(0);
+			}
+			// Generation bleibt im Bereich 1..MaxGeneration, damit das Handle positiv ist
+			const uint32_t generation = mGenerations[index] = (mGenerations[index] % MaxGeneration) + 1;
+			return (static_cast<CallbackHandle>(generation) << 32) | index;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Belegt einen freien Slot an Ort und Stelle und veröffentlicht ihn über sein Masken-Bit. Nur
+		/// wenn ein neuer Block benötigt wird, wird eine neue Liste veröffentlicht.
+		CallbackHandle AddSlot(CallbackType callback, TaskCallbackType taskCallback, const MailboxOptions& mailboxOptions,
+							   EventLoop* pLoop)
+		{
+			std::lock_guard lock(mMutex);
+			mRetiredCallbackLists.Reclaim(); // nicht mehr gelesene Listen geben ihre entfernten Slots frei
+
+			const CallbackHandle	handle		= AllocateHandle();
+			const uint32_t			index		= static_cast<uint32_t>(handle);
+			const size_t			blockIndex	= index/SlotsPerBlock;
+			const size_t			slotIndex	= index%SlotsPerBlock;
+			if(blockIndex >= mpOwnedCallbackList->pBlocks->size())
+			{
+				auto pNewBlocks		= std::make_shared<BlockList>(*mpOwnedCallbackList->pBlocks);
+				auto pNewCallbacks	= std::make_shared<CallbackList>(*mpOwnedCallbackList);
+				while(pNewBlocks->size() <= blockIndex)
+				{
+					pNewBlocks->push_back(std::make_shared<SlotBlock>());
+				}
+				pNewCallbacks->pBlocks = std::move(pNewBlocks);
+				PublishList(std::move(pNewCallbacks));
+			}
+
+			// kein Leser berührt den Slot, solange sein Bit gelöscht ist
+			SlotBlock&		block	= *(*mpOwnedCallbackList->pBlocks)[blockIndex];
+			CallbackSlot&	slot	= block.slots[slotIndex];
+			slot.generation = static_cast<uint32_t>(handle >> 32);
+			if constexpr(IsProfilingEnabled)
+			{
+				slot.pProfile = std::make_shared<ProfileRecorder>(handle, mpSlowCallbackHook);
+			}
+			if(pLoop == nullptr)
+			{
+				slot.callback = std::move(callback);
+			}
+			if((pLoop != nullptr) || taskCallback || (mailboxOptions != MailboxOptions{}))
+			{
+				block.dispatch[slotIndex].store(new SlotDispatch(slot, (pLoop != nullptr) ? std::move(callback) : CallbackType(),
+																 std::move(taskCallback), pLoop, mailboxOptions),
+												std::memory_order_relaxed);
+			}
+			block.liveMask.fetch_or(uint64_t(1) << slotIndex, std::memory_order_release);
+			return handle;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Erzeugt eine leere Callback-Liste
+		std::shared_ptr<CallbackList> EmptyList() const
+		{
+			auto pEmpty = std::make_shared<CallbackList>();
+			pEmpty->pBlocks		= std::make_shared<const BlockList>();
+			pEmpty->pGraveyard	= std::make_shared<Graveyard>(pEmpty->pBlocks, mpSlotInbox);
+			return pEmpty;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Erzeugt den von allen Slots geteilten Hook für langsame Callbacks (nur mit ProfilingPolicy)
+		static HookPtr MakeHookPtr()
+		{
+			if constexpr(IsProfilingEnabled)
+			{
+				return std::make_shared<SharedHook>();
+			}
+			else
+			{
+				return {};
+			}
+		}
+
+		static constexpr uint32_t MaxGeneration = 0x7FFFFFFF;
 
-		mutable std::mutex				mMutex;
-		std::atomic_bool				mIsPendingOperation = false; // Merker, ob Schnittstelle fr unbestimmte Zeit blockiert ist
-		std::vector<OptionalCallback>	mCallbacks;
-		std::vector<std::future<void>>	mCallbackFutures;
+		mutable std::mutex									mMutex;					// serialisiert Änderungen der Callback-Liste
+		std::atomic_int										mNumPendingOperations	= 0; // Anzahl WaitForXXX-Operationen, die für unbestimmte Zeit blockieren
+		std::atomic_size_t									mNumDroppedEvents		= 0; // in Postfächern verworfene Ereignisse
+		std::atomic_size_t									mNumCoalescedAsyncCalls	= 0; // von CallAllAsync() ersetzte Ereignisse
+		std::atomic_size_t									mNumDroppedAsyncCalls	= 0; // von CallAllAsync() verworfene Ereignisse
+		std::vector<uint32_t>								mFreeSlots;				// Freiliste (LIFO), nur unter mMutex
+		std::vector<uint32_t>								mGenerations;			// Generation je Slot-Index, nur unter mMutex
+		std::shared_ptr<SlotInbox>							mpSlotInbox				= std::make_shared<SlotInbox>(); // von Friedhöfen freigegebene Slots
+		ThreadPoolExecutor*									mExecutor				= &CallbackDispatchExecutor();
+		[[no_unique_address]] HookPtr						mpSlowCallbackHook		= MakeHookPtr(); // nur mit ProfilingPolicy
+		std::shared_ptr<const CallbackList>					mpOwnedCallbackList		= EmptyList(); // veröffentlichte Liste, nur unter mMutex
+		std::atomic<const CallbackList*>					mpCallbackList			{ mpOwnedCallbackList.get() }; // Lesen per ListGuard
+		HazardRetireList<std::shared_ptr<const CallbackList>>	mRetiredCallbackLists;	// abgelöste Listen, nur unter mMutex
 	};
 
-} // namespace asentics::concurrent
\ No newline at end of file
+	//________________________________________________________________________________________________
+	/// @brief	CallbackHandler, der die Callbacks als std::function ablegt
+	template <class ... Args>
+	using CallbackHandler = BasicCallbackHandler<StdFunctionStorage, Args ...>;
+
+	//________________________________________________________________________________________________
+	/// @brief	CallbackHandler, der die Callables ohne Heap-Allokation in InplaceFunction<..., Capacity>
+	///			ablegt (siehe InplaceStorage)
+	template <size_t Capacity, class ... Args>
+	using InplaceCallbackHandler = BasicCallbackHandler<InplaceStorage<Capacity>, Args ...>;
+
+	//________________________________________________________________________________________________
+	/// @brief	CallbackHandler, der die Callbacks als std::function ablegt und deren Laufzeit erfasst
+	template <class ... Args>
+	using ProfilingCallbackHandler = BasicCallbackHandler<ProfilingPolicy<StdFunctionStorage>, Args ...>;
+
+} // namespace asentics::concurrent
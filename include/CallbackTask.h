@@ -0,0 +1,250 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include "ThreadPoolExecutor.h"
+
+namespace tiel::concurrent
+{
+	namespace detail
+	{
+		//_________________________________________________________________________________________________
+		/// Rückgabetyp einer sofort startenden Coroutine, deren Rahmen sich am Ende selbst freigibt
+		struct DetachedCoroutine
+		{
+			struct promise_type
+			{
+				DetachedCoroutine get_return_object() noexcept
+				{
+					return {};
+				}
+				std::suspend_never initial_suspend() noexcept
+				{
+					return {};
+				}
+				std::suspend_never final_suspend() noexcept
+				{
+					return {};
+				}
+				void return_void() noexcept
+				{}
+				void unhandled_exception() noexcept
+				{
+					std::terminate();
+				}
+			};
+		};
+	} // namespace detail
+
+	//_________________________________________________________________________________________________
+	/// @brief	Rückgabetyp eines Callbacks, der als Coroutine implementiert ist (siehe
+	///			BasicCallbackHandler::CallAllAwaitable()).
+	/// @remark	Die Coroutine startet erst, wenn der Task mit co_await erwartet wird, und setzt nach ihrem
+	///			Ende den Erwartenden per symmetrischem Transfer fort. Eine in der Coroutine geworfene
+	///			Exception wird beim Erwartenden erneut geworfen.
+	///			Der Task ist nur verschiebbar und darf höchstens einmal erwartet werden.
+	class CallbackTask final
+	{
+	public:
+		class promise_type final
+		{
+			friend class CallbackTask;
+
+			///------------------------------------------------------------------------------------------
+			/// Setzt am Ende der Coroutine den Erwartenden fort
+			struct FinalAwaiter
+			{
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+				{
+					const std::coroutine_handle<> continuation = handle.promise().mContinuation;
+					return continuation ? continuation : std::noop_coroutine();
+				}
+				void await_resume() const noexcept
+				{}
+			};
+
+		public:
+			CallbackTask get_return_object() noexcept
+			{
+				return CallbackTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			std::suspend_always initial_suspend() const noexcept
+			{
+				return {};
+			}
+			FinalAwaiter final_suspend() const noexcept
+			{
+				return {};
+			}
+			void return_void() const noexcept
+			{}
+			void unhandled_exception() noexcept
+			{
+				mException = std::current_exception();
+			}
+
+		private:
+			std::coroutine_handle<>	mContinuation;
+			std::exception_ptr		mException;
+		};
+
+		///----------------------------------------------------------------------------------------------
+		/// Standard-Konstruktor, erzeugt einen leeren, bereits abgeschlossenen Task
+		CallbackTask() noexcept = default;
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist nicht kopierbar
+		CallbackTask(const CallbackTask&) = delete;
+		CallbackTask& operator=(const CallbackTask&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief Move-Konstruktor
+		/// @param mv_other [in, out]:		mv_other ist anschließend leer
+		CallbackTask(CallbackTask&& mv_other) noexcept
+			: mHandle(std::exchange(mv_other.mHandle, nullptr))
+		{}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Move-Zuweisungsoperator
+		/// @param mv_right [in, out]:		mv_right ist anschließend leer
+		CallbackTask& operator=(CallbackTask&& mv_right) noexcept
+		{
+			if(&mv_right != this)
+			{
+				Reset();
+				mHandle = std::exchange(mv_right.mHandle, nullptr);
+			}
+			return *this;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, gibt den Rahmen der Coroutine frei. Die Coroutine darf nicht mehr laufen.
+		~CallbackTask()
+		{
+			Reset();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob die Coroutine abgeschlossen ist (bzw. der Task leer ist).
+		[[nodiscard]] bool IsDone() const noexcept
+		{
+			return !mHandle || mHandle.done();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Startet die Coroutine und setzt den Erwartenden nach deren Ende fort.
+		auto operator co_await() && noexcept
+		{
+			struct Awaiter
+			{
+				std::coroutine_handle<promise_type> handle;
+
+				bool await_ready() const noexcept
+				{
+					return !handle || handle.done();
+				}
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+				{
+					handle.promise().mContinuation = continuation;
+					return handle;
+				}
+				void await_resume() const
+				{
+					if(handle && handle.promise().mException)
+					{
+						std::rethrow_exception(handle.promise().mException);
+					}
+				}
+			};
+			return Awaiter{ mHandle };
+		}
+
+	private:
+		explicit CallbackTask(std::coroutine_handle<promise_type> handle) noexcept
+			: mHandle(handle)
+		{}
+		void Reset() noexcept
+		{
+			if(mHandle)
+			{
+				mHandle.destroy();
+				mHandle = nullptr;
+			}
+		}
+
+		std::coroutine_handle<promise_type> mHandle;
+	}; // class CallbackTask
+
+	//_________________________________________________________________________________________________
+	/// @brief	Awaitable, das die erwartende Coroutine in einem Worker des Executors fortsetzt.
+	/// @remark	Das Awaitable liegt im Rahmen der Coroutine und wird ohne Allokation per
+	///			ThreadPoolExecutor::Post() eingestellt.
+	class ResumeOn final : public ExecutorTask
+	{
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor
+		/// @param executor		Executor, in dem die Coroutine fortgesetzt wird
+		explicit ResumeOn(ThreadPoolExecutor& executor) noexcept
+			: mExecutor(executor)
+		{}
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			mHandle = handle;
+			mExecutor.Post(*this); // danach nicht mehr auf dieses Objekt zugreifen
+		}
+		void await_resume() const noexcept
+		{}
+		void Run() override
+		{
+			mHandle.resume();
+		}
+
+	private:
+		ThreadPoolExecutor&		mExecutor;
+		std::coroutine_handle<>	mHandle;
+	}; // class ResumeOn
+
+	//_________________________________________________________________________________________________
+	/// @brief	Startet den Task und blockiert den aufrufenden Thread, bis er abgeschlossen ist.
+	/// @remark	Wird der Task in einem Executor fortgesetzt, darf SyncWait() nicht aus allen Workern
+	///			dieses Executors gleichzeitig aufgerufen werden.
+	/// @param task		zu erwartender Task
+	/// @exception		die im Task geworfene Exception
+	inline void SyncWait(CallbackTask task)
+	{
+		std::mutex				mutex;
+		std::condition_variable	condition;
+		bool					isDone = false;
+		std::exception_ptr		exception;
+
+		[](CallbackTask task, std::mutex& mutex, std::condition_variable& condition, bool& isDone,
+		   std::exception_ptr& exception) -> detail::DetachedCoroutine
+		{
+			try
+			{
+				co_await std::move(task);
+			}
+			catch(...)
+			{
+				exception = std::current_exception();
+			}
+			// unter der Sperre benachrichtigen, damit der Wartende erst danach zurückkehren kann
+			std::lock_guard lock(mutex);
+			isDone = true;
+			condition.notify_all();
+		}(std::move(task), mutex, condition, isDone, exception);
+
+		std::unique_lock lock(mutex);
+		condition.wait(lock, [&isDone]() { return isDone; });
+		if(exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+} // namespace tiel::concurrent
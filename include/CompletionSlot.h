@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+namespace tiel::concurrent
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Wiederverwendbarer Abschluss-Zustand eines wiederholt gestarteten Vorgangs (Ersatz für
+	///			std::promise/std::future ohne Allokation eines gemeinsamen Zustands je Start).
+	/// @remark	Der Zustand ist ein einzelnes atomares Wort, IsPending() und HasResult() sind je ein
+	///			atomarer Ladevorgang. Wait() und Get() warten per std::atomic::wait(). Nur WaitUntil()
+	///			verwendet Mutex und Condition-Variable, der Abschluss sperrt diese nur, wenn gerade ein
+	///			Thread mit Timeout wartet.
+	///			Start() und Complete() dürfen nicht gleichzeitig aus mehreren Threads aufgerufen werden.
+	class CompletionSlot final
+	{
+		enum State : uint32_t
+		{
+			Empty,		// kein Ergebnis vorhanden bzw. bereits abgeholt
+			Pending,	// Vorgang läuft
+			Ready		// Ergebnis liegt vor und wurde noch nicht abgeholt
+		};
+
+	public:
+		CompletionSlot() = default;
+		CompletionSlot(const CompletionSlot&) = delete;
+		CompletionSlot& operator=(const CompletionSlot&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Markiert den Vorgang als laufend. Ein noch nicht abgeholtes Ergebnis wird verworfen.
+		/// @return		false, wenn der vorherige Vorgang noch läuft
+		bool Start()
+		{
+			uint32_t state = mState.load(std::memory_order_relaxed);
+			do
+			{
+				if(state == Pending)
+				{
+					return false;
+				}
+			} while(!mState.compare_exchange_weak(state, Pending, std::memory_order_acq_rel, std::memory_order_relaxed));
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Schließt den laufenden Vorgang ab und weckt die Wartenden.
+		/// @param exception [in]:	im Vorgang aufgetretene Exception bzw. nullptr
+		void Complete(std::exception_ptr exception)
+		{
+			{
+				SpinLock lock(mExceptionLock);
+				mException = std::move(exception);
+				mState.store(Ready, std::memory_order_seq_cst);
+			}
+			mState.notify_all();
+			if(mNumTimedWaiters.load(std::memory_order_seq_cst) != 0)
+			{
+				std::lock_guard lock(mMutex);
+				mCondition.notify_all();
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	true, wenn der Vorgang gestartet und noch nicht abgeschlossen ist
+		[[nodiscard]] bool IsPending() const
+		{
+			return mState.load(std::memory_order_acquire) == Pending;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	true, wenn ein Vorgang gestartet und dessen Ergebnis noch nicht mit Get() abgeholt
+		///			wurde (entspricht std::future::valid())
+		[[nodiscard]] bool HasResult() const
+		{
+			return mState.load(std::memory_order_acquire) != Empty;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet auf den Abschluss des Vorgangs.
+		void Wait() const
+		{
+			mState.wait(Pending, std::memory_order_acquire);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet bis spätestens "deadline" auf den Abschluss des Vorgangs.
+		/// @return		true, wenn der Vorgang abgeschlossen ist
+		template <class Clock, class Duration>
+		bool WaitUntil(const std::chrono::time_point<Clock, Duration>& deadline) const
+		{
+			if(!IsPending())
+			{
+				return true;
+			}
+			mNumTimedWaiters.fetch_add(1, std::memory_order_seq_cst);
+			bool isDone;
+			{
+				std::unique_lock lock(mMutex);
+				isDone = mCondition.wait_until(lock, deadline, [this]() { return mState.load(std::memory_order_seq_cst) != Pending; });
+			}
+			mNumTimedWaiters.fetch_sub(1, std::memory_order_relaxed);
+			return isDone;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet auf den Abschluss des Vorgangs, holt das Ergebnis ab und wirft ggf. die im
+		///			Vorgang aufgetretene Exception (entspricht std::future::get()).
+		void Get()
+		{
+			Wait();
+			std::exception_ptr exception;
+			{
+				SpinLock lock(mExceptionLock);
+				uint32_t expected = Ready;
+				(void)mState.compare_exchange_strong(expected, Empty, std::memory_order_acq_rel);
+				exception = std::exchange(mException, nullptr);
+			}
+			if(exception)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Schützt mException, nur beim Abschluss und beim Abholen kurz gehalten
+		struct SpinLock
+		{
+			std::atomic_flag& flag;
+			explicit SpinLock(std::atomic_flag& f)
+				: flag(f)
+			{
+				while(flag.test_and_set(std::memory_order_acquire))
+				{
+					flag.wait(true, std::memory_order_relaxed);
+				}
+			}
+			~SpinLock()
+			{
+				flag.clear(std::memory_order_release);
+				flag.notify_one();
+			}
+		};
+
+		std::atomic_uint32_t			mState			= Empty;
+		std::atomic_flag				mExceptionLock;
+		std::exception_ptr				mException;
+		mutable std::atomic_uint32_t	mNumTimedWaiters = 0;
+		mutable std::mutex				mMutex;				// nur für WaitUntil()
+		mutable std::condition_variable	mCondition;
+	}; // class CompletionSlot
+
+} // namespace tiel::concurrent
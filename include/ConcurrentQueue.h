@@ -6,18 +6,23 @@
 #include <limits>
 #include <mutex>
 #include <condition_variable>
+#include <memory>
+#include <filesystem>
+#include <utility>
+#include "SpillStore.h"
+#include "QueueSnapshot.h"
 
 namespace tiel::concurrent::container
 {
 	//_________________________________________________________________________________________________
 	/// @brief	Threadsichere Queue, in der jede Methode blockierungsfrei implementiert ist.
 	/// @remark	Diese Klasse sollte nur verwendet werden, wenn das Kopieren von <T> geringe Rechenzeit
-	///			bentigt oder zumindest Race-Condition bei Push- und Pop-Operationen sehr selten
+	///			benötigt oder zumindest Race-Condition bei Push- und Pop-Operationen sehr selten
 	///			auftreten, da sonst der zur Synchronistation verwendete interne SpinLock zu einer hohen
-	///			CPU-Auslastung fhren kann.
+	///			CPU-Auslastung führen kann.
 	///			Bei teuer zu kopierenden Typen ist es u.U. besser statt <T>, <std::shared_ptr<T>> bzw. 
 	///			<std::unique_ptr<T>> als Vorlagentyp zu verwenden.
-	/// @tparam T	Move-Konstruktor und Move-Zuweisungsoperator drfen nicht explizit gelscht sein
+	/// @tparam T	Move-Konstruktor und Move-Zuweisungsoperator dürfen nicht explizit gelöscht sein
 	template <typename T>
 	class LockFreeQueue final
 	{
@@ -40,14 +45,14 @@ namespace tiel::concurrent::container
 			: mQueue()
 		{}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Konstruktor, mit dem optional die maximale Queue-Gre definiert werden kann
+		/// @brief Konstruktor, mit dem optional die maximale Queue-Größe definiert werden kann
 		/// @param maxSize		max. Anzahl Elemente, die gleichzeitig in der Queue gehalten werden.
 		LockFreeQueue(std::size_t maxSize)
 			: mQueue(), mMaxSize(maxSize)
 		{}
 		///----------------------------------------------------------------------------------------------
 		/// @brief Move-Konstruktor
-		/// @param mv_other [in, out]:		 mv_other ist anschlieend leer und geschlossen
+		/// @param mv_other [in, out]:		 mv_other ist anschließend leer und geschlossen
 		LockFreeQueue(LockFreeQueue&& mv_other) noexcept
 		{
 			while(mv_other.mFlag.test_and_set(std::memory_order_acquire))
@@ -64,7 +69,7 @@ namespace tiel::concurrent::container
 		}
 		///----------------------------------------------------------------------------------------------
 		/// @brief Move-Zuweisungsoperator
-		/// @param mv_right [in, out]:		mv_other ist anschlieend leer und geschlossen
+		/// @param mv_right [in, out]:		mv_other ist anschließend leer und geschlossen
 		/// @return							diese Queue
 		LockFreeQueue& operator=(LockFreeQueue&& mv_right) noexcept
 		{
@@ -104,8 +109,8 @@ namespace tiel::concurrent::container
 			mFlag.clear(std::memory_order_release);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Entfernt alle Elemente aus der Queue, fr die die Filterfunktion true zurckgibt
-		/// @param filter		Filterfunktion, die fr alle zu entfernende Elemente true zurckgibt.
+		/// @brief Entfernt alle Elemente aus der Queue, für die die Filterfunktion true zurückgibt
+		/// @param filter		Filterfunktion, die für alle zu entfernende Elemente true zurückgibt.
 		/// @return				true, wenn mindestens ein Element aus der Queue entfernt wurde.
 		bool RemoveByFilter(std::function<bool(const T& value)> filter)
 		{
@@ -136,10 +141,10 @@ namespace tiel::concurrent::container
 			return isRemoved;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Schliet die Queue, sodass keine weiteren Elemente mit TryPush() in die Queue 
-		///			aufgenommen werden. Bereits in der Queue befindliche Elemente knnen noch mit
+		/// @brief	Schließt die Queue, sodass keine weiteren Elemente mit TryPush() in die Queue 
+		///			aufgenommen werden. Bereits in der Queue befindliche Elemente können noch mit
 		///			TryPop entnommen werden.
-		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geffnet werden.
+		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geöffnet werden.
 		void Close()
 		{
 			//_ASSERT(false); // not tested
@@ -152,35 +157,35 @@ namespace tiel::concurrent::container
 			}
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Prft, ob die Queue geschlossen ist.
+		/// @brief Prüft, ob die Queue geschlossen ist.
 		/// @return			true, wenn die Queue geschlossen ist.
 		[[nodiscard]] bool IsClosed() const
 		{
 			return mIsClosed.load(std::memory_order_relaxed);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft, ob die Queue voll ist.
-		/// @return			true, wenn die Queue die maximale Anzahl Elemente enthlt
+		/// @brief	Prüft, ob die Queue voll ist.
+		/// @return			true, wenn die Queue die maximale Anzahl Elemente enthält
 		[[nodiscard]] bool IsFull() const
 		{
 			while(mFlag.test_and_set(std::memory_order_acquire))
 				;
 
-			auto size = mQueue.size();
+			auto size = mQueue.size() + mNumWriting;
 			mFlag.clear(std::memory_order_release);
 			return (size >= mMaxSize);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Prft, ob die Queue leer ist.
-		/// @return		true, wenn die Queue keine Elemente enthlt.
+		/// @brief Prüft, ob die Queue leer ist.
+		/// @return		true, wenn die Queue keine Elemente enthält.
 		[[nodiscard]] bool IsEmpty() const
 		{
 			return mIsEmpty.load(std::memory_order_relaxed);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft, ob das erste Element der Queue (front), dem das reingereichte Prdikat erfllt.
-		/// @param predicate		Funktion, die true zurckgibt, wenn predicate(queue.front()) die
-		///							Bedingung erfllt.
+		/// @brief	Prüft, ob das erste Element der Queue (front), dem das reingereichte Prädikat erfüllt.
+		/// @param predicate		Funktion, die true zurückgibt, wenn predicate(queue.front()) die
+		///							Bedingung erfüllt.
 		/// @return		true, wenn predicate(queue.front()) == true ist, sonst false.
 		[[nodiscard]] bool IsFront(std::function<bool(const T&)> predicate) const
 		{
@@ -201,7 +206,7 @@ namespace tiel::concurrent::container
 			return false;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Gibt die Anzahl der Queue-Elemente zurck.
+		/// @brief Gibt die Anzahl der Queue-Elemente zurück.
 		/// @return			Anzahl der Queue-Elemente
 		[[nodiscard]] size_t Size() const
 		{
@@ -213,16 +218,16 @@ namespace tiel::concurrent::container
 			return size;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Gibt die maximale gltige Anzahl Queue-Elemente zurck.
-		/// @return			Maximale gltige Anzahl Queue-Elemente
+		/// @brief Gibt die maximale gültige Anzahl Queue-Elemente zurück.
+		/// @return			Maximale gültige Anzahl Queue-Elemente
 		[[nodiscard]] size_t MaxSize() const
 		{
 			return mMaxSize;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Fgt ein Element der Queue hinzu, sofern die Queue nicht geschlossen oder voll ist.
-		/// @param value	Wert, der am Ende der Queue hinzugefgt werden soll.
-		/// @return			true, wenn das angegene Element der Queue hinzugefgt werden konnte.
+		/// @brief	Fügt ein Element der Queue hinzu, sofern die Queue nicht geschlossen oder voll ist.
+		/// @param value	Wert, der am Ende der Queue hinzugefügt werden soll.
+		/// @return			true, wenn das angegene Element der Queue hinzugefügt werden konnte.
 		[[nodiscard]] bool TryPush(const T& value)
 		{
 			if(mIsClosed.load(std::memory_order_relaxed))
@@ -232,7 +237,7 @@ namespace tiel::concurrent::container
 			while(mFlag.test_and_set(std::memory_order_acquire))
 				;
 
-			if(!mIsClosed.load(std::memory_order_acquire) && (mQueue.size() < mMaxSize))
+			if(!mIsClosed.load(std::memory_order_acquire) && (mQueue.size() + mNumWriting < mMaxSize))
 			{
 				mQueue.push(value);
 				mIsEmpty.store(false, std::memory_order_release);
@@ -243,11 +248,11 @@ namespace tiel::concurrent::container
 			return false;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Verschiebt das bergebene Element in die Queue, sofern die Queue nicht geschlossen 
+		/// @brief	Verschiebt das übergebene Element in die Queue, sofern die Queue nicht geschlossen 
 		///			oder voll ist.
 		/// @remark	Wenn das Element in die Queue verschoben werden konnt, ist "value"
 		/// @param value [in, out]		Element, das in die Queue verschoben werden soll. Wenn die Methode
-		///								mit true zurckkehrt, ist "value" anschlieend in einem gltigen
+		///								mit true zurückkehrt, ist "value" anschließend in einem gültigen
 		///								aber unbestimmten Zustand.
 		/// @return						true, wenn das Element in die Queue verschoben werden konnte.
 		[[nodiscard]] bool TryPush(T&& mv_value)
@@ -259,7 +264,7 @@ namespace tiel::concurrent::container
 			while(mFlag.test_and_set(std::memory_order_acquire))
 				;
 
-			if(!mIsClosed.load(std::memory_order_acquire) && (mQueue.size() < mMaxSize))
+			if(!mIsClosed.load(std::memory_order_acquire) && (mQueue.size() + mNumWriting < mMaxSize))
 			{
 				if constexpr(std::is_move_assignable<T>::value)
 				{
@@ -277,9 +282,9 @@ namespace tiel::concurrent::container
 			return false;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Entfernt das erste Element aus der Queue und gibt dieses zurck.
-		/// @return		wenn die Queue leer ist, hlt das zurckgegebene std::optional<T> keinen Wert,
-		///				sont wird der Wert des ersten Elements der Queue zurckgegeben.
+		/// @brief Entfernt das erste Element aus der Queue und gibt dieses zurück.
+		/// @return		wenn die Queue leer ist, hält das zurückgegebene std::optional<T> keinen Wert,
+		///				sont wird der Wert des ersten Elements der Queue zurückgegeben.
 		std::optional<T> TryPop()
 		{
 			// stellt sicher, dass bei einer leeren Queue TryPush bevorzugt wird
@@ -306,21 +311,138 @@ namespace tiel::concurrent::container
 			return {};
 		}
 
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entnimmt alle Elemente und schreibt diese in eine Snapshot-Datei (siehe Restore()).
+		/// @remark	Der SpinLock wird nur zum Austauschen der internen Queue gehalten, das Schreiben erfolgt
+		///			ohne Sperre. Schlägt das Schreiben fehl, werden die Elemente in ursprünglicher
+		///			Reihenfolge vor die zwischenzeitlich hinzugefügten Elemente zurückgelegt. Bis dahin
+		///			zählen die entnommenen Elemente weiter für MaxSize(), so dass die Queue auch danach
+		///			höchstens MaxSize() Elemente enthält.
+		/// @param path [in]:	Pfad der Snapshot-Datei. Eine vorhandene Datei wird ersetzt.
+		/// @return				true, wenn alle Elemente geschrieben wurden. Die Queue ist dann leer.
+		bool Snapshot(const std::filesystem::path& path) requires Serializable<T>
+		{
+			//_ASSERT(false); // not tested
+			std::queue<T> elements;
+
+			while(mFlag.test_and_set(std::memory_order_acquire))
+				;
+			std::swap(elements, mQueue);
+			mNumWriting += elements.size();
+			mIsEmpty.store(true, std::memory_order_release);
+			mFlag.clear(std::memory_order_release);
+
+			const bool isWritten = QueueSnapshotFile::Write(path, elements);
+
+			while(mFlag.test_and_set(std::memory_order_acquire))
+				;
+			mNumWriting -= elements.size();
+			if(isWritten)
+			{
+				mFlag.clear(std::memory_order_release);
+				return true;
+			}
+			while(!mQueue.empty())
+			{
+				if constexpr(std::is_move_assignable<T>::value)
+				{
+					elements.push(std::move(mQueue.front()));
+				}
+				else
+				{
+					elements.push(mQueue.front());
+				}
+				mQueue.pop();
+			}
+			std::swap(elements, mQueue);
+			mIsEmpty.store(mQueue.empty(), std::memory_order_release);
+			mFlag.clear(std::memory_order_release);
+			return false;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Liest alle Elemente einer mit Snapshot() geschriebenen Datei ein und hängt diese an
+		///			das Ende der Queue an.
+		/// @remark	Die Datei wird eingeblendet und die Elemente werden ohne Sperre direkt aus dem
+		///			eingeblendeten Speicher erzeugt. Anschließend werden sie mit einer einzigen
+		///			Sperre übernommen (bei leerer Queue durch Austauschen in O(1)).
+		/// @param path [in]:	Pfad der Snapshot-Datei
+		/// @return				true, wenn alle Elemente übernommen wurden. false, wenn die Datei ungültig
+		///						ist, die Queue geschlossen ist oder MaxSize() überschritten würde. In
+		///						diesem Fall bleibt die Queue unverändert.
+		bool Restore(const std::filesystem::path& path) requires Serializable<T>
+		{
+			//_ASSERT(false); // not tested
+			QueueSnapshotFile	file;
+			std::queue<T>		elements;
+
+			if(!file.template Open<T>(path) || (file.NumRecords() > mMaxSize))
+			{
+				return false;
+			}
+			const bool isValid = file.template ForEachRecord<T>([&elements](const std::byte* pRecord, size_t)
+				{
+					T value = SerializedRecord::Read<T>(pRecord);
+					if constexpr(std::is_move_assignable<T>::value)
+					{
+						elements.push(std::move(value));
+					}
+					else
+					{
+						elements.push(value);
+					}
+				});
+			if(!isValid)
+			{
+				return false;
+			}
+
+			while(mFlag.test_and_set(std::memory_order_acquire))
+				;
+			if(mIsClosed.load(std::memory_order_acquire) || (mQueue.size() + mNumWriting + elements.size() > mMaxSize))
+			{
+				mFlag.clear(std::memory_order_release);
+				return false;
+			}
+			if(mQueue.empty())
+			{
+				std::swap(elements, mQueue);
+			}
+			else
+			{
+				while(!elements.empty())
+				{
+					if constexpr(std::is_move_assignable<T>::value)
+					{
+						mQueue.push(std::move(elements.front()));
+					}
+					else
+					{
+						mQueue.push(elements.front());
+					}
+					elements.pop();
+				}
+			}
+			mIsEmpty.store(mQueue.empty(), std::memory_order_release);
+			mFlag.clear(std::memory_order_release);
+			return true;
+		}
+
 		private:
 		mutable std::atomic_flag	mFlag		= ATOMIC_FLAG_INIT;
 		std::atomic_bool			mIsEmpty	= true;
 		std::atomic_bool			mIsClosed	= false;
 		size_t						mMaxSize	= (std::numeric_limits<size_t>::max)();
+		size_t						mNumWriting	= 0;		// von Snapshot() entnommen, wird gerade geschrieben
 		std::queue<T>				mQueue;
 
 	}; // class LockFreeQueue
 	
 	///_________________________________________________________________________________________________
 	/// @brief	Threadsichere Queue mit blockierender Schnittstelle.
-	/// @remark	Die korrekte Behandlung einer grenbegrenzten Queue fhrt zu deutlichen schlechteren
-	///			Performance, weshalb die Gre der BlockingQueue (im Gegensatz zur LockfreeQueue) nicht 
+	/// @remark	Die korrekte Behandlung einer größenbegrenzten Queue führt zu deutlichen schlechteren
+	///			Performance, weshalb die Größe der BlockingQueue (im Gegensatz zur LockfreeQueue) nicht 
 	///			vorgegeben werden kann.
-	/// @tparam T	Move-Konstruktor und Move-Zuweisungsoperator drfen nicht explizit gelscht sein
+	/// @tparam T	Move-Konstruktor und Move-Zuweisungsoperator dürfen nicht explizit gelöscht sein
 	template <typename T>
 	class BlockingQueue final
 	{
@@ -337,7 +459,7 @@ namespace tiel::concurrent::container
 			Reset(false);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Konstruktor, mit dem optional die maximale Queue-Gre definiert werden kann
+		/// @brief Konstruktor, mit dem optional die maximale Queue-Größe definiert werden kann
 		/// @param maxSize		max. Anzahl Elemente, die gleichzeitig in der Queue gehalten werden.
 		BlockingQueue()
 			: mQueue()
@@ -346,12 +468,14 @@ namespace tiel::concurrent::container
 		}
 		///----------------------------------------------------------------------------------------------
 		/// @brief Move-Konstruktor
-		/// @param mv_other [in, out]:		 mv_other ist anschlieend leer und geschlossen
+		/// @param mv_other [in, out]:		 mv_other ist anschließend leer und geschlossen
 		BlockingQueue(BlockingQueue&& mv_other) noexcept
 		{
 			//_ASSERT(false); // not tested
 			std::lock_guard lock(mv_other.mMutex);
 			mQueue = std::move(mv_other.mQueue);
+			mSpillStore = std::move(mv_other.mSpillStore);
+			mSpillThreshold = mv_other.mSpillThreshold;
 			mQueueSize.store(mv_other.mQueueSize);
 			mIsClosed.store(mv_other.mIsClosed);
 
@@ -360,7 +484,7 @@ namespace tiel::concurrent::container
 		}
 		///----------------------------------------------------------------------------------------------
 		/// @brief Move-Zuweisungsoperator
-		/// @param mv_right [in, out]:		mv_other ist anschlieend leer und geschlossen
+		/// @param mv_right [in, out]:		mv_other ist anschließend leer und geschlossen
 		/// @return							diese Queue
 		BlockingQueue& operator=(BlockingQueue&& mv_right) noexcept
 		{
@@ -369,6 +493,8 @@ namespace tiel::concurrent::container
 			{
 				std::scoped_lock lock(mMutex, mv_right.mMutex);
 				mQueue = std::move(mv_right.mQueue);
+				mSpillStore = std::move(mv_right.mSpillStore);
+				mSpillThreshold = mv_right.mSpillThreshold;
 				mQueueSize.store(mv_right.mQueueSize);
 				mIsClosed.store(mv_right.mIsClosed);
 
@@ -378,12 +504,12 @@ namespace tiel::concurrent::container
 			return *this;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Schliet die Queue, entfernt alle Elemente aus der Queue und ffnet diese optional
+		/// @brief	Schließt die Queue, entfernt alle Elemente aus der Queue und öffnet diese optional
 		///			wieder, sofern diese zuvor offen war.
 		/// @remark	Threads, die durch einen Pop()-Aufruf blockiert sind, kehren mit einem leeren
-		///			optional<T> zurck. Mittels IsClosed() knnen diese Entscheiden, ob sie die
+		///			optional<T> zurück. Mittels IsClosed() können diese Entscheiden, ob sie die
 		///			Thread-Loop verlassen
-		/// @param reopen [in]:		true, wenn die Queue nach dem Leeren wieder geffnet werden soll,
+		/// @param reopen [in]:		true, wenn die Queue nach dem Leeren wieder geöffnet werden soll,
 		///							sofern diese zuvor offen war.
 		inline void Reset(bool reopen)
 		{
@@ -400,18 +526,34 @@ namespace tiel::concurrent::container
 				{
 					mQueue.pop();
 				}
+				if(mSpillStore)
+				{
+					mSpillStore->Clear();
+				}
 			}
-			// blockierten Threads die Mglichkeit geben, auf Reset() zu reagieren
+			// blockierten Threads die Möglichkeit geben, auf Reset() zu reagieren
 			mCV.notify_all();
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Entfernt alle Elemente aus der Queue, fr die die Filterfunktion true zurckgibt
-		/// @param filter		Filterfunktion, die fr alle zu entfernende Elemente true zurckgibt.
-		/// @return				true, wenn mindestens ein Element aus der Queue entfernt wurde.
+		/// @brief Entfernt alle Elemente aus der Queue, für die die Filterfunktion true zurückgibt
+		/// @param filter		Filterfunktion, die für alle zu entfernende Elemente true zurückgibt.
+		/// @remark	Ausgelagerte Elemente werden zuerst gefiltert. Können die verbleibenden ausgelagerten
+		///			Elemente nicht geschrieben werden, bleibt die Queue unverändert.
+		/// @return				true, wenn mindestens ein Element aus der Queue entfernt wurde. false, wenn
+		///						kein Element entfernt wurde oder die ausgelagerten Elemente nicht
+		///						umkopiert werden konnten.
 		bool RemoveByFilter(std::function<bool(const T& value)> filter)
 		{
 			_ASSERT(false); // not tested
 			std::lock_guard lock(mMutex);
+			size_t			numSpilledRemoved = 0;
+			if constexpr(Serializable<T>)
+			{
+				if(mSpillStore && !mSpillStore->RemoveByFilter(filter, numSpilledRemoved))
+				{
+					return false;
+				}
+			}
 			const size_t numElements = mQueue.size();
 
 			for(size_t i = 0; i < numElements; i++)
@@ -429,14 +571,14 @@ namespace tiel::concurrent::container
 				}
 				mQueue.pop();
 			}
-			bool isRemoved = (mQueue.size() < numElements);
-			mQueueSize.store(mQueue.size(), std::memory_order_release);
-			// notify darf nur aufgerufen werden, wenn das mCV.wait-Prdikat true zurck gibt, sonst kann es passieren,
-			//  dass whrend des Ausfhrens eines False-Prdikats ein weiterer notify-Aufruf verschluckt wird,
-			//  dessen Prdikat true zurck geben wrde. Pop() wrde weiterhin ungewollt blockieren.
-			if(!mQueue.empty())
+			const bool isRemoved = (mQueue.size() < numElements) || (numSpilledRemoved != 0);
+			mQueueSize.store(TotalSize(), std::memory_order_release);
+			// notify darf nur aufgerufen werden, wenn das mCV.wait-Prädikat true zurück gibt, sonst kann es passieren,
+			//  dass während des Ausführens eines False-Prädikats ein weiterer notify-Aufruf verschluckt wird,
+			//  dessen Prädikat true zurück geben würde. Pop() würde weiterhin ungewollt blockieren.
+			if(TotalSize() != 0)
 			{
-				// blockierten Threads die Mglichkeit geben, auf Reset() zu reagieren
+				// blockierten Threads die Möglichkeit geben, auf Reset() zu reagieren
 				if(mIsClosed.load(std::memory_order_acquire))
 					mCV.notify_all();
 				else
@@ -446,10 +588,10 @@ namespace tiel::concurrent::container
 			return isRemoved;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Schliet die Queue, so dass keine weiteren Elemente mit TryPush in die Queue 
-		///			aufgenommen werden. Bereits in der Queue befindliche Elemente knnen noch mit
+		/// @brief	Schließt die Queue, so dass keine weiteren Elemente mit TryPush in die Queue 
+		///			aufgenommen werden. Bereits in der Queue befindliche Elemente können noch mit
 		///			TryPop entnommen werden.
-		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geffnet werden.
+		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geöffnet werden.
 		inline void Close()
 		{
 			//_ASSERT(false); // not tested
@@ -457,28 +599,28 @@ namespace tiel::concurrent::container
 				std::lock_guard lock(mMutex);
 				mIsClosed.store(true, std::memory_order_release);
 			}
-			// blockierten Threads die mglichkeit geben, auf Close() zu reagieren
+			// blockierten Threads die möglichkeit geben, auf Close() zu reagieren
 			mCV.notify_all();
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft, ob die Queue geschlossen ist. 
-		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geffnet werden.
+		/// @brief	Prüft, ob die Queue geschlossen ist. 
+		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geöffnet werden.
 		/// @return			true, wenn die Queue geschlossen ist.
 		[[nodiscard]] inline bool IsClosed() const
 		{
 			return mIsClosed.load(std::memory_order_relaxed);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief Prft, ob die Queue leer ist.
-		/// @return		true, wenn die Queue keine Elemente enthlt.
+		/// @brief Prüft, ob die Queue leer ist.
+		/// @return		true, wenn die Queue keine Elemente enthält.
 		[[nodiscard]] inline bool IsEmpty() const
 		{
 			return (mQueueSize.load(std::memory_order_relaxed) == 0);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Prft, ob das erste Element der Queue (front), dem das reingereichte Prdikat erfllt.
-		/// @param predicate		Funktion, die true zurckgibt, wenn predicate(queue.front()) die
-		///							Bedingung erfllt.
+		/// @brief	Prüft, ob das erste Element der Queue (front), dem das reingereichte Prädikat erfüllt.
+		/// @param predicate		Funktion, die true zurückgibt, wenn predicate(queue.front()) die
+		///							Bedingung erfüllt.
 		/// @return		true, wenn predicate(queue.front()) == true ist, sonst false.
 		[[nodiscard]] bool IsFront(std::function<bool(const T&)> predicate) const
 		{
@@ -490,26 +632,34 @@ namespace tiel::concurrent::container
 				{
 					return predicate(mQueue.front());
 				}
+				if constexpr(Serializable<T>)
+				{
+					if(mSpillStore)
+					{
+						auto optFront = mSpillStore->Front();
+						return optFront.has_value() && predicate(optFront.value());
+					}
+				}
 			}
 			return false;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Gibt die Anzahl der Queue-Elemente zurck.
+		/// @brief	Gibt die Anzahl der Queue-Elemente zurück.
 		/// @remark	Diese Methode ist blockierungsfrei, gibt aber u.U. nicht den aktuellen Stand der
-		///			Queue-Gre wider und sollte daher nicht innerhalb dieser Klasse verwendet werden.
+		///			Queue-Größe wider und sollte daher nicht innerhalb dieser Klasse verwendet werden.
 		/// @return			Anzahl der Queue-Elemente zum aktuellen Zeitpunkt 
-		///					(Mglicherweise wird gerade eine Push- oder Pop-Operation durchgefhrt)
+		///					(Möglicherweise wird gerade eine Push- oder Pop-Operation durchgeführt)
 		[[nodiscard]] inline size_t Size() const
 		{
 			return mQueueSize.load(std::memory_order_relaxed);
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Fgt ein Element an das Ende der Queue an, sofern die Queue offen und nicht voll ist.
-		/// @remark	Push() kehrt sofort zurck, wenn die Queue geschlossen ist. Wenn die Queue voll ist,
+		/// @brief	Fügt ein Element an das Ende der Queue an, sofern die Queue offen und nicht voll ist.
+		/// @remark	Push() kehrt sofort zurück, wenn die Queue geschlossen ist. Wenn die Queue voll ist,
 		///			blockiert der Aufruf, bis die Queue nicht mehr voll ist oder die Queue geschlossen wird.
-		/// @param value [in]:	Element, welches am Ende der Queue eingefgt wird, sofern die Queue
+		/// @param value [in]:	Element, welches am Ende der Queue eingefügt wird, sofern die Queue
 		///						nicht geschlossen ist.
-		/// @return				true, wenn das Element an das Ende der Queue angefgt wurde.
+		/// @return				true, wenn das Element an das Ende der Queue angefügt wurde.
 		[[nodiscard]] bool Push(const T& value)
 		{
 			//_ASSERT(false); // not tested
@@ -519,9 +669,16 @@ namespace tiel::concurrent::container
 
 				if(!mIsClosed.load(std::memory_order_acquire))
 				{
-					mQueue.push(value);
-					mQueueSize.store(mQueue.size(), std::memory_order_release);
-					isPushed = true;
+					if(MustSpill())
+					{
+						isPushed = PushSpilled(value);
+					}
+					else
+					{
+						mQueue.push(value);
+						isPushed = true;
+					}
+					mQueueSize.store(TotalSize(), std::memory_order_release);
 					mCV.notify_one();
 				}
 				else
@@ -532,11 +689,11 @@ namespace tiel::concurrent::container
 			return isPushed;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Fgt ein Element an das Ende der Queue an, sofern die Queue offen und nicht voll ist.
-		/// @remark	Push() kehrt sofort zurck, wenn die Queue geschlossen ist.
-		/// @param mv_value [in]:	Element, welches am Ende der Queue eingefgt wird, sofern die Queue
+		/// @brief	Fügt ein Element an das Ende der Queue an, sofern die Queue offen und nicht voll ist.
+		/// @remark	Push() kehrt sofort zurück, wenn die Queue geschlossen ist.
+		/// @param mv_value [in]:	Element, welches am Ende der Queue eingefügt wird, sofern die Queue
 		///							nicht geschlossen ist.
-		/// @return					true, wenn das Element an das Ende der Queue angefgt wurde.
+		/// @return					true, wenn das Element an das Ende der Queue angefügt wurde.
 		[[nodiscard]] bool Push(T&& mv_value)
 		{
 			//_ASSERT(false); // not tested
@@ -546,16 +703,23 @@ namespace tiel::concurrent::container
 
 				if(!mIsClosed.load(std::memory_order_acquire))
 				{
-					if constexpr(std::is_move_assignable<T>::value)
+					if(MustSpill())
 					{
-						mQueue.push(std::forward<T>(mv_value));
+						isPushed = PushSpilled(mv_value);
 					}
 					else
 					{
-						mQueue.push(mv_value);
+						if constexpr(std::is_move_assignable<T>::value)
+						{
+							mQueue.push(std::forward<T>(mv_value));
+						}
+						else
+						{
+							mQueue.push(mv_value);
+						}
+						isPushed = true;
 					}
-					mQueueSize.store(mQueue.size(), std::memory_order_release);
-					isPushed = true;
+					mQueueSize.store(TotalSize(), std::memory_order_release);
 					mCV.notify_one();
 				}
 				else
@@ -566,9 +730,9 @@ namespace tiel::concurrent::container
 			return isPushed;
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Entnimmt das Element am Anfang der Queue und gibt dieses zurck.
+		/// @brief	Entnimmt das Element am Anfang der Queue und gibt dieses zurück.
 		/// @remark	Der aufruf blockiert, wenn die Queue offen und leer ist, bis ein Element mit Push()
-		///			hinzugefgt wurde oder die Queue leer und geschlossen ist.
+		///			hinzugefügt wurde oder die Queue leer und geschlossen ist.
 		/// @return			Element, welches am Ende der Queue entnommen wurde, bzw. ein leeres Element,
 		///					wenn die Queue leer und geschlossen ist.
 		std::optional<T> Pop()
@@ -587,11 +751,11 @@ namespace tiel::concurrent::container
 				{
 					std::optional<T> optValue{ std::move(mQueue.front()) };
 					mQueue.pop();
-					mQueueSize.store(mQueue.size(), std::memory_order_release);
-					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prdikat true zurck gibt, sonst kann es passieren,
-					//  dass whrend des Ausfhrens eines False-Prdikats ein weiterer notify-Aufruf verschluckt wird,
-					//  dessen Prdikat true zurck geben wrde. Pop() wrde weiterhin ungewollt blockieren.
-					if(!mQueue.empty())
+					mQueueSize.store(TotalSize(), std::memory_order_release);
+					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prädikat true zurück gibt, sonst kann es passieren,
+					//  dass während des Ausführens eines False-Prädikats ein weiterer notify-Aufruf verschluckt wird,
+					//  dessen Prädikat true zurück geben würde. Pop() würde weiterhin ungewollt blockieren.
+					if(TotalSize() != 0)
 					{
 						if(mIsClosed.load(std::memory_order_acquire))
 							mCV.notify_all();
@@ -604,11 +768,11 @@ namespace tiel::concurrent::container
 				{
 					std::optional<T> optValue{ mQueue.front() };
 					mQueue.pop();
-					mQueueSize.store(mQueue.size(), std::memory_order_release);
-					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prdikat true zurck gibt, sonst kann es passieren,
-					//  dass whrend des Ausfhrens eines False-Prdikats ein weiterer notify-Aufruf verschluckt wird,
-					//  dessen Prdikat true zurck geben wrde. Pop() wrde weiterhin ungewollt blockieren.
-					if(!mQueue.empty())
+					mQueueSize.store(TotalSize(), std::memory_order_release);
+					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prädikat true zurück gibt, sonst kann es passieren,
+					//  dass während des Ausführens eines False-Prädikats ein weiterer notify-Aufruf verschluckt wird,
+					//  dessen Prädikat true zurück geben würde. Pop() würde weiterhin ungewollt blockieren.
+					if(TotalSize() != 0)
 					{
 						if(mIsClosed.load(std::memory_order_acquire))
 							mCV.notify_all();
@@ -618,12 +782,12 @@ namespace tiel::concurrent::container
 					return optValue;
 				}
 			}
-			return {};
+			return PopSpilled();
 		}
 		///----------------------------------------------------------------------------------------------
-		/// @brief	Entnimmt das Element am Anfang der Queue und gibt dieses zurck.
+		/// @brief	Entnimmt das Element am Anfang der Queue und gibt dieses zurück.
 		/// @remark	Der aufruf blockiert, wenn die Queue offen und leer ist, bis ein Element mit Push()
-		///			hinzugefgt wurde oder die Queue leer und geschlossen ist.
+		///			hinzugefügt wurde oder die Queue leer und geschlossen ist.
 		/// @param waitDurationMS [in]:	max. Zeit in Millisekunden, die auf die Entnahme eines Elements
 		///								gewartet wird.
 		///								< 0, wenn ohne Zeitbegrenzung auf die Entnahme eines Elemements
@@ -657,11 +821,11 @@ namespace tiel::concurrent::container
 				{
 					std::optional<T> optValue = std::move(mQueue.front());
 					mQueue.pop();
-					mQueueSize.store(mQueue.size(), std::memory_order_release);
-					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prdikat true zurck gibt, sonst kann es passieren,
-					//  dass whrend des Ausfhrens eines False-Prdikats ein weiterer notify-Aufruf verschluckt wird,
-					//  dessen Prdikat true zurck geben wrde. Pop() wrde weiterhin ungewollt blockieren.
-					if(!mQueue.empty())
+					mQueueSize.store(TotalSize(), std::memory_order_release);
+					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prädikat true zurück gibt, sonst kann es passieren,
+					//  dass während des Ausführens eines False-Prädikats ein weiterer notify-Aufruf verschluckt wird,
+					//  dessen Prädikat true zurück geben würde. Pop() würde weiterhin ungewollt blockieren.
+					if(TotalSize() != 0)
 					{
 						if(mIsClosed.load(std::memory_order_relaxed))
 							mCV.notify_all();
@@ -674,11 +838,11 @@ namespace tiel::concurrent::container
 				{
 					std::optional<T> optValue = mQueue.front();
 					mQueue.pop();
-					mQueueSize.store(mQueue.size(), std::memory_order_release);
-					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prdikat true zurck gibt, sonst kann es passieren,
-					//  dass whrend des Ausfhrens eines False-Prdikats ein weiterer notify-Aufruf verschluckt wird,
-					//  dessen Prdikat true zurck geben wrde. Pop() wrde weiterhin ungewollt blockieren.
-					if(!mQueue.empty())
+					mQueueSize.store(TotalSize(), std::memory_order_release);
+					// notify darf nur aufgerufen werden, wenn das mCV.wait-Prädikat true zurück gibt, sonst kann es passieren,
+					//  dass während des Ausführens eines False-Prädikats ein weiterer notify-Aufruf verschluckt wird,
+					//  dessen Prädikat true zurück geben würde. Pop() würde weiterhin ungewollt blockieren.
+					if(TotalSize() != 0)
 					{
 						if(mIsClosed.load(std::memory_order_relaxed))
 							mCV.notify_all();
@@ -688,15 +852,286 @@ namespace tiel::concurrent::container
 					return optValue;
 				}
 			}
-			return {};
+			return PopSpilled();
+		}
+
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Aktiviert das Auslagern in Segmentdateien: Sobald mehr als options.memoryThreshold
+		///			Elemente im Speicher liegen, werden neue Elemente serialisiert in eingeblendete,
+		///			nur angehängte Segmentdateien geschrieben.
+		/// @remark	Die FIFO-Reihenfolge bleibt erhalten: solange ausgelagerte Elemente existieren,
+		///			werden auch alle weiteren Elemente ausgelagert. Ist der Speicheranteil leer, liefert
+		///			Pop() die ausgelagerten Elemente direkt aus dem eingeblendeten Segment. Vollständig
+		///			gelesene Segmentdateien werden gelöscht.
+		///			Push() gibt false zurück, wenn ein Element nicht ausgelagert werden konnte.
+		/// @param options [in]:	Verzeichnis, Speicherschwelle und Segmentgröße
+		/// @return					true, wenn das Auslagern aktiviert wurde, false wenn es bereits aktiv ist.
+		bool EnableSpill(SpillOptions options) requires Serializable<T>
+		{
+			//_ASSERT(false); // not tested
+			std::lock_guard lock(mMutex);
+			if(mSpillStore)
+			{
+				return false;
+			}
+			mSpillThreshold = options.memoryThreshold;
+			mSpillStore		= std::make_unique<SpillStore<T>>(std::move(options));
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der in Segmentdateien ausgelagerten Elemente zurück.
+		[[nodiscard]] size_t SpilledSize() const
+		{
+			std::lock_guard lock(mMutex);
+			return mSpillStore ? mSpillStore->Size() : 0;
+		}
+
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entnimmt alle Elemente und schreibt diese in eine Snapshot-Datei (siehe Restore()).
+		/// @remark	mMutex wird nur zum Austauschen der internen Queue (und ggf. der Segmentdateien)
+		///			gehalten, das Schreiben erfolgt ohne Sperre. Ausgelagerte Elemente werden ohne erneute
+		///			Serialisierung aus den Segmentdateien kopiert. Schlägt das Schreiben fehl, werden die
+		///			Elemente in ursprünglicher Reihenfolge vor die zwischenzeitlich hinzugefügten Elemente
+		///			zurückgelegt.
+		///			Für einen geplanten Neustart wird die Queue typischerweise zuvor mit Close() geschlossen.
+		/// @param path [in]:	Pfad der Snapshot-Datei. Eine vorhandene Datei wird ersetzt.
+		/// @return				true, wenn alle Elemente geschrieben wurden. Die Queue ist dann leer.
+		bool Snapshot(const std::filesystem::path& path) requires Serializable<T>
+		{
+			//_ASSERT(false); // not tested
+			std::queue<T>					elements;
+			std::unique_ptr<SpillStore<T>>	spilled;
+			{
+				std::lock_guard lock(mMutex);
+				std::swap(elements, mQueue);
+				if(mSpillStore && !mSpillStore->IsEmpty())
+				{
+					spilled = std::exchange(mSpillStore, std::make_unique<SpillStore<T>>(mSpillStore->Options()));
+				}
+				mQueueSize.store(TotalSize(), std::memory_order_release);
+			}
+			if(QueueSnapshotFile::Write(path, elements, spilled.get()))
+			{
+				return true;
+			}
+			{
+				std::lock_guard lock(mMutex);
+				// Reihenfolge: alter Speicheranteil | alte Segmente | aktueller Speicheranteil | aktuelle Segmente
+				bool isSpilled = true;
+				while(spilled && !mQueue.empty() && (isSpilled = spilled->Push(mQueue.front())))
+				{
+					mQueue.pop();
+				}
+				if(spilled && isSpilled)
+				{
+					spilled->Append(std::move(*mSpillStore));
+					mSpillStore = std::move(spilled);
+				}
+				else
+				{
+					// aktueller Speicheranteil konnte nicht ausgelagert werden: die alten Segmente werden
+					// nur gelesen und in den Speicher zurückgeholt, damit kein Element verloren geht
+					while(spilled && !spilled->IsEmpty())
+					{
+						elements.push(spilled->Pop().value());
+					}
+					while(!mQueue.empty())
+					{
+						if constexpr(std::is_move_assignable<T>::value)
+						{
+							elements.push(std::move(mQueue.front()));
+						}
+						else
+						{
+							elements.push(mQueue.front());
+						}
+						mQueue.pop();
+					}
+				}
+				std::swap(elements, mQueue);
+				mQueueSize.store(TotalSize(), std::memory_order_release);
+			}
+			mCV.notify_all();
+			return false;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Liest alle Elemente einer mit Snapshot() geschriebenen Datei ein und hängt diese an
+		///			das Ende der Queue an.
+		/// @remark	Die Datei wird eingeblendet und die Elemente werden ohne Sperre direkt aus dem
+		///			eingeblendeten Speicher erzeugt. Anschließend werden sie mit einer einzigen Sperre
+		///			übernommen (bei leerer Queue durch Austauschen in O(1)). Bei aktiviertem Auslagern
+		///			werden Datensätze oberhalb der Speicherschwelle unverändert in Segmentdateien kopiert.
+		/// @param path [in]:	Pfad der Snapshot-Datei
+		/// @return				true, wenn alle Elemente übernommen wurden. false, wenn die Datei ungültig,
+		///						die Queue geschlossen ist oder Elemente nicht ausgelagert werden konnten.
+		///						In diesem Fall bleibt die Queue unverändert.
+		bool Restore(const std::filesystem::path& path) requires Serializable<T>
+		{
+			//_ASSERT(false); // not tested
+			QueueSnapshotFile				file;
+			std::queue<T>					elements;
+			std::unique_ptr<SpillStore<T>>	spilled;
+			std::optional<SpillOptions>		spillOptions;
+			bool							isSpilled		= true;
+
+			if(!file.template Open<T>(path))
+			{
+				return false;
+			}
+			{
+				std::lock_guard lock(mMutex);
+				if(mSpillStore)
+				{
+					spillOptions = mSpillStore->Options();
+				}
+			}
+			const bool isValid = file.template ForEachRecord<T>([&](const std::byte* pRecord, size_t recordSize)
+				{
+					if(!spillOptions.has_value() || (elements.size() < spillOptions->memoryThreshold))
+					{
+						T value = SerializedRecord::Read<T>(pRecord);
+						if constexpr(std::is_move_assignable<T>::value)
+						{
+							elements.push(std::move(value));
+						}
+						else
+						{
+							elements.push(value);
+						}
+					}
+					else
+					{
+						if(!spilled)
+						{
+							spilled = std::make_unique<SpillStore<T>>(spillOptions.value());
+						}
+						isSpilled = spilled->PushRecord(pRecord, recordSize) && isSpilled;
+					}
+				});
+			if(!isValid || !isSpilled)
+			{
+				return false;
+			}
+			{
+				std::lock_guard lock(mMutex);
+				if(mIsClosed.load(std::memory_order_acquire))
+				{
+					return false;
+				}
+				if((TotalSize() == 0) && (!spilled || mSpillStore))
+				{
+					std::swap(elements, mQueue);
+					if(spilled)
+					{
+						std::swap(spilled, mSpillStore);
+					}
+				}
+				else
+				{
+					size_t							numInMemory = elements.size();
+					std::unique_ptr<SpillStore<T>>	staged;
+					if(mSpillStore)
+					{
+						// Elemente ab der Speicherschwelle zuerst vollständig in einen eigenen SpillStore
+						// schreiben, damit die Queue bei einem Schreibfehler unverändert bleibt
+						numInMemory = MustSpill() ? 0 : (std::min)(elements.size(), mSpillThreshold - mQueue.size());
+						staged		= std::make_unique<SpillStore<T>>(mSpillStore->Options());
+						const auto& container = QueueSnapshotFile::ContainerOf(elements);
+						for(size_t i = numInMemory; i < container.size(); i++)
+						{
+							if(!staged->Push(container[i]))
+							{
+								return false;
+							}
+						}
+						if(spilled)
+						{
+							staged->Append(std::move(*spilled));
+						}
+					}
+					for(size_t i = 0; i < numInMemory; i++)
+					{
+						if constexpr(std::is_move_assignable<T>::value)
+						{
+							mQueue.push(std::move(elements.front()));
+						}
+						else
+						{
+							mQueue.push(elements.front());
+						}
+						elements.pop();
+					}
+					if(staged)
+					{
+						mSpillStore->Append(std::move(*staged));
+					}
+					while(spilled && !spilled->IsEmpty())
+					{
+						mQueue.push(spilled->Pop().value());
+					}
+				}
+				mQueueSize.store(TotalSize(), std::memory_order_release);
+			}
+			mCV.notify_all();
+			return true;
 		}
 
 	private:
-		std::condition_variable	mCV;
-		mutable std::mutex		mMutex;
-		std::queue<T>			mQueue;
-		std::atomic_bool		mIsClosed			= false;
-		std::atomic_size_t		mQueueSize			= 0;
+		///----------------------------------------------------------------------------------------------
+		/// Anzahl Elemente im Speicher und in den Segmentdateien (mMutex muss gehalten werden)
+		size_t TotalSize() const
+		{
+			return mQueue.size() + (mSpillStore ? mSpillStore->Size() : 0);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Prüft, ob ein neues Element ausgelagert werden muss (mMutex muss gehalten werden)
+		bool MustSpill() const
+		{
+			return mSpillStore && (!mSpillStore->IsEmpty() || (mQueue.size() >= mSpillThreshold));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Lagert das Element in die Segmentdateien aus (mMutex muss gehalten werden)
+		bool PushSpilled(const T& value)
+		{
+			if constexpr(Serializable<T>)
+			{
+				return mSpillStore->Push(value);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Entnimmt das älteste ausgelagerte Element (mMutex muss gehalten werden)
+		std::optional<T> PopSpilled()
+		{
+			if constexpr(Serializable<T>)
+			{
+				if(mSpillStore && !mSpillStore->IsEmpty())
+				{
+					std::optional<T> optValue = mSpillStore->Pop();
+					mQueueSize.store(TotalSize(), std::memory_order_release);
+					if(TotalSize() != 0)
+					{
+						if(mIsClosed.load(std::memory_order_relaxed))
+							mCV.notify_all();
+						else
+							mCV.notify_one();
+					}
+					return optValue;
+				}
+			}
+			return {};
+		}
+
+		std::condition_variable			mCV;
+		mutable std::mutex				mMutex;
+		std::queue<T>					mQueue;
+		std::atomic_bool				mIsClosed			= false;
+		std::atomic_size_t				mQueueSize			= 0;
+		std::unique_ptr<SpillStore<T>>	mSpillStore;		// nur bei aktiviertem Auslagern
+		size_t							mSpillThreshold		= (std::numeric_limits<size_t>::max)();
 	}; // class BlockingQueue
 
 } // namespace asentics::concurrent::container
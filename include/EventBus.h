@@ -0,0 +1,561 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CallbackDispatch.h"
+#include "HazardPointer.h"
+
+namespace tiel::concurrent
+{
+	//________________________________________________________________________________________________
+	/// @brief	Ereignisbus, der Abonnenten nach Topics indiziert.
+	/// @remark	Topics bestehen aus durch '/' getrennten Ebenen, z.B. "sensor/42/temperature".
+	///			Exakte Topics liegen in einer Hash-Tabelle mit NumShards Teilen. Jeder Teil wird als
+	///			unveränderliche Tabelle über einen rohen atomaren Zeiger veröffentlicht und von Publish()
+	///			per HazardPointer gelesen: Publish() nimmt keine Sperre und schreibt keinen gemeinsamen
+	///			Zustand. Subscribe() und Unsubscribe() sperren nur den betroffenen Teil und kopieren dessen
+	///			Tabelle nur, wenn ein Topic hinzukommt oder wegfällt; die abgelöste Tabelle wird
+	///			freigegeben, sobald sie kein Publish() mehr liest.
+	///			Jedes Topic hält nur eine schlanke, ebenso veröffentlichte Liste seiner Abonnenten
+	///			(Callback und Handle), die beim An- und Abmelden kopiert wird. Das Postfach eines
+	///			Abonnenten (detail::Mailbox, siehe CallbackDispatch.h) entsteht erst beim ersten
+	///			PublishQueued().
+	///			Muster-Abonnements verwenden die Platzhalter "+" (genau eine Ebene) und "#" (nur als letzte
+	///			Ebene, beliebig viele auch keine weiteren Ebenen), z.B. "sensor/+/temperature" oder
+	///			"sensor/#". Die Muster werden bei jeder Änderung der Mustermenge in einen unveränderlichen
+	///			Trie übersetzt und ebenso veröffentlicht, Publish() durchläuft ihn ohne Sperre und ohne
+	///			Allokation.
+	//	@param	Args	Callback-Parameter
+	template <class ... Args>
+	class EventBus final
+	{
+	public:
+		using CallbackType		= std::function<void(const Args& ...)>;
+		using CallbackHandle	= int64_t;	// fortlaufend je EventBus, -1: ungültig
+
+		static constexpr size_t NumShards = 256;
+
+		///_________________________________________________________________________________________________
+		/// Abonnement, wird von Subscribe() zurückgegeben und von Unsubscribe() benötigt
+		struct Subscription
+		{
+			std::string		topic;			// Topic bzw. Muster
+			CallbackHandle	handle = -1;	// -1: ungültiges Abonnement
+
+			[[nodiscard]] bool IsValid() const
+			{
+				return handle >= 0;
+			}
+		};
+
+	private:
+		using ArgumentTuple		= std::tuple<std::decay_t<Args>...>;
+		using SharedArguments	= std::shared_ptr<const ArgumentTuple>;	// von allen Postfächern eines Ereignisses geteilt
+
+		///_________________________________________________________________________________________________
+		/// Abonnent eines Topics bzw. Musters, zugleich Aufrufziel seines Postfachs (siehe
+		/// CallbackDispatch.h). Eine eingeplante Zustellung hält einen Anteil am Abonnenten.
+		class Subscriber final
+		{
+		public:
+			using ArgumentTuple	= EventBus::ArgumentTuple;
+			using MailboxType	= detail::Mailbox<Subscriber>;
+
+			Subscriber(CallbackHandle handle, CallbackType callback, const MailboxOptions& mailboxOptions)
+				: mHandle(handle)
+				, mCallback(std::move(callback))
+				, mMailboxOptions(mailboxOptions)
+			{}
+			Subscriber(const Subscriber&) = delete;
+			Subscriber& operator=(const Subscriber&) = delete;
+			~Subscriber()
+			{
+				delete mpMailbox.load(std::memory_order_acquire);
+			}
+			CallbackHandle Handle() const
+			{
+				return mHandle;
+			}
+			void Call(const Args& ... args) const
+			{
+				mCallback(args...);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Gibt das Postfach zurück und legt es beim ersten Bedarf an
+			MailboxType& GetMailbox()
+			{
+				MailboxType* pMailbox = mpMailbox.load(std::memory_order_acquire);
+				if(pMailbox == nullptr)
+				{
+					MailboxType* const pNew = new MailboxType(mMailboxOptions, *this);
+					if(mpMailbox.compare_exchange_strong(pMailbox, pNew, std::memory_order_acq_rel, std::memory_order_acquire))
+					{
+						return *pNew;
+					}
+					delete pNew;
+				}
+				return *pMailbox;
+			}
+			///------------------------------------------------------------------------------------------
+			/// Aufrufziel (siehe CallbackDispatch.h), Abonnenten sind keine Coroutinen
+			void Invoke(const ArgumentTuple& args) const
+			{
+				std::apply(mCallback, args);
+			}
+			bool IsTask() const
+			{
+				return false;
+			}
+			CallbackTask InvokeTask(const ArgumentTuple&) const
+			{
+				return {};
+			}
+			EventLoop* Loop() const
+			{
+				return nullptr;
+			}
+		private:
+			const CallbackHandle		mHandle;
+			const CallbackType			mCallback;
+			const MailboxOptions		mMailboxOptions;
+			std::atomic<MailboxType*>	mpMailbox	= nullptr;	// nullptr, bis PublishQueued() es benötigt
+		};
+		using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+		///_________________________________________________________________________________________________
+		/// Abonnenten eines Topics bzw. Musters. Die Liste ist unveränderlich und wird von Publish()
+		/// per HazardPointer gelesen; das Topic selbst lebt, solange es eine Tabelle bzw. ein Trie enthält.
+		struct Topic
+		{
+			std::atomic<const SubscriberList*>		pSubscribers	{ nullptr };	// nullptr: keine Abonnenten
+			std::unique_ptr<const SubscriberList>	pOwnedSubscribers;				// nur unter der Sperre des Teils bzw. mPatternMutex
+		};
+		using SubscriberRetireList = HazardRetireList<std::unique_ptr<const SubscriberList>>;
+
+		///_________________________________________________________________________________________________
+		/// Transparenter Hash, damit mit std::string_view ohne Kopie gesucht werden kann
+		struct TopicHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view topic) const noexcept
+			{
+				return std::hash<std::string_view>()(topic);
+			}
+		};
+		using TopicTable = std::unordered_map<std::string, std::shared_ptr<Topic>, TopicHash, std::equal_to<>>;
+
+		///_________________________________________________________________________________________________
+		/// Teil der Topic-Tabelle, je Cache-Line ein Teil
+		struct alignas(64) Shard
+		{
+			std::atomic<const TopicTable*>						pTable		{ nullptr };	// nullptr: leere Tabelle
+			std::mutex											mutex;					// serialisiert Änderungen
+			std::unique_ptr<const TopicTable>					pOwnedTable;			// nur unter mutex
+			HazardRetireList<std::unique_ptr<const TopicTable>>	retiredTables;			// nur unter mutex
+			SubscriberRetireList								retiredSubscribers;		// nur unter mutex
+		};
+
+		///_________________________________________________________________________________________________
+		/// Knoten des unveränderlichen Muster-Tries
+		struct TrieNode
+		{
+			std::unordered_map<std::string, std::unique_ptr<TrieNode>, TopicHash, std::equal_to<>>	children;
+			std::unique_ptr<TrieNode>	pSingleLevel;		// "+"
+			std::shared_ptr<Topic>		pTopic;				// Muster endet in diesem Knoten
+			std::shared_ptr<Topic>		pMultiLevelTopic;	// Muster endet mit "#" nach diesem Knoten
+		};
+
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Standard-Konstruktor, die Postfächer verwenden CallbackDispatchExecutor()
+		EventBus() = default;
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor
+		/// @param executor		Executor der Postfächer (PublishQueued()). Muss den EventBus überleben.
+		explicit EventBus(ThreadPoolExecutor& executor)
+			: mExecutor(&executor)
+		{}
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist weder kopier- noch verschiebbar
+		EventBus(const EventBus&) = delete;
+		EventBus& operator=(const EventBus&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Meldet einen Callback für ein Topic oder Muster an.
+		/// @param topic			Topic bzw. Muster mit den Platzhaltern "+" und "#"
+		/// @param callback			aufrufbares Objekt
+		/// @param mailboxOptions	Größe und Überlauf-Policy des Postfachs für PublishQueued()
+		/// @return					Abonnement, ungültig, wenn "#" nicht die letzte Ebene des Musters ist
+		[[nodiscard]] Subscription Subscribe(std::string_view topic, CallbackType callback, const MailboxOptions& mailboxOptions = {})
+		{
+			if(IsPattern(topic) && !IsValidPattern(topic))
+			{
+				return {};
+			}
+			const CallbackHandle	handle		= mNextHandle.fetch_add(1, std::memory_order_relaxed);
+			auto					pSubscriber	= std::make_shared<Subscriber>(handle, std::move(callback), mailboxOptions);
+			if(!IsPattern(topic))
+			{
+				Shard&					shard	= ShardOf(topic);
+				std::lock_guard			lock(shard.mutex);
+				const TopicTable*		pTable	= shard.pOwnedTable.get();
+				std::shared_ptr<Topic>	pTopic	= FindTopic(pTable, topic);
+				if(pTopic == nullptr)
+				{
+					pTopic = std::make_shared<Topic>();
+					auto pNewTable = (pTable != nullptr) ? std::make_unique<TopicTable>(*pTable) : std::make_unique<TopicTable>();
+					pNewTable->emplace(std::string(topic), pTopic);
+					PublishTable(shard, std::move(pNewTable));
+				}
+				AddSubscriber(*pTopic, std::move(pSubscriber), shard.retiredSubscribers);
+				return { std::string(topic), handle };
+			}
+
+			std::lock_guard lock(mPatternMutex);
+			auto it = mPatterns.find(topic);
+			if(it == mPatterns.end())
+			{
+				it = mPatterns.emplace(std::string(topic), std::make_shared<Topic>()).first;
+				AddSubscriber(*it->second, std::move(pSubscriber), mRetiredPatternSubscribers);
+				PublishPatternTrie();
+			}
+			else
+			{
+				AddSubscriber(*it->second, std::move(pSubscriber), mRetiredPatternSubscribers);
+			}
+			return { std::string(topic), handle };
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Meldet ein Abonnement ab. Topics bzw. Muster ohne Callbacks werden entfernt.
+		/// @remark	Ein gleichzeitig laufender Publish()-Aufruf kann den Callback noch aufrufen.
+		/// @param subscription		von Subscribe() zurückgegebenes Abonnement
+		/// @return					true, wenn das Abonnement bestand
+		bool Unsubscribe(const Subscription& subscription)
+		{
+			if(!subscription.IsValid())
+			{
+				return false;
+			}
+			if(!IsPattern(subscription.topic))
+			{
+				Shard&							shard	= ShardOf(subscription.topic);
+				std::lock_guard					lock(shard.mutex);
+				const TopicTable*				pTable	= shard.pOwnedTable.get();
+				const std::shared_ptr<Topic>	pTopic	= FindTopic(pTable, subscription.topic);
+				if((pTopic == nullptr) || !RemoveSubscriber(*pTopic, subscription.handle, shard.retiredSubscribers))
+				{
+					return false;
+				}
+				if(pTopic->pOwnedSubscribers == nullptr)
+				{
+					auto pNewTable = std::make_unique<TopicTable>(*pTable);
+					pNewTable->erase(subscription.topic);
+					PublishTable(shard, pNewTable->empty() ? nullptr : std::move(pNewTable));
+				}
+				return true;
+			}
+
+			std::lock_guard lock(mPatternMutex);
+			auto it = mPatterns.find(subscription.topic);
+			if((it == mPatterns.end()) || !RemoveSubscriber(*it->second, subscription.handle, mRetiredPatternSubscribers))
+			{
+				return false;
+			}
+			if(it->second->pOwnedSubscribers == nullptr)
+			{
+				mPatterns.erase(it);
+				PublishPatternTrie();
+			}
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft die Callbacks des Topics und aller passenden Muster nacheinander auf.
+		/// @remark	Es wird keine Sperre gehalten. Exception innerhalb der Callbacks werden nicht behandelt.
+		/// @param topic		Topic ohne Platzhalter
+		/// @param ...args		Callback-Argumente
+		/// @return				Anzahl der passenden Topics und Muster
+		size_t Publish(std::string_view topic, const Args& ... args)
+		{
+			return ForEachTopic(topic, [&](const SubscriberList& subscribers)
+				{
+					for(const std::shared_ptr<Subscriber>& pSubscriber : subscribers)
+					{
+						pSubscriber->Call(args...);
+					}
+				});
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt das Ereignis in den Postfächern der Callbacks des Topics und aller passenden Muster
+		///			ab. Jedes Postfach stellt seine Ereignisse der Reihe nach im Executor zu (siehe
+		///			MailboxOptions), alle Postfächer teilen sich eine Kopie der Argumente.
+		/// @param topic		Topic ohne Platzhalter
+		/// @param ...args		Callback-Argumente
+		/// @return				Anzahl der passenden Topics und Muster
+		size_t PublishQueued(std::string_view topic, const Args& ... args)
+		{
+			SharedArguments pArgs;
+			return ForEachTopic(topic, [&](const SubscriberList& subscribers)
+				{
+					if(pArgs == nullptr)
+					{
+						pArgs = std::make_shared<const ArgumentTuple>(args...);
+					}
+					for(const std::shared_ptr<Subscriber>& pSubscriber : subscribers)
+					{
+						(void)pSubscriber->GetMailbox().Post(*mExecutor, pSubscriber, pArgs);
+					}
+				});
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der exakten Topics mit mindestens einem Callback zurück.
+		[[nodiscard]] size_t NumTopics() const
+		{
+			size_t numTopics = 0;
+			for(const Shard& shard : mShards)
+			{
+				const HazardPointer<const TopicTable> pTable(shard.pTable);
+				numTopics += (pTable.Get() != nullptr) ? pTable->size() : 0;
+			}
+			return numTopics;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der Muster mit mindestens einem Callback zurück.
+		[[nodiscard]] size_t NumPatterns() const
+		{
+			std::lock_guard lock(mPatternMutex);
+			return mPatterns.size();
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Ruft func mit den Abonnenten des Topics und aller passenden Muster auf
+		template <class Func>
+		size_t ForEachTopic(std::string_view topic, Func&& func)
+		{
+			size_t numTopics = 0;
+			// die Tabelle bzw. der Trie hält das Topic, die Liste wird zusätzlich geschützt
+			auto onTopic = [&](const Topic& matched)
+				{
+					const HazardPointer<const SubscriberList> pSubscribers(matched.pSubscribers);
+					if(pSubscribers.Get() != nullptr)
+					{
+						func(*pSubscribers);
+						numTopics++;
+					}
+				};
+			{
+				const HazardPointer<const TopicTable> pTable(ShardOf(topic).pTable);
+				if(pTable.Get() != nullptr)
+				{
+					if(const auto it = pTable->find(topic); it != pTable->end())
+					{
+						onTopic(*it->second);
+					}
+				}
+			}
+			if(mHasPatterns.load(std::memory_order_acquire))
+			{
+				const HazardPointer<const TrieNode> pTrie(mpPatternTrie);
+				if(pTrie.Get() != nullptr)
+				{
+					Match(*pTrie, topic, 0, onTopic);
+				}
+			}
+			return numTopics;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Sucht ab Position pos des Topics die passenden Muster im Teilbaum "node"
+		template <class Func>
+		static void Match(const TrieNode& node, std::string_view topic, size_t pos, Func& func)
+		{
+			if(node.pMultiLevelTopic != nullptr)
+			{
+				func(*node.pMultiLevelTopic);
+			}
+			if(pos > topic.size())
+			{
+				// alle Ebenen verbraucht
+				if(node.pTopic != nullptr)
+				{
+					func(*node.pTopic);
+				}
+				return;
+			}
+			const size_t			end		= (std::min)(topic.find('/', pos), topic.size());
+			const std::string_view	level	= topic.substr(pos, end - pos);
+			if(const auto it = node.children.find(level); it != node.children.end())
+			{
+				Match(*it->second, topic, end + 1, func);
+			}
+			if(node.pSingleLevel != nullptr)
+			{
+				Match(*node.pSingleLevel, topic, end + 1, func);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Übersetzt die Muster in einen neuen Trie und veröffentlicht ihn. mPatternMutex muss gehalten
+		/// werden.
+		void PublishPatternTrie()
+		{
+			std::unique_ptr<TrieNode> pRoot;
+			if(!mPatterns.empty())
+			{
+				pRoot = std::make_unique<TrieNode>();
+				for(const auto& [pattern, pTopic] : mPatterns)
+				{
+					TrieNode* pNode = pRoot.get();
+					for(size_t pos = 0; pos <= pattern.size(); )
+					{
+						const size_t			end		= (std::min)(pattern.find('/', pos), pattern.size());
+						const std::string_view	level	= std::string_view(pattern).substr(pos, end - pos);
+						pos = end + 1;
+						if(level == "#")
+						{
+							pNode->pMultiLevelTopic = pTopic;
+							pNode = nullptr;
+							break;
+						}
+						std::unique_ptr<TrieNode>* ppChild;
+						if(level == "+")
+						{
+							ppChild = &pNode->pSingleLevel;
+						}
+						else
+						{
+							ppChild = &pNode->children[std::string(level)];
+						}
+						if(*ppChild == nullptr)
+						{
+							*ppChild = std::make_unique<TrieNode>();
+						}
+						pNode = ppChild->get();
+					}
+					if(pNode != nullptr)
+					{
+						pNode->pTopic = pTopic;
+					}
+				}
+			}
+			mHasPatterns.store(pRoot != nullptr, std::memory_order_release);
+			mpPatternTrie.store(pRoot.get(), std::memory_order_seq_cst);
+			mRetiredTries.Retire(std::exchange(mpOwnedPatternTrie, std::move(pRoot)));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Veröffentlicht die neue Tabelle des Teils (nullptr: leer) und gibt die abgelöste frei, sobald
+		/// sie kein Publish() mehr liest. shard.mutex muss gehalten werden.
+		static void PublishTable(Shard& shard, std::unique_ptr<const TopicTable> pNewTable)
+		{
+			shard.pTable.store(pNewTable.get(), std::memory_order_seq_cst);
+			shard.retiredTables.Retire(std::exchange(shard.pOwnedTable, std::move(pNewTable)));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Hängt den Abonnenten an eine Kopie der Liste an und veröffentlicht sie. Die Sperre des
+		/// Topics muss gehalten werden.
+		static void AddSubscriber(Topic& topic, std::shared_ptr<Subscriber> pSubscriber, SubscriberRetireList& retired)
+		{
+			auto pNewSubscribers = (topic.pOwnedSubscribers != nullptr) ? std::make_unique<SubscriberList>(*topic.pOwnedSubscribers)
+																		: std::make_unique<SubscriberList>();
+			pNewSubscribers->push_back(std::move(pSubscriber));
+			PublishSubscribers(topic, std::move(pNewSubscribers), retired);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Entfernt den Abonnenten aus einer Kopie der Liste und veröffentlicht sie (nullptr, wenn sie
+		/// leer wird). Die Sperre des Topics muss gehalten werden.
+		/// @return		false, wenn das Topic keinen Abonnenten mit dem Handle hat
+		static bool RemoveSubscriber(Topic& topic, CallbackHandle handle, SubscriberRetireList& retired)
+		{
+			const SubscriberList* const pSubscribers = topic.pOwnedSubscribers.get();
+			if(pSubscribers == nullptr)
+			{
+				return false;
+			}
+			const auto it = std::find_if(pSubscribers->begin(), pSubscribers->end(),
+										 [handle](const std::shared_ptr<Subscriber>& pSubscriber) { return pSubscriber->Handle() == handle; });
+			if(it == pSubscribers->end())
+			{
+				return false;
+			}
+			std::unique_ptr<SubscriberList> pNewSubscribers;
+			if(pSubscribers->size() > 1)
+			{
+				pNewSubscribers = std::make_unique<SubscriberList>();
+				pNewSubscribers->reserve(pSubscribers->size() - 1);
+				pNewSubscribers->insert(pNewSubscribers->end(), pSubscribers->begin(), it);
+				pNewSubscribers->insert(pNewSubscribers->end(), it + 1, pSubscribers->end());
+			}
+			PublishSubscribers(topic, std::move(pNewSubscribers), retired);
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Veröffentlicht die neue Liste des Topics (nullptr: keine Abonnenten) und gibt die abgelöste
+		/// frei, sobald sie kein Publish() mehr liest
+		static void PublishSubscribers(Topic& topic, std::unique_ptr<const SubscriberList> pNewSubscribers, SubscriberRetireList& retired)
+		{
+			topic.pSubscribers.store(pNewSubscribers.get(), std::memory_order_seq_cst);
+			retired.Retire(std::exchange(topic.pOwnedSubscribers, std::move(pNewSubscribers)));
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Gibt das Topic in der Tabelle zurück bzw. nullptr
+		static std::shared_ptr<Topic> FindTopic(const TopicTable* pTable, std::string_view topic)
+		{
+			if(pTable == nullptr)
+			{
+				return nullptr;
+			}
+			const auto it = pTable->find(topic);
+			return (it != pTable->end()) ? it->second : nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// true, wenn eine Ebene des Topics ein Platzhalter ist
+		static bool IsPattern(std::string_view topic)
+		{
+			for(size_t pos = 0; pos <= topic.size(); )
+			{
+				const size_t			end		= (std::min)(topic.find('/', pos), topic.size());
+				const std::string_view	level	= topic.substr(pos, end - pos);
+				if((level == "+") || (level == "#"))
+				{
+					return true;
+				}
+				pos = end + 1;
+			}
+			return false;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// true, wenn "#" höchstens als letzte Ebene vorkommt
+		static bool IsValidPattern(std::string_view pattern)
+		{
+			const size_t pos = pattern.find("#");
+			return (pos == std::string_view::npos) || (pos == pattern.size() - 1);
+		}
+		///----------------------------------------------------------------------------------------------
+		Shard& ShardOf(std::string_view topic)
+		{
+			return mShards[TopicHash()(topic) & (NumShards - 1)];
+		}
+
+		static_assert((NumShards & (NumShards - 1)) == 0, "EventBus: NumShards muss eine Zweierpotenz sein");
+
+		ThreadPoolExecutor*													mExecutor		= &CallbackDispatchExecutor();
+		std::atomic<CallbackHandle>											mNextHandle		= 0;
+		std::array<Shard, NumShards>										mShards;
+		mutable std::mutex													mPatternMutex;	// serialisiert Änderungen der Muster
+		std::map<std::string, std::shared_ptr<Topic>, std::less<>>			mPatterns;		// nur unter mPatternMutex
+		SubscriberRetireList												mRetiredPatternSubscribers;	// nur unter mPatternMutex
+		std::atomic_bool													mHasPatterns	= false;
+		std::atomic<const TrieNode*>										mpPatternTrie	= nullptr;
+		std::unique_ptr<const TrieNode>										mpOwnedPatternTrie;	// nur unter mPatternMutex
+		HazardRetireList<std::unique_ptr<const TrieNode>>					mRetiredTries;		// nur unter mPatternMutex
+	}; // class EventBus
+
+} // namespace tiel::concurrent
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include "ConcurrentQueue.h"
+#include "ThreadPoolExecutor.h"
+
+namespace tiel::concurrent
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Ereignisschleife eines einzelnen Threads. Über die Schleife eingestellte Aufgaben werden
+	///			ausschließlich in diesem Thread ausgeführt (z.B. an die Schleife gebundene Callbacks,
+	///			siehe BasicCallbackHandler::AddCallback()).
+	/// @remark	Der Thread der Schleife ruft entweder Run() auf (blockiert bis Stop()) oder arbeitet die
+	///			Aufgaben aus seiner eigenen Schleife heraus per RunPending() ab. Er wird beim ersten
+	///			Aufruf von Run() bzw. RunPending() oder über BindToCurrentThread() festgelegt.
+	///			Die Aufgaben werden ohne Allokation über eine BlockingQueue eingestellt. Vor der
+	///			Zerstörung der Schleife müssen alle eingestellten Aufgaben ausgeführt worden sein.
+	class EventLoop final
+	{
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// Standard-Konstruktor
+		EventLoop() = default;
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist nicht kopierbar
+		EventLoop(const EventLoop&) = delete;
+		EventLoop& operator=(const EventLoop&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor
+		~EventLoop()
+		{
+			//_ASSERT(false); // not tested
+			_ASSERT(mTasks.IsEmpty());
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Stellt eine Aufgabe zur Ausführung im Thread der Schleife ein.
+		/// @remark	Die Aufgabe muss bis zu ihrer Ausführung gültig bleiben.
+		/// @param task [in]:	auszuführende Aufgabe
+		/// @return				false, wenn die Schleife bereits mit Stop() beendet wurde. Die Aufgabe wird
+		///						dann nicht ausgeführt.
+		bool Post(ExecutorTask& task)
+		{
+			//_ASSERT(false); // not tested
+			return mTasks.Push(&task);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt den aufrufenden Thread als Thread der Schleife fest.
+		void BindToCurrentThread()
+		{
+			//_ASSERT(false); // not tested
+			mThreadId.store(std::this_thread::get_id(), std::memory_order_release);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob der aufrufende Thread der Thread der Schleife ist.
+		[[nodiscard]] bool IsCurrentThread() const
+		{
+			return mThreadId.load(std::memory_order_acquire) == std::this_thread::get_id();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Führt die eingestellten Aufgaben im aufrufenden Thread aus, bis die Schleife mit Stop()
+		///			beendet wurde und alle bis dahin eingestellten Aufgaben ausgeführt sind.
+		void Run()
+		{
+			//_ASSERT(false); // not tested
+			BindToCurrentThread();
+			while(std::optional<ExecutorTask*> optTask = mTasks.Pop())
+			{
+				(*optTask)->Run();
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Führt die beim Aufruf bereits eingestellten Aufgaben im aufrufenden Thread aus, ohne
+		///			auf weitere Aufgaben zu warten.
+		/// @remark	Aufgaben, die sich während der Ausführung erneut einstellen, werden erst beim nächsten
+		///			Aufruf ausgeführt.
+		/// @return		Anzahl der ausgeführten Aufgaben
+		size_t RunPending()
+		{
+			//_ASSERT(false); // not tested
+			BindToCurrentThread();
+			size_t numTasks = 0;
+			for(size_t numQueued = mTasks.Size(); numTasks < numQueued; numTasks++)
+			{
+				std::optional<ExecutorTask*> optTask = mTasks.Pop(0);
+				if(!optTask.has_value())
+				{
+					break;
+				}
+				(*optTask)->Run();
+			}
+			return numTasks;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Beendet die Schleife. Run() kehrt zurück, sobald die bereits eingestellten Aufgaben
+		///			ausgeführt sind, weitere Aufgaben werden nicht mehr angenommen.
+		void Stop()
+		{
+			//_ASSERT(false); // not tested
+			mTasks.Close();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob die Schleife mit Stop() beendet wurde.
+		[[nodiscard]] bool IsStopped() const
+		{
+			return mTasks.IsClosed();
+		}
+
+	private:
+		container::BlockingQueue<ExecutorTask*>	mTasks;
+		std::atomic<std::thread::id>			mThreadId;
+	}; // class EventLoop
+
+} // namespace tiel::concurrent
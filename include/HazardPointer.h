@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tiel::concurrent
+{
+	namespace detail
+	{
+		//_________________________________________________________________________________________________
+		/// Hazard-Pointer-Slots eines Threads. Nur der besitzende Thread schreibt, Retire-Listen lesen
+		/// die Slots aller Threads beim Freigeben. Records werden nie freigegeben, sondern beim Ende
+		/// eines Threads für den nächsten neuen Thread freigeschaltet.
+		struct alignas(64) HazardRecord
+		{
+			static constexpr size_t NumSlots = 16;	// max. Verschachtelungstiefe ohne Überlauf
+
+			struct Slot
+			{
+				std::atomic<const void*>	pObject	= nullptr;	// geschütztes Objekt
+				std::atomic<const void*>	pOwner	= nullptr;	// Besitzer, z.B. der lesende CallbackHandler
+			};
+
+			std::array<Slot, NumSlots>	slots;
+			size_t						numUsed	= 0;			// belegte Slots, nur im besitzenden Thread
+			std::atomic_bool			isInUse	= true;
+			HazardRecord*				pNext	= nullptr;		// nach dem Einhängen unveränderlich
+		};
+
+		//_________________________________________________________________________________________________
+		/// Prozessweite Liste der HazardRecords aller Threads
+		class HazardRegistry final
+		{
+		public:
+			///----------------------------------------------------------------------------------------------
+			/// Gibt den Record des aufrufenden Threads zurück (beim ersten Aufruf belegt)
+			static HazardRecord& Current()
+			{
+				thread_local const ThreadRecord tRecord;
+				return *tRecord.pRecord;
+			}
+			///----------------------------------------------------------------------------------------------
+			/// Ruft func(slot) für alle Slots aller Threads auf
+			template <class Func>
+			static void ForEachSlot(Func&& func)
+			{
+				for(HazardRecord* pRecord = spHead.load(std::memory_order_acquire); pRecord != nullptr; pRecord = pRecord->pNext)
+				{
+					for(const HazardRecord::Slot& slot : pRecord->slots)
+					{
+						func(slot);
+					}
+				}
+			}
+			///----------------------------------------------------------------------------------------------
+			/// Anzahl der Leser, die mangels freiem Slot ungeschützt lesen (siehe HazardPointer)
+			static std::atomic_size_t& NumOverflowReaders()
+			{
+				return sNumOverflowReaders;
+			}
+
+		private:
+			///----------------------------------------------------------------------------------------------
+			/// Belegt beim ersten Zugriff eines Threads einen Record und gibt ihn am Threadende frei
+			struct ThreadRecord
+			{
+				HazardRecord* const pRecord = Acquire();
+				~ThreadRecord()
+				{
+					pRecord->isInUse.store(false, std::memory_order_release);
+				}
+			};
+			///----------------------------------------------------------------------------------------------
+			/// Übernimmt einen freigegebenen Record bzw. hängt einen neuen ein
+			static HazardRecord* Acquire()
+			{
+				for(HazardRecord* pRecord = spHead.load(std::memory_order_acquire); pRecord != nullptr; pRecord = pRecord->pNext)
+				{
+					bool isInUse = false;
+					if(!pRecord->isInUse.load(std::memory_order_relaxed) && pRecord->isInUse.compare_exchange_strong(isInUse, true, std::memory_order_acquire))
+					{
+						return pRecord;
+					}
+				}
+				HazardRecord* pRecord = new HazardRecord;
+				pRecord->pNext = spHead.load(std::memory_order_relaxed);
+				while(!spHead.compare_exchange_weak(pRecord->pNext, pRecord, std::memory_order_release, std::memory_order_relaxed))
+				{
+				}
+				return pRecord;
+			}
+
+			inline static std::atomic<HazardRecord*>	spHead				= nullptr;
+			inline static std::atomic_size_t			sNumOverflowReaders	= 0;
+		};
+	} // namespace detail
+
+	//_________________________________________________________________________________________________
+	/// @brief	Hazard Pointer: schützt ein über einen rohen atomaren Zeiger veröffentlichtes,
+	///			unveränderliches Objekt, solange der HazardPointer lebt.
+	/// @remark	Der Leser schreibt nur in den Slot seines eigenen Threads (kein Referenzzähler, kein
+	///			gemeinsamer Zähler), gleichzeitige Leser skalieren daher ohne Cache-Line-Transfers. Der
+	///			Schreiber veröffentlicht das neue Objekt und übergibt das abgelöste an eine
+	///			HazardRetireList, die es erst freigibt, wenn kein Slot mehr darauf verweist.
+	///			HazardPointer werden verschachtelt im selben Thread angelegt und in umgekehrter
+	///			Reihenfolge zerstört (nur als lokale Variable, nicht über einen Unterbrechungspunkt einer
+	///			Coroutine hinweg). Ab einer Verschachtelungstiefe von HazardRecord::NumSlots wird ein
+	///			gemeinsamer Zähler verwendet, während dessen keine HazardRetireList freigibt.
+	/// @tparam T	Typ des geschützten Objekts
+	template <class T>
+	class HazardPointer final
+	{
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Liest "source" und schützt das gelesene Objekt.
+		/// @param source [in]:	veröffentlichter Zeiger
+		/// @param pOwner [in]:	wird für IsOwnerActive() vermerkt, z.B. das lesende Objekt
+		explicit HazardPointer(const std::atomic<T*>& source, const void* pOwner = nullptr) noexcept
+		{
+			detail::HazardRecord& record = *(mpRecord = &detail::HazardRegistry::Current());
+			if(record.numUsed == detail::HazardRecord::NumSlots)
+			{
+				detail::HazardRegistry::NumOverflowReaders().fetch_add(1, std::memory_order_seq_cst);
+				mpObject = source.load(std::memory_order_seq_cst);
+				return;
+			}
+			mpSlot = &record.slots[record.numUsed++];
+			mpSlot->pOwner.store(pOwner, std::memory_order_relaxed);
+
+			T* pObject = source.load(std::memory_order_relaxed);
+			for(;;)
+			{
+				mpSlot->pObject.store(pObject, std::memory_order_seq_cst);
+				T* const pCurrent = source.load(std::memory_order_seq_cst);
+				if(pCurrent == pObject)
+				{
+					break;
+				}
+				pObject = pCurrent;
+			}
+			mpObject = pObject;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, gibt das Objekt frei
+		~HazardPointer()
+		{
+			if(mpSlot == nullptr)
+			{
+				detail::HazardRegistry::NumOverflowReaders().fetch_sub(1, std::memory_order_release);
+				return;
+			}
+			mpSlot->pObject.store(nullptr, std::memory_order_release);
+			mpSlot->pOwner.store(nullptr, std::memory_order_relaxed);
+			mpRecord->numUsed--;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist weder kopier- noch verschiebbar
+		HazardPointer(const HazardPointer&) = delete;
+		HazardPointer& operator=(const HazardPointer&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt das geschützte Objekt zurück (nullptr, wenn "source" nullptr war).
+		[[nodiscard]] T* Get() const noexcept
+		{
+			return mpObject;
+		}
+		T* operator->() const noexcept
+		{
+			return mpObject;
+		}
+		T& operator*() const noexcept
+		{
+			return *mpObject;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft (NICHT blockierend), ob ein Thread gerade einen HazardPointer mit dem Besitzer
+		///			pOwner hält.
+		/// @remark	Liest die Slots aller Threads, gedacht für seltene Abfragen. Liest ein Thread
+		///			ungeschützt (Überlauf), wird vorsichtshalber true zurückgegeben.
+		[[nodiscard]] static bool IsOwnerActive(const void* pOwner) noexcept
+		{
+			bool isActive = detail::HazardRegistry::NumOverflowReaders().load(std::memory_order_relaxed) != 0;
+			detail::HazardRegistry::ForEachSlot([&](const detail::HazardRecord::Slot& slot)
+				{
+					isActive = isActive || (slot.pOwner.load(std::memory_order_relaxed) == pOwner);
+				});
+			return isActive;
+		}
+
+	private:
+		detail::HazardRecord*		mpRecord	= nullptr;	// Record des lesenden Threads
+		detail::HazardRecord::Slot*	mpSlot		= nullptr;	// nullptr: Überlauf
+		T*							mpObject	= nullptr;
+	}; // class HazardPointer
+
+	//_________________________________________________________________________________________________
+	/// @brief	Abgelöste Objekte eines Schreibers, die freigegeben werden, sobald sie kein HazardPointer
+	///			mehr schützt.
+	/// @remark	Nicht threadsicher, der Schreiber ruft Retire() unter seiner eigenen Sperre auf. Der
+	///			Destruktor gibt alle Objekte ohne Prüfung frei, der Besitzer muss sicherstellen, dass dann
+	///			kein Leser mehr aktiv ist.
+	/// @tparam Owner	besitzender Zeiger (z.B. std::unique_ptr<const T> bzw. std::shared_ptr<const T>),
+	///					dessen Zerstörung das Objekt freigibt
+	template <class Owner>
+	class HazardRetireList final
+	{
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Übernimmt das abgelöste Objekt. Es muss bereits durch ein neues Objekt ersetzt worden
+		///			sein (Speichern mit std::memory_order_seq_cst).
+		/// @remark	Gibt anschließend alle nicht mehr geschützten Objekte frei.
+		void Retire(Owner pRetired)
+		{
+			if(pRetired != nullptr)
+			{
+				mRetired.push_back(std::move(pRetired));
+			}
+			Reclaim();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt alle Objekte frei, die kein HazardPointer mehr schützt.
+		void Reclaim()
+		{
+			if(mRetired.empty() || (detail::HazardRegistry::NumOverflowReaders().load(std::memory_order_seq_cst) != 0))
+			{
+				return;
+			}
+			std::vector<const void*> protectedObjects;
+			detail::HazardRegistry::ForEachSlot([&protectedObjects](const detail::HazardRecord::Slot& slot)
+				{
+					if(const void* pObject = slot.pObject.load(std::memory_order_seq_cst))
+					{
+						protectedObjects.push_back(pObject);
+					}
+				});
+			std::erase_if(mRetired, [&protectedObjects](const Owner& pRetired)
+				{
+					return std::find(protectedObjects.begin(), protectedObjects.end(), static_cast<const void*>(pRetired.get())) == protectedObjects.end();
+				});
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der noch nicht freigegebenen Objekte zurück.
+		[[nodiscard]] size_t Size() const
+		{
+			return mRetired.size();
+		}
+
+	private:
+		std::vector<Owner>	mRetired;
+	}; // class HazardRetireList
+
+} // namespace tiel::concurrent
@@ -0,0 +1,188 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tiel::concurrent
+{
+	template <typename Signature, size_t Capacity = 64>
+	class InplaceFunction;
+
+	//_________________________________________________________________________________________________
+	/// @brief	Kopierbarer Funktionswrapper mit fester Kapazität, der das aufrufbare Objekt immer im
+	///			eigenen Puffer ablegt und daher nie Speicher auf dem Heap anfordert.
+	/// @remark	Im Gegensatz zu std::function wird bereits beim Übersetzen geprüft, ob das aufrufbare
+	///			Objekt (inklusive aller Captures) in "Capacity" Bytes passt. Ein Aufruf erfolgt über genau
+	///			einen Funktionszeiger, der direkt im Objekt liegt.
+	/// @tparam R			Rückgabetyp
+	/// @tparam Params		Parametertypen
+	/// @tparam Capacity	Größe des internen Puffers in Bytes
+	template <typename R, typename ... Params, size_t Capacity>
+	class InplaceFunction<R(Params ...), Capacity> final
+	{
+		enum class Operation
+		{
+			Copy,
+			Move,
+			Destroy
+		};
+		using InvokeFunc = R(*)(std::byte* pStorage, Params&& ... params);
+		using ManageFunc = void(*)(Operation operation, std::byte* pDest, std::byte* pSource);
+
+		template <typename Func>
+		static R Invoke(std::byte* pStorage, Params&& ... params)
+		{
+			return std::invoke(*std::launder(reinterpret_cast<Func*>(pStorage)), std::forward<Params>(params)...);
+		}
+		template <typename Func>
+		static void Manage(Operation operation, std::byte* pDest, std::byte* pSource)
+		{
+			Func* pSourceFunc = std::launder(reinterpret_cast<Func*>(pSource));
+			switch(operation)
+			{
+			case Operation::Copy:
+				new(pDest) Func(*pSourceFunc);
+				break;
+			case Operation::Move:
+				new(pDest) Func(std::move(*pSourceFunc));
+				pSourceFunc->~Func();
+				break;
+			case Operation::Destroy:
+				pSourceFunc->~Func();
+				break;
+			}
+		}
+
+	public:
+		static constexpr size_t BufferSize = Capacity;
+
+		///----------------------------------------------------------------------------------------------
+		/// Standard-Konstruktor, erzeugt ein leeres InplaceFunction. Der Puffer wird nur hier genullt,
+		/// damit auch constinit-Objekte ein leeres InplaceFunction enthalten können.
+		constexpr InplaceFunction() noexcept
+			: mStorage{}
+		{}
+		constexpr InplaceFunction(std::nullptr_t) noexcept
+			: mStorage{}
+		{}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Konstruktor, kopiert bzw. verschiebt das aufrufbare Objekt in den internen Puffer
+		/// @param func		aufrufbares Objekt, das höchstens Capacity Bytes groß sein darf
+		template <typename F, typename Func = std::decay_t<F>,
+				  typename = std::enable_if_t<!std::is_same_v<Func, InplaceFunction> && std::is_invocable_r_v<R, Func&, Params ...>>>
+		InplaceFunction(F&& func)
+		{
+			static_assert(sizeof(Func) <= Capacity, "InplaceFunction: aufrufbares Objekt ist größer als Capacity");
+			static_assert(alignof(Func) <= alignof(std::max_align_t), "InplaceFunction: Ausrichtung des aufrufbaren Objekts wird nicht unterstützt");
+			static_assert(std::is_copy_constructible_v<Func>, "InplaceFunction: aufrufbares Objekt muss kopierbar sein");
+
+			if constexpr(std::is_pointer_v<Func> || std::is_member_pointer_v<Func>)
+			{
+				if(func == nullptr)
+				{
+					return;
+				}
+			}
+			new(mStorage) Func(std::forward<F>(func));
+			mInvoke = &Invoke<Func>;
+			mManage = &Manage<Func>;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Copy-Konstruktor
+		InplaceFunction(const InplaceFunction& other)
+			: mInvoke(other.mInvoke), mManage(other.mManage)
+		{
+			if(mManage != nullptr)
+			{
+				mManage(Operation::Copy, mStorage, const_cast<std::byte*>(other.mStorage));
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Move-Konstruktor
+		/// @param mv_other [in, out]:		mv_other ist anschließend leer
+		InplaceFunction(InplaceFunction&& mv_other) noexcept
+			: mInvoke(mv_other.mInvoke), mManage(mv_other.mManage)
+		{
+			if(mManage != nullptr)
+			{
+				mManage(Operation::Move, mStorage, mv_other.mStorage);
+				mv_other.mInvoke = nullptr;
+				mv_other.mManage = nullptr;
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor
+		constexpr ~InplaceFunction()
+		{
+			Reset();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Copy-Zuweisung
+		InplaceFunction& operator=(const InplaceFunction& right)
+		{
+			if(&right != this)
+			{
+				InplaceFunction copy(right);
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Move-Zuweisungsoperator
+		/// @param mv_right [in, out]:		mv_right ist anschließend leer
+		InplaceFunction& operator=(InplaceFunction&& mv_right) noexcept
+		{
+			if(&mv_right != this)
+			{
+				Reset();
+				if(mv_right.mManage != nullptr)
+				{
+					mv_right.mManage(Operation::Move, mStorage, mv_right.mStorage);
+					mInvoke = std::exchange(mv_right.mInvoke, nullptr);
+					mManage = std::exchange(mv_right.mManage, nullptr);
+				}
+			}
+			return *this;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Zuweisung von nullptr, leert das InplaceFunction
+		InplaceFunction& operator=(std::nullptr_t) noexcept
+		{
+			Reset();
+			return *this;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob ein aufrufbares Objekt enthalten ist.
+		explicit operator bool() const noexcept
+		{
+			return mInvoke != nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft das enthaltene aufrufbare Objekt auf. Das InplaceFunction darf nicht leer sein.
+		R operator()(Params ... params) const
+		{
+			_ASSERT(mInvoke != nullptr);
+			return mInvoke(const_cast<std::byte*>(mStorage), std::forward<Params>(params)...);
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Zerstört das enthaltene aufrufbare Objekt
+		constexpr void Reset() noexcept
+		{
+			if(mManage != nullptr)
+			{
+				mManage(Operation::Destroy, nullptr, mStorage);
+				mInvoke = nullptr;
+				mManage = nullptr;
+			}
+		}
+
+		alignas(std::max_align_t) std::byte	mStorage[Capacity];
+		InvokeFunc							mInvoke	= nullptr;
+		ManageFunc							mManage	= nullptr;
+	}; // class InplaceFunction
+
+} // namespace tiel::concurrent
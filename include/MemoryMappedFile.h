@@ -0,0 +1,355 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <Windows.h>
+#else
+	#include <cerrno>
+	#include <signal.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace tiel::io
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Gibt die Id des aktuellen Prozesses zurück.
+	inline uint32_t CurrentProcessId()
+	{
+	#ifdef _WIN32
+		return static_cast<uint32_t>(::GetCurrentProcessId());
+	#else
+		return static_cast<uint32_t>(::getpid());
+	#endif
+	}
+
+	//_________________________________________________________________________________________________
+	/// @brief	Prüft, ob der Prozess mit der angegebenen Id (noch) existiert.
+	inline bool IsProcessAlive(uint32_t processId)
+	{
+	#ifdef _WIN32
+		HANDLE hProcess = ::OpenProcess(SYNCHRONIZE, FALSE, processId);
+		if(hProcess == nullptr)
+		{
+			return ::GetLastError() == ERROR_ACCESS_DENIED;
+		}
+		const bool isAlive = (::WaitForSingleObject(hProcess, 0) == WAIT_TIMEOUT);
+		::CloseHandle(hProcess);
+		return isAlive;
+	#else
+		return (::kill(static_cast<pid_t>(processId), 0) == 0) || (errno == EPERM);
+	#endif
+	}
+
+	//_________________________________________________________________________________________________
+	/// @brief	Gibt ein aus dem Startzeitpunkt des Prozesses abgeleitetes Merkmal zurück, das zusammen
+	///			mit der Prozess-Id den Prozess auch nach Wiederverwendung der Id eindeutig kennzeichnet.
+	/// @return		0, wenn das Merkmal nicht ermittelt werden kann (z.B. fehlende Rechte, oder unter
+	///				POSIX ohne Windows-Prozesszeiten).
+	inline uint32_t ProcessStartToken([[maybe_unused]] uint32_t processId)
+	{
+	#ifdef _WIN32
+		HANDLE hProcess = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+		if(hProcess == nullptr)
+		{
+			return 0;
+		}
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		const bool isValid = ::GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime) != FALSE;
+		::CloseHandle(hProcess);
+		if(!isValid)
+		{
+			return 0;
+		}
+		const uint32_t token = creationTime.dwLowDateTime ^ creationTime.dwHighDateTime;
+		return (token != 0) ? token : 1;
+	#else
+		return 0;
+	#endif
+	}
+
+	//_________________________________________________________________________________________________
+	/// @brief	Prüft, ob der Prozess mit der angegebenen Id und dem angegebenen Startmerkmal (siehe
+	///			ProcessStartToken()) noch existiert. Ein Prozess, der die Id wiederverwendet, gilt nicht
+	///			als derselbe Prozess.
+	inline bool IsProcessAlive(uint32_t processId, uint32_t startToken)
+	{
+		if(!IsProcessAlive(processId))
+		{
+			return false;
+		}
+		const uint32_t currentToken = (startToken != 0) ? ProcessStartToken(processId) : 0;
+		return (currentToken == 0) || (currentToken == startToken);
+	}
+
+	//_________________________________________________________________________________________________
+	/// @brief	Plattformunabhängige Kapselung einer in den Adressraum eingeblendeten Datei (mmap bzw.
+	///			MapViewOfFile).
+	/// @remark	Die Datei wird immer vollständig und "shared" eingeblendet, d.h. Schreibzugriffe landen
+	///			direkt im Page-Cache und sind für andere Prozesse, die dieselbe Datei einblenden,
+	///			sichtbar. Die Klasse ist nicht threadsicher.
+	class MemoryMappedFile final
+	{
+	public:
+		enum class AccessMode
+		{
+			ReadOnly,
+			ReadWrite
+		};
+
+		///----------------------------------------------------------------------------------------------
+		/// Standard-Konstruktor
+		MemoryMappedFile() = default;
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist nicht kopierbar
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor
+		~MemoryMappedFile()
+		{
+			Close();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Move-Konstruktor
+		/// @param mv_other [in, out]:		mv_other ist anschließend geschlossen
+		MemoryMappedFile(MemoryMappedFile&& mv_other) noexcept
+		{
+			Swap(mv_other);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Move-Zuweisungsoperator
+		/// @param mv_right [in, out]:		mv_right ist anschließend geschlossen
+		/// @return							diese Instanz
+		MemoryMappedFile& operator=(MemoryMappedFile&& mv_right) noexcept
+		{
+			if(&mv_right != this)
+			{
+				Close();
+				Swap(mv_right);
+			}
+			return *this;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt die Datei mit der angegebenen Größe an (bzw. überschreibt eine vorhandene) und
+		///			blendet diese schreibend ein.
+		/// @remark	Der Speicherplatz wird vollständig reserviert (keine "sparse" Datei), damit ein Schreiben
+		///			über die Einblendung bei vollem Datenträger nicht mit SIGBUS bzw. einer
+		///			EXCEPTION_IN_PAGE_ERROR abbricht.
+		/// @param path [in]:	Pfad der anzulegenden Datei
+		/// @param size [in]:	Dateigröße in Bytes (> 0)
+		/// @return				true, wenn die Datei angelegt, der Speicherplatz reserviert und die Datei
+		///						eingeblendet werden konnte.
+		[[nodiscard]] bool Create(const std::filesystem::path& path, size_t size)
+		{
+			Close();
+			if(size == 0)
+			{
+				return false;
+			}
+		#ifdef _WIN32
+			mFile = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+								  nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			const LARGE_INTEGER fileSize { .QuadPart = static_cast<LONGLONG>(size) };
+			if((mFile == INVALID_HANDLE_VALUE) || !::SetFilePointerEx(mFile, fileSize, nullptr, FILE_BEGIN) || !::SetEndOfFile(mFile))
+			{
+				Close();
+				return false;
+			}
+		#else
+			mFile = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if((mFile < 0) || (::posix_fallocate(mFile, 0, static_cast<off_t>(size)) != 0))
+			{
+				Close();
+				return false;
+			}
+		#endif
+			return Map(size, AccessMode::ReadWrite);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Öffnet eine vorhandene Datei und blendet diese vollständig ein.
+		/// @param path [in]:	Pfad der zu öffnenden Datei
+		/// @param mode [in]:	Zugriffsart
+		/// @return				true, wenn die Datei geöffnet und eingeblendet werden konnte. Eine leere
+		///						Datei ist gültig, Data() gibt dann nullptr zurück.
+		[[nodiscard]] bool Open(const std::filesystem::path& path, AccessMode mode)
+		{
+			Close();
+			const bool isWritable = (mode == AccessMode::ReadWrite);
+		#ifdef _WIN32
+			mFile = ::CreateFileW(path.c_str(), isWritable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+								  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+								  isWritable ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			LARGE_INTEGER fileSize{};
+			if((mFile == INVALID_HANDLE_VALUE) || !::GetFileSizeEx(mFile, &fileSize))
+			{
+				Close();
+				return false;
+			}
+			const size_t size = static_cast<size_t>(fileSize.QuadPart);
+		#else
+			mFile = ::open(path.c_str(), (isWritable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+			struct stat fileStat{};
+			if((mFile < 0) || (::fstat(mFile, &fileStat) != 0))
+			{
+				Close();
+				return false;
+			}
+			const size_t size = static_cast<size_t>(fileStat.st_size);
+		#endif
+			if(size == 0)
+			{
+				return true;
+			}
+			return Map(size, mode);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Schreibt geänderte Seiten synchron in die Datei zurück.
+		/// @return				true, wenn alle Seiten geschrieben werden konnten.
+		bool Flush()
+		{
+			if(mData == nullptr)
+			{
+				return IsOpen();
+			}
+		#ifdef _WIN32
+			return ::FlushViewOfFile(mData, 0) && ::FlushFileBuffers(mFile);
+		#else
+			return ::msync(mData, mSize, MS_SYNC) == 0;
+		#endif
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Teilt dem Betriebssystem mit, dass die Daten sequentiell gelesen werden (Read-Ahead).
+		void AdviseSequential()
+		{
+		#ifndef _WIN32
+			if(mData != nullptr)
+			{
+				::madvise(mData, mSize, MADV_SEQUENTIAL);
+			}
+		#endif
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Blendet die Datei aus und schließt diese.
+		void Close()
+		{
+		#ifdef _WIN32
+			if(mData != nullptr)
+			{
+				::UnmapViewOfFile(mData);
+			}
+			if(mMapping != nullptr)
+			{
+				::CloseHandle(mMapping);
+			}
+			if(mFile != INVALID_HANDLE_VALUE)
+			{
+				::CloseHandle(mFile);
+			}
+			mMapping	= nullptr;
+			mFile		= INVALID_HANDLE_VALUE;
+		#else
+			if(mData != nullptr)
+			{
+				::munmap(mData, mSize);
+			}
+			if(mFile >= 0)
+			{
+				::close(mFile);
+			}
+			mFile		= -1;
+		#endif
+			mData		= nullptr;
+			mSize		= 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob eine Datei geöffnet ist.
+		[[nodiscard]] bool IsOpen() const
+		{
+		#ifdef _WIN32
+			return mFile != INVALID_HANDLE_VALUE;
+		#else
+			return mFile >= 0;
+		#endif
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt den Anfang des eingeblendeten Speicherbereichs zurück.
+		[[nodiscard]] std::byte* Data()
+		{
+			return mData;
+		}
+		[[nodiscard]] const std::byte* Data() const
+		{
+			return mData;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Größe des eingeblendeten Speicherbereichs in Bytes zurück.
+		[[nodiscard]] size_t Size() const
+		{
+			return mSize;
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Blendet die bereits geöffnete Datei mit der angegebenen Größe ein
+		bool Map(size_t size, AccessMode mode)
+		{
+			const bool isWritable = (mode == AccessMode::ReadWrite);
+		#ifdef _WIN32
+			const ULARGE_INTEGER mapSize { .QuadPart = size };
+			mMapping = ::CreateFileMappingW(mFile, nullptr, isWritable ? PAGE_READWRITE : PAGE_READONLY,
+											mapSize.HighPart, mapSize.LowPart, nullptr);
+			void* pData = (mMapping != nullptr)
+						? ::MapViewOfFile(mMapping, isWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size)
+						: nullptr;
+			if(pData == nullptr)
+			{
+				Close();
+				return false;
+			}
+		#else
+			void* pData = ::mmap(nullptr, size, isWritable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, mFile, 0);
+			if(pData == MAP_FAILED)
+			{
+				Close();
+				return false;
+			}
+		#endif
+			mData = static_cast<std::byte*>(pData);
+			mSize = size;
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Tauscht den Zustand mit "other"
+		void Swap(MemoryMappedFile& other) noexcept
+		{
+			std::swap(mFile, other.mFile);
+		#ifdef _WIN32
+			std::swap(mMapping, other.mMapping);
+		#endif
+			std::swap(mData, other.mData);
+			std::swap(mSize, other.mSize);
+		}
+
+	#ifdef _WIN32
+		HANDLE		mFile		= INVALID_HANDLE_VALUE;
+		HANDLE		mMapping	= nullptr;
+	#else
+		int			mFile		= -1;
+	#endif
+		std::byte*	mData		= nullptr;
+		size_t		mSize		= 0;
+	}; // class MemoryMappedFile
+
+} // namespace tiel::io
@@ -0,0 +1,354 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SimpleTimer.h"
+
+//_________________________________________________________________________________________________
+/// @brief	Misst die Laufzeit des umgebenden Blocks als Profiling-Zone (siehe tiel::timer::ProfileZone).
+///			name muss ein String-Literal (bzw. ein Zeiger mit statischer Lebensdauer) sein.
+/// @remark	Nur aktiv, wenn TIEL_PROFILE_ZONES definiert ist, andernfalls entfällt der Makro-Aufruf
+///			vollständig.
+#ifdef TIEL_PROFILE_ZONES
+	#define TIEL_PROFILE_ZONE_CONCAT_(a, b)	a##b
+	#define TIEL_PROFILE_ZONE_CONCAT(a, b)	TIEL_PROFILE_ZONE_CONCAT_(a, b)
+	#define TIEL_PROFILE_ZONE(name)			const ::tiel::timer::ProfileZone TIEL_PROFILE_ZONE_CONCAT(tielProfileZone, __LINE__)(name)
+#else
+	#define TIEL_PROFILE_ZONE(name)
+#endif
+
+namespace tiel::timer
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Abgeschlossene Zone eines Threads (Anfang und Ende in Nanosekunden der TscClock)
+	struct TraceEvent
+	{
+		const char*	name	= nullptr;
+		int64_t		beginNs	= 0;
+		int64_t		endNs	= 0;
+	};
+
+	//_________________________________________________________________________________________________
+	/// @brief	Vorab allozierter Ringpuffer eines Threads für TraceEvents.
+	/// @remark	Genau ein Erzeuger (der Thread der Zonen) und ein Verbraucher (der Flusher), beide
+	///			synchronisieren sich nur über die atomaren Schreib- und Leseindizes. Ist der Puffer voll,
+	///			wird das neue Ereignis verworfen und gezählt.
+	class TraceBuffer final
+	{
+	public:
+		static constexpr size_t Capacity = size_t(1) << 13; // Zweierpotenz
+
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor
+		/// @param threadId		fortlaufende Nummer des Threads im Trace
+		explicit TraceBuffer(uint32_t threadId)
+			: mEvents(std::make_unique<TraceEvent[]>(Capacity))
+			, mThreadId(threadId)
+		{}
+		TraceBuffer(const TraceBuffer&) = delete;
+		TraceBuffer& operator=(const TraceBuffer&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt ein Ereignis ab (nur aus dem Thread des Puffers).
+		/// @return		false, wenn der Puffer voll war und das Ereignis verworfen wurde
+		bool TryPush(const TraceEvent& event) noexcept
+		{
+			const size_t head = mHead.load(std::memory_order_relaxed);
+			if(head - mCachedTail == Capacity)
+			{
+				mCachedTail = mTail.load(std::memory_order_acquire);
+				if(head - mCachedTail == Capacity)
+				{
+					mNumDropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+			}
+			mEvents[head & (Capacity - 1)] = event;
+			mHead.store(head + 1, std::memory_order_release);
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Übergibt alle abgelegten Ereignisse an func (nur aus dem Verbraucher-Thread).
+		/// @return		Anzahl der übergebenen Ereignisse
+		template <class Func>
+		size_t Drain(Func&& func)
+		{
+			size_t			tail	= mTail.load(std::memory_order_relaxed);
+			const size_t	head	= mHead.load(std::memory_order_acquire);
+			const size_t	count	= head - tail;
+			for(; tail != head; ++tail)
+			{
+				func(mEvents[tail & (Capacity - 1)]);
+			}
+			mTail.store(tail, std::memory_order_release);
+			return count;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die fortlaufende Nummer des Threads zurück.
+		[[nodiscard]] uint32_t ThreadId() const noexcept
+		{
+			return mThreadId;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der wegen eines vollen Puffers verworfenen Ereignisse zurück.
+		[[nodiscard]] size_t NumDropped() const noexcept
+		{
+			return mNumDropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::unique_ptr<TraceEvent[]>	mEvents;
+		const uint32_t					mThreadId;
+		alignas(64) std::atomic_size_t	mHead		= 0;	// Schreibindex (Erzeuger)
+		size_t							mCachedTail	= 0;	// zuletzt gelesener Leseindex (Erzeuger)
+		alignas(64) std::atomic_size_t	mTail		= 0;	// Leseindex (Verbraucher)
+		std::atomic_size_t				mNumDropped	= 0;
+	}; // class TraceBuffer
+
+	//_________________________________________________________________________________________________
+	/// @brief	Sammelt die Zonen aller Threads und schreibt sie über einen Hintergrund-Thread im Chrome
+	///			Trace-Event-Format (JSON, in chrome://tracing bzw. Perfetto ladbar).
+	/// @remark	Jeder Thread erhält bei seiner ersten Zone einen eigenen TraceBuffer, nur diese
+	///			Anmeldung ist durch eine Sperre geschützt. Das Ablegen einer Zone ist sperr- und
+	///			allokationsfrei. Der Flusher leert die Puffer im vorgegebenen Intervall, sodass auf dem
+	///			gemessenen Pfad weder formatiert noch geschrieben wird.
+	///			Solange kein Flusher läuft, werden keine Zonen abgelegt.
+	class TraceCollector final
+	{
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt den prozessweiten Collector zurück.
+		static TraceCollector& Instance()
+		{
+			static TraceCollector sInstance;
+			return sInstance;
+		}
+		TraceCollector(const TraceCollector&) = delete;
+		TraceCollector& operator=(const TraceCollector&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, beendet ggf. den Flusher
+		~TraceCollector()
+		{
+			Stop();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Öffnet die Trace-Datei und startet den Flusher.
+		/// @param path [in]:			Pfad der Trace-Datei, eine bestehende Datei wird überschrieben
+		/// @param flushInterval [in]:	Intervall, in dem die Puffer geleert werden. Muss kurz genug sein,
+		///								dass kein Puffer (TraceBuffer::Capacity Zonen) überläuft.
+		/// @return						false, wenn der Flusher bereits läuft oder die Datei nicht geöffnet
+		///								werden konnte
+		bool Start(const std::filesystem::path& path, std::chrono::milliseconds flushInterval = std::chrono::milliseconds(100))
+		{
+			//_ASSERT(false); // not tested
+			std::lock_guard lock(mFlushMutex);
+			if(mIsRunning.load(std::memory_order_relaxed))
+			{
+				return false;
+			}
+			mFile.open(path, std::ios::out | std::ios::trunc);
+			if(!mFile.is_open())
+			{
+				return false;
+			}
+			mFile << "[";
+			TscClock::Calibrate(); // nicht erst in der ersten Zone
+			mIsFirstEvent		= true;
+			mIsStopRequested	= false;
+			mIsRunning.store(true, std::memory_order_release);
+			mFlusher = std::thread([this, flushInterval]() { RunFlusher(flushInterval); });
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Beendet den Flusher, schreibt die restlichen Zonen und schließt die Trace-Datei.
+		void Stop()
+		{
+			//_ASSERT(false); // not tested
+			{
+				std::lock_guard lock(mFlushMutex);
+				if(!mIsRunning.load(std::memory_order_relaxed))
+				{
+					return;
+				}
+				mIsRunning.store(false, std::memory_order_release);
+				mIsStopRequested = true;
+				mFlushCondition.notify_all();
+			}
+			mFlusher.join();
+			std::lock_guard lock(mFlushMutex);
+			FlushBuffers();
+			mFile << "\n]\n";
+			mFile.close();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob der Flusher läuft, d.h. ob Zonen aufgezeichnet werden.
+		[[nodiscard]] bool IsRunning() const noexcept
+		{
+			return mIsRunning.load(std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der bisher geschriebenen Zonen zurück.
+		[[nodiscard]] size_t NumWrittenEvents() const noexcept
+		{
+			return mNumWritten.load(std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der wegen voller Puffer (bzw. eines nicht anlegbaren Puffers)
+		///			verworfenen Zonen aller Threads zurück.
+		[[nodiscard]] size_t NumDroppedEvents() const
+		{
+			std::lock_guard	lock(mBufferMutex);
+			size_t			numDropped = mNumUnregistered.load(std::memory_order_relaxed);
+			for(const std::shared_ptr<TraceBuffer>& pBuffer : mBuffers)
+			{
+				numDropped += pBuffer->NumDropped();
+			}
+			return numDropped;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt eine abgeschlossene Zone im Puffer des aufrufenden Threads ab.
+		/// @remark	Wird aus dem Destruktor von ProfileZone aufgerufen und wirft daher nie: Kann der
+		///			Puffer des Threads nicht angelegt werden, wird die Zone verworfen und gezählt.
+		/// @param name		Name mit statischer Lebensdauer
+		void Record(const char* name, int64_t beginNs, int64_t endNs) noexcept
+		{
+			if(!mIsRunning.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+			thread_local TraceBuffer* tpBuffer = nullptr;
+			if(tpBuffer == nullptr)
+			{
+				tpBuffer = TryRegisterThread();
+				if(tpBuffer == nullptr)
+				{
+					mNumUnregistered.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			}
+			(void)tpBuffer->TryPush({ name, beginNs, endNs });
+		}
+
+	private:
+		TraceCollector() = default;
+		///----------------------------------------------------------------------------------------------
+		/// Legt den Puffer des aufrufenden Threads an. Der Collector besitzt ihn, damit Zonen beendeter
+		/// Threads noch geschrieben werden. Gibt nullptr zurück, wenn der Puffer nicht angelegt werden
+		/// konnte (z.B. std::bad_alloc), ein späterer Aufruf versucht es erneut.
+		TraceBuffer* TryRegisterThread() noexcept
+		{
+			try
+			{
+				std::lock_guard lock(mBufferMutex);
+				auto pBuffer = std::make_shared<TraceBuffer>(static_cast<uint32_t>(mBuffers.size() + 1));
+				mBuffers.push_back(pBuffer);
+				return pBuffer.get();
+			}
+			catch(...)
+			{
+				return nullptr;
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		void RunFlusher(std::chrono::milliseconds flushInterval)
+		{
+			std::unique_lock lock(mFlushMutex);
+			while(!mIsStopRequested)
+			{
+				mFlushCondition.wait_for(lock, flushInterval, [this]() { return mIsStopRequested; });
+				FlushBuffers();
+				mFile.flush();
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Schreibt die Zonen aller Puffer als vollständige Ereignisse ("ph":"X"), Zeiten in µs.
+		/// mFlushMutex muss gehalten werden.
+		void FlushBuffers()
+		{
+			std::vector<std::shared_ptr<TraceBuffer>> buffers;
+			{
+				std::lock_guard lock(mBufferMutex);
+				buffers = mBuffers;
+			}
+			for(const std::shared_ptr<TraceBuffer>& pBuffer : buffers)
+			{
+				const uint32_t threadId = pBuffer->ThreadId();
+				mNumWritten.fetch_add(pBuffer->Drain([this, threadId](const TraceEvent& event)
+					{
+						WriteEvent(event, threadId);
+					}), std::memory_order_relaxed);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		void WriteEvent(const TraceEvent& event, uint32_t threadId)
+		{
+			char times[96];
+			(void)std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+								static_cast<double>(event.beginNs)/1000.0,
+								static_cast<double>(event.endNs - event.beginNs)/1000.0, threadId);
+			mFile << (mIsFirstEvent ? "\n" : ",\n") << "{\"name\":\"";
+			for(const char* p = event.name; *p != '\0'; p++)
+			{
+				if((*p == '"') || (*p == '\\'))
+				{
+					mFile << '\\';
+				}
+				mFile << *p;
+			}
+			mFile << "\",\"cat\":\"zone\",\"ph\":\"X\"," << times << "}";
+			mIsFirstEvent = false;
+		}
+
+		mutable std::mutex							mBufferMutex;		// schützt mBuffers
+		std::vector<std::shared_ptr<TraceBuffer>>	mBuffers;
+		std::mutex									mFlushMutex;		// schützt Datei und Flusher-Zustand
+		std::condition_variable						mFlushCondition;
+		std::ofstream								mFile;
+		std::thread									mFlusher;
+		std::atomic_bool							mIsRunning			= false;
+		bool										mIsStopRequested	= false;
+		bool										mIsFirstEvent		= true;
+		std::atomic_size_t							mNumWritten			= 0;
+		std::atomic_size_t							mNumUnregistered	= 0;	// mangels Puffer verworfene Zonen
+	}; // class TraceCollector
+
+	//_________________________________________________________________________________________________
+	/// @brief	RAII-Zone: misst die Zeit von der Konstruktion bis zur Zerstörung mit der TscClock des
+	///			SimpleTimer und legt sie als TraceEvent im Puffer des Threads ab.
+	/// @remark	Ohne laufenden Flusher (TraceCollector::Start(), kalibriert auch den TscClock) kostet
+	///			eine Zone nur die beiden Zeitmessungen. Üblicherweise über TIEL_PROFILE_ZONE(name)
+	///			verwendet, das ohne TIEL_PROFILE_ZONES vollständig entfällt.
+	class ProfileZone final
+	{
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor, beginnt die Zone
+		/// @param name		Name mit statischer Lebensdauer (String-Literal)
+		explicit ProfileZone(const char* name) noexcept
+			: mName(name)
+			, mBegin(TscClock::now())
+		{}
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, beendet die Zone
+		~ProfileZone()
+		{
+			const TscClock::time_point end = TscClock::now();
+			TraceCollector::Instance().Record(mName, mBegin.time_since_epoch().count(), end.time_since_epoch().count());
+		}
+
+	private:
+		const char*					mName;
+		const TscClock::time_point	mBegin;
+	}; // class ProfileZone
+
+} // namespace tiel::timer
@@ -0,0 +1,182 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <filesystem>
+#include <system_error>
+#include "MemoryMappedFile.h"
+#include "Serializer.h"
+#include "SpillStore.h"
+
+namespace tiel::concurrent::container
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Binäres Dateiformat für Queue-Snapshots:
+	///			[QueueSnapshotFile::Header][Datensätze im Format von SerializedRecord ...]
+	/// @remark	Geschrieben wird in eine temporäre Datei, die erst nach vollständigem Schreiben und
+	///			Flush() auf den Zielnamen umbenannt wird. Ein abgebrochener Snapshot hinterlässt daher
+	///			nie eine halb geschriebene Snapshot-Datei.
+	class QueueSnapshotFile final
+	{
+	public:
+		struct Header
+		{
+			uint64_t	magic		= Magic;
+			uint32_t	version		= Version;
+			uint32_t	headerSize	= sizeof(Header);
+			uint64_t	numRecords	= 0;
+			uint64_t	dataSize	= 0;	// Bytes aller Datensätze
+			uint64_t	elementSize	= 0;	// sizeof(T) der schreibenden Queue
+		};
+		static constexpr uint64_t Magic		= 0x50414E5351454954ULL; // "TIEQSNAP"
+		static constexpr uint32_t Version	= 2;
+
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Schreibt alle Elemente der Queue und anschließend alle Datensätze des SpillStores
+		///			(ohne erneute Serialisierung) in die Snapshot-Datei.
+		/// @param path [in]:			Pfad der Snapshot-Datei
+		/// @param elements [in]:		Elemente im Speicher
+		/// @param pSpillStore [in]:	ausgelagerte Elemente (die auf "elements" folgen) oder nullptr
+		/// @return						true, wenn die Datei vollständig geschrieben wurde.
+		template <Serializable T>
+		static bool Write(const std::filesystem::path& path, const std::queue<T>& elements, const SpillStore<T>* pSpillStore = nullptr)
+		{
+			const auto&	container	= ContainerOf(elements);
+			Header		header;
+
+			header.elementSize = sizeof(T);
+			for(const T& value : container)
+			{
+				header.dataSize += SerializedRecord::TotalSize(Serializer<T>::Size(value));
+			}
+			header.numRecords = container.size();
+			if(pSpillStore != nullptr)
+			{
+				pSpillStore->ForEachRecord([&header](const std::byte*, size_t recordSize)
+					{
+						header.dataSize += recordSize;
+					});
+				header.numRecords += pSpillStore->Size();
+			}
+
+			std::filesystem::path		tempPath = path;
+			tiel::io::MemoryMappedFile	file;
+			tempPath += ".tmp";
+			if(!file.Create(tempPath, sizeof(Header) + header.dataSize))
+			{
+				return false;
+			}
+			std::byte* pDest = file.Data();
+			std::memcpy(pDest, &header, sizeof(Header));
+			pDest += sizeof(Header);
+
+			for(const T& value : container)
+			{
+				pDest += SerializedRecord::Write(value, pDest);
+			}
+			if(pSpillStore != nullptr)
+			{
+				pSpillStore->ForEachRecord([&pDest](const std::byte* pRecord, size_t recordSize)
+					{
+						std::memcpy(pDest, pRecord, recordSize);
+						pDest += recordSize;
+					});
+			}
+
+			std::error_code error;
+			const bool isFlushed = file.Flush();
+			file.Close();
+			if(isFlushed)
+			{
+				std::filesystem::rename(tempPath, path, error);
+			}
+			if(!isFlushed || error)
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Blendet die Snapshot-Datei ein und prüft den Dateikopf.
+		/// @param path [in]:	Pfad der Snapshot-Datei
+		/// @return				true, wenn die Datei gültig ist und von einer Queue mit Elementtyp T
+		///						(gleiches sizeof(T)) geschrieben wurde.
+		template <Serializable T>
+		[[nodiscard]] bool Open(const std::filesystem::path& path)
+		{
+			if(!mFile.Open(path, tiel::io::MemoryMappedFile::AccessMode::ReadOnly) || (mFile.Size() < sizeof(Header)))
+			{
+				mFile.Close();
+				return false;
+			}
+			std::memcpy(&mHeader, mFile.Data(), sizeof(Header));
+			if(		(mHeader.magic != Magic)
+				||	(mHeader.version != Version)
+				||	(mHeader.headerSize != sizeof(Header))
+				||	(mHeader.elementSize != sizeof(T))
+				||	(mHeader.dataSize != mFile.Size() - sizeof(Header)))
+			{
+				mFile.Close();
+				return false;
+			}
+			mFile.AdviseSequential();
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der Datensätze der geöffneten Datei zurück.
+		[[nodiscard]] size_t NumRecords() const
+		{
+			return static_cast<size_t>(mHeader.numRecords);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft für jeden Datensatz (in Queue-Reihenfolge) func(pRecord, recordSize) auf.
+		/// @remark	Die Nutzdatengröße jedes Datensatzes wird vor dem Aufruf von func mit
+		///			SerializedRecord::HasValidSize<T>() geprüft.
+		/// @return				false, wenn die Datensätze nicht zum Dateikopf oder zu T passen. func wurde
+		///						dann ggf. bereits für die vorhergehenden Datensätze aufgerufen.
+		template <Serializable T, typename Func>
+		bool ForEachRecord(Func&& func) const
+		{
+			const std::byte*	pRecord = mFile.Data() + sizeof(Header);
+			const std::byte*	pEnd	= pRecord + mHeader.dataSize;
+
+			for(uint64_t i = 0; i < mHeader.numRecords; i++)
+			{
+				if(pEnd - pRecord < static_cast<ptrdiff_t>(SerializedRecord::HeaderSize))
+				{
+					return false;
+				}
+				const size_t recordSize = SerializedRecord::TotalSize(SerializedRecord::PayloadSize(pRecord));
+				if((static_cast<size_t>(pEnd - pRecord) < recordSize) || !SerializedRecord::HasValidSize<T>(pRecord))
+				{
+					return false;
+				}
+				func(pRecord, recordSize);
+				pRecord += recordSize;
+			}
+			return true;
+		}
+
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Zugriff auf den Container einer std::queue, um deren Elemente ohne Entnahme zu lesen.
+		template <typename T, typename Container>
+		static const Container& ContainerOf(const std::queue<T, Container>& queue)
+		{
+			struct Access : std::queue<T, Container>
+			{
+				static const Container& Get(const std::queue<T, Container>& q)
+				{
+					return q.*(&Access::c);
+				}
+			};
+			return Access::Get(queue);
+		}
+
+	private:
+		tiel::io::MemoryMappedFile	mFile;
+		Header						mHeader;
+	}; // class QueueSnapshotFile
+
+} // namespace tiel::concurrent::container
@@ -0,0 +1,155 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace tiel::concurrent::container
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Anpassungspunkt für die binäre Serialisierung von Queue-Elementen (Spill-Dateien,
+	///			Snapshots).
+	/// @remark	Für eigene Typen wird Serializer<T> spezialisiert. Eine Spezialisierung muss folgende
+	///			statische Methoden bereitstellen:
+	///				size_t	Size(const T& value)							 benötigte Anzahl Bytes
+	///				void	Write(const T& value, std::byte* pDest)			 schreibt genau Size() Bytes
+	///				T		Read(const std::byte* pSource, size_t size)		 erzeugt das Element direkt
+	///																		 aus dem (eingeblendeten) Puffer
+	///			Optional prüft
+	///				bool	IsValidSize(size_t size)
+	///			vor dem Aufruf von Read(), ob "size" eine gültige Nutzdatengröße für T ist (Einlesen von
+	///			Snapshots).
+	///			Die Puffer sind nicht notwendigerweise für T ausgerichtet.
+	/// @tparam T	zu serialisierender Typ
+	template <typename T, typename = void>
+	struct Serializer
+	{
+		// keine Serialisierung für T vorhanden
+	};
+
+	///________________________________________________________________________________________________
+	/// Serialisierung trivial kopierbarer Typen als Speicherabbild
+	template <typename T>
+	struct Serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+	{
+		static size_t Size(const T&)
+		{
+			return sizeof(T);
+		}
+		static void Write(const T& value, std::byte* pDest)
+		{
+			std::memcpy(pDest, &value, sizeof(T));
+		}
+		static bool IsValidSize(size_t size)
+		{
+			return size == sizeof(T);
+		}
+		static T Read(const std::byte* pSource, size_t /*size*/)
+		{
+			// memcpy erzeugt das Objekt implizit im ausgerichteten Puffer (T muss nicht
+			// default-konstruierbar sein)
+			alignas(T) std::byte buffer[sizeof(T)];
+			std::memcpy(buffer, pSource, sizeof(T));
+			return *std::launder(reinterpret_cast<T*>(buffer));
+		}
+	};
+
+	///________________________________________________________________________________________________
+	/// Serialisierung von Strings mit trivial kopierbaren Zeichen
+	template <typename CharT, typename Traits, typename Alloc>
+	struct Serializer<std::basic_string<CharT, Traits, Alloc>, std::enable_if_t<std::is_trivially_copyable_v<CharT>>>
+	{
+		using StringType = std::basic_string<CharT, Traits, Alloc>;
+
+		static size_t Size(const StringType& value)
+		{
+			return value.size()*sizeof(CharT);
+		}
+		static void Write(const StringType& value, std::byte* pDest)
+		{
+			std::memcpy(pDest, value.data(), value.size()*sizeof(CharT));
+		}
+		static bool IsValidSize(size_t size)
+		{
+			return (size % sizeof(CharT)) == 0;
+		}
+		static StringType Read(const std::byte* pSource, size_t size)
+		{
+			StringType value(size/sizeof(CharT), CharT{});
+			std::memcpy(value.data(), pSource, size);
+			return value;
+		}
+	};
+
+	///________________________________________________________________________________________________
+	/// @brief	Erfüllt, wenn für T eine Spezialisierung von Serializer<T> existiert.
+	template <typename T>
+	concept Serializable = requires(const T& value, std::byte* pDest, const std::byte* pSource, size_t size)
+	{
+		{ Serializer<T>::Size(value) } -> std::convertible_to<size_t>;
+		Serializer<T>::Write(value, pDest);
+		{ Serializer<T>::Read(pSource, size) } -> std::convertible_to<T>;
+	};
+
+	///________________________________________________________________________________________________
+	/// @brief	Gemeinsames Datensatzformat der Spill- und Snapshot-Dateien:
+	///			[uint32_t Nutzdatengröße][Nutzdaten][Füllbytes bis zur nächsten 8-Byte-Grenze]
+	struct SerializedRecord
+	{
+		static constexpr size_t HeaderSize	= sizeof(uint32_t);
+		static constexpr size_t Alignment	= 8;
+
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Größe eines Datensatzes inklusive Kopf und Füllbytes zurück.
+		static constexpr size_t TotalSize(size_t payloadSize)
+		{
+			return (HeaderSize + payloadSize + Alignment - 1) & ~(Alignment - 1);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Serialisiert "value" als Datensatz an die Adresse pDest.
+		/// @return				Anzahl geschriebener Bytes (TotalSize())
+		template <Serializable T>
+		static size_t Write(const T& value, std::byte* pDest)
+		{
+			const size_t	payloadSize = Serializer<T>::Size(value);
+			const uint32_t	header		= static_cast<uint32_t>(payloadSize);
+			std::memcpy(pDest, &header, HeaderSize);
+			Serializer<T>::Write(value, pDest + HeaderSize);
+			return TotalSize(payloadSize);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Liest die Nutzdatengröße des Datensatzes an der Adresse pSource.
+		static size_t PayloadSize(const std::byte* pSource)
+		{
+			uint32_t header;
+			std::memcpy(&header, pSource, HeaderSize);
+			return header;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft die Nutzdatengröße des Datensatzes an der Adresse pSource mit
+		///			Serializer<T>::IsValidSize() (sofern vorhanden).
+		template <Serializable T>
+		static bool HasValidSize(const std::byte* pSource)
+		{
+			if constexpr(requires(size_t size) { { Serializer<T>::IsValidSize(size) } -> std::convertible_to<bool>; })
+			{
+				return Serializer<T>::IsValidSize(PayloadSize(pSource));
+			}
+			else
+			{
+				return true;
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Erzeugt das Element aus dem Datensatz an der Adresse pSource (ohne Zwischenkopie).
+		template <Serializable T>
+		static T Read(const std::byte* pSource)
+		{
+			return Serializer<T>::Read(pSource + HeaderSize, PayloadSize(pSource));
+		}
+	};
+
+} // namespace tiel::concurrent::container
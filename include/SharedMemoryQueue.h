@@ -0,0 +1,487 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include "MemoryMappedFile.h"
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <linux/futex.h>
+	#include <pthread.h>
+	#include <sys/syscall.h>
+	#include <time.h>
+	#include <unistd.h>
+#endif
+
+namespace tiel::concurrent::container
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Prozessübergreifende Queue fester Kapazität in einem gemeinsam eingeblendeten Speicher-
+	///			bereich (POSIX shm bzw. eingeblendete Datei).
+	/// @remark	Die Elemente liegen in einem Ringpuffer, Lese- und Schreibposition sind atomare Indizes im
+	///			gemeinsamen Speicher. Erzeuger und Verbraucher synchronisieren sich nicht gegenseitig,
+	///			mehrere Erzeuger (bzw. Verbraucher) serialisieren sich über je eine Sperre im gemeinsamen
+	///			Speicher. Unter Linux ist dies ein prozessübergreifender, robuster pthread-Mutex, den der
+	///			Kernel beim Tod des Halters freigibt (unabhängig von PID-Namespaces), auf anderen
+	///			Plattformen eine SpinLock, deren Sperrwort Prozess-Id und Startmerkmal
+	///			(tiel::io::ProcessStartToken()) des Halters enthält.
+	///			Wiederherstellung nach dem Absturz eines beteiligten Prozesses:
+	///			- Die Sperre eines nicht mehr existierenden Prozesses wird übernommen. Ein Prozess, der
+	///			  die Prozess-Id des Halters wiederverwendet, gilt nicht als Halter.
+	///			- Ein Element wird erst nach vollständigem Kopieren durch Weitersetzen des Index
+	///			  veröffentlicht bzw. entnommen. Ein abgebrochenes TryPush() ist daher nie sichtbar, ein
+	///			  abgebrochenes TryPop() liefert das Element erneut.
+	///			- Ein neu gestarteter Prozess verbindet sich mit Open() wieder mit der bestehenden Queue.
+	///			Blockierendes Warten erfolgt unter Linux über prozessübergreifende Futexe auf Zählern im
+	///			gemeinsamen Speicher, auf anderen Plattformen über kurzes zyklisches Schlafen.
+	///			Kann eine Sperre nicht erlangt werden (unter Linux z.B. ENOTRECOVERABLE), werfen
+	///			TryPush(), TryPop(), Push() und Pop() wie std::mutex::lock() eine std::system_error.
+	/// @tparam T	muss trivial kopierbar sein und darf keine Zeiger in prozesslokalen Speicher enthalten.
+	template <typename T>
+	class SharedMemoryQueue final
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SharedMemoryQueue<T>: T muss trivial kopierbar sein");
+		static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+					  "SharedMemoryQueue<T>: prozessübergreifende Atomics müssen lock-free sein");
+
+		static constexpr uint64_t	Magic			= 0x51484D5345495454ULL; // "TTIESMHQ"
+		static constexpr uint32_t	Version			= 2;
+		static constexpr size_t		CacheLineSize	= 64;
+		static constexpr auto		WaitSlice		= std::chrono::milliseconds(100);
+
+	#ifdef __linux__
+		using LockType = pthread_mutex_t;			// robust, prozessübergreifend
+	#else
+		using LockType = std::atomic_uint64_t;		// Startmerkmal << 32 | Prozess-Id des Halters, 0 = frei
+	#endif
+
+		//---------------------------------------------------------------------------------------------
+		// Verwaltungsdaten am Anfang des gemeinsamen Speichers, gefolgt von den Elementen
+		struct SharedHeader
+		{
+			uint64_t									magic;
+			uint32_t									version;
+			uint32_t									elementSize;
+			uint64_t									capacity;			// Zweierpotenz
+			std::atomic_uint32_t						isClosed;
+			alignas(CacheLineSize) std::atomic_uint64_t	head;				// nächste Leseposition
+			LockType									consumerLock;
+			std::atomic_uint32_t						popSequence;		// Futex: Element entnommen
+			std::atomic_uint32_t						numPushWaiters;
+			alignas(CacheLineSize) std::atomic_uint64_t	tail;				// nächste Schreibposition
+			LockType									producerLock;
+			std::atomic_uint32_t						pushSequence;		// Futex: Element hinzugefügt
+			std::atomic_uint32_t						numPopWaiters;
+		};
+		static constexpr size_t SlotsOffset = (sizeof(SharedHeader) + CacheLineSize - 1) & ~(CacheLineSize - 1);
+
+		//---------------------------------------------------------------------------------------------
+		// Sperre im gemeinsamen Speicher, die einem abgestürzten Halter entzogen wird
+		class SharedLock final
+		{
+			LockType&	mLock;
+		public:
+		#ifdef __linux__
+			// wirft std::system_error, wenn die Sperre nicht erlangt wurde (z.B. ENOTRECOVERABLE), der
+			// Destruktor gibt daher nur eine tatsächlich gehaltene Sperre frei
+			SharedLock(LockType& lock) : mLock(lock)
+			{
+				const int result = ::pthread_mutex_lock(&mLock);
+				if(result == EOWNERDEAD)
+				{
+					// Halter ist abgestürzt: die Indizes sind stets konsistent (s.o.), Sperre übernehmen
+					::pthread_mutex_consistent(&mLock);
+				}
+				else if(result != 0)
+				{
+					throw std::system_error(result, std::generic_category(), "SharedMemoryQueue: Sperre nicht erlangt");
+				}
+			}
+			~SharedLock()
+			{
+				::pthread_mutex_unlock(&mLock);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Richtet die Sperre im gemeinsamen Speicher ein
+			static bool Init(LockType& lock)
+			{
+				pthread_mutexattr_t attributes;
+				if(::pthread_mutexattr_init(&attributes) != 0)
+				{
+					return false;
+				}
+				const bool isInitialized =		(::pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED) == 0)
+											&&	(::pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST) == 0)
+											&&	(::pthread_mutex_init(&lock, &attributes) == 0);
+				::pthread_mutexattr_destroy(&attributes);
+				return isInitialized;
+			}
+		#else
+			SharedLock(LockType& lock) : mLock(lock)
+			{
+				static const uint64_t	sOwnerId	= (uint64_t(tiel::io::ProcessStartToken(tiel::io::CurrentProcessId())) << 32)
+													| tiel::io::CurrentProcessId();
+				uint64_t				owner		= 0;
+
+				for(uint32_t numTries = 1; !mLock.compare_exchange_weak(owner, sOwnerId, std::memory_order_acquire); numTries++)
+				{
+					if(		(owner != 0) && (owner != sOwnerId) && ((numTries % 1024) == 0)
+						&&	!tiel::io::IsProcessAlive(static_cast<uint32_t>(owner), static_cast<uint32_t>(owner >> 32)))
+					{
+						// Halter existiert nicht mehr: Sperre übernehmen
+						if(mLock.compare_exchange_strong(owner, sOwnerId, std::memory_order_acquire))
+						{
+							break;
+						}
+					}
+					if((numTries % 64) == 0)
+					{
+						std::this_thread::yield();
+					}
+					owner = 0;
+				}
+			}
+			~SharedLock()
+			{
+				mLock.store(0, std::memory_order_release);
+			}
+			///------------------------------------------------------------------------------------------
+			/// Richtet die Sperre im gemeinsamen Speicher ein
+			static bool Init(LockType& lock)
+			{
+				lock.store(0, std::memory_order_relaxed);
+				return true;
+			}
+		#endif
+		};
+
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// Standard-Konstruktor, die Queue muss mit Create() oder Open() eingerichtet werden
+		SharedMemoryQueue() = default;
+		///----------------------------------------------------------------------------------------------
+		/// Copy-Konstruktor und Copy-Zuweisung nicht erlaubt
+		SharedMemoryQueue(const SharedMemoryQueue&) = delete;
+		SharedMemoryQueue& operator=(const SharedMemoryQueue&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Destruktor, blendet den gemeinsamen Speicher aus.
+		/// @remark	Die Queue selbst wird dabei nicht geschlossen, andere Prozesse arbeiten weiter.
+		~SharedMemoryQueue() = default;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt den empfohlenen Pfad für den gemeinsamen Speicher zurück (unter Linux im
+		///			POSIX-shm-Dateisystem /dev/shm, sonst im temporären Verzeichnis).
+		/// @param name [in]:	Name der Queue, muss ein gültiger Dateiname sein
+		static std::filesystem::path DefaultPath(std::string_view name)
+		{
+		#ifdef __linux__
+			return std::filesystem::path("/dev/shm") / name;
+		#else
+			return std::filesystem::temp_directory_path() / name;
+		#endif
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Legt einen neuen gemeinsamen Speicherbereich für die Queue an. Ein vorhandener
+		///			Bereich mit diesem Pfad wird ersetzt.
+		/// @param path [in]:		Pfad des gemeinsamen Speichers (siehe DefaultPath())
+		/// @param capacity [in]:	max. Anzahl Elemente, wird auf die nächste Zweierpotenz aufgerundet
+		/// @return					true, wenn der Bereich angelegt werden konnte.
+		[[nodiscard]] bool Create(const std::filesystem::path& path, size_t capacity)
+		{
+			//_ASSERT(false); // not tested
+			uint64_t roundedCapacity = 1;
+			while(roundedCapacity < capacity)
+			{
+				roundedCapacity <<= 1;
+			}
+			std::filesystem::path	tempPath = path;
+			std::error_code			error;
+			tempPath += ".init";
+
+			// vollständig initialisieren und erst dann unter dem endgültigen Namen sichtbar machen
+			if(!mFile.Create(tempPath, SlotsOffset + roundedCapacity*sizeof(T)))
+			{
+				return false;
+			}
+			SharedHeader* pHeader = new(mFile.Data()) SharedHeader{};
+			pHeader->magic			= Magic;
+			pHeader->version		= Version;
+			pHeader->elementSize	= sizeof(T);
+			pHeader->capacity		= roundedCapacity;
+			if(!SharedLock::Init(pHeader->consumerLock) || !SharedLock::Init(pHeader->producerLock))
+			{
+				mFile.Close();
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+			mFile.Close();
+
+			std::filesystem::rename(tempPath, path, error);
+			if(error)
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+			return Open(path);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Verbindet sich mit einem bestehenden gemeinsamen Speicherbereich der Queue.
+		/// @param path [in]:		Pfad des gemeinsamen Speichers
+		/// @return					true, wenn der Bereich zu SharedMemoryQueue<T> passt.
+		[[nodiscard]] bool Open(const std::filesystem::path& path)
+		{
+			//_ASSERT(false); // not tested
+			mHeader = nullptr;
+			if(!mFile.Open(path, tiel::io::MemoryMappedFile::AccessMode::ReadWrite) || (mFile.Size() < SlotsOffset))
+			{
+				mFile.Close();
+				return false;
+			}
+			SharedHeader* pHeader = reinterpret_cast<SharedHeader*>(mFile.Data());
+			if(		(pHeader->magic != Magic)
+				||	(pHeader->version != Version)
+				||	(pHeader->elementSize != sizeof(T))
+				||	(mFile.Size() < SlotsOffset + pHeader->capacity*sizeof(T)))
+			{
+				mFile.Close();
+				return false;
+			}
+			mHeader = pHeader;
+			mSlots	= mFile.Data() + SlotsOffset;
+			mMask	= pHeader->capacity - 1;
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob die Queue mit einem gemeinsamen Speicherbereich verbunden ist.
+		[[nodiscard]] bool IsOpen() const
+		{
+			return mHeader != nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Schließt die Queue für alle Prozesse, sodass keine weiteren Elemente mit TryPush()
+		///			aufgenommen werden. Bereits in der Queue befindliche Elemente können noch entnommen
+		///			werden. Blockierte Push()- und Pop()-Aufrufe kehren zurück.
+		/// @remark	Eine einmal geschlossene Queue kann nicht wieder geöffnet werden.
+		void Close()
+		{
+			//_ASSERT(false); // not tested
+			if(mHeader != nullptr)
+			{
+				mHeader->isClosed.store(1, std::memory_order_release);
+				mHeader->pushSequence.fetch_add(1, std::memory_order_seq_cst);
+				mHeader->popSequence.fetch_add(1, std::memory_order_seq_cst);
+				WakeAll(mHeader->pushSequence);
+				WakeAll(mHeader->popSequence);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Prüft, ob die Queue geschlossen ist.
+		[[nodiscard]] bool IsClosed() const
+		{
+			return (mHeader == nullptr) || (mHeader->isClosed.load(std::memory_order_relaxed) != 0);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Prüft, ob die Queue leer ist.
+		[[nodiscard]] bool IsEmpty() const
+		{
+			return Size() == 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob die Queue voll ist.
+		[[nodiscard]] bool IsFull() const
+		{
+			return (mHeader != nullptr) && (Size() >= MaxSize());
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Gibt die Anzahl der Queue-Elemente zurück.
+		[[nodiscard]] size_t Size() const
+		{
+			if(mHeader == nullptr)
+			{
+				return 0;
+			}
+			const uint64_t head = mHeader->head.load(std::memory_order_acquire);
+			return static_cast<size_t>(mHeader->tail.load(std::memory_order_acquire) - head);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief Gibt die maximale gültige Anzahl Queue-Elemente zurück.
+		[[nodiscard]] size_t MaxSize() const
+		{
+			return (mHeader != nullptr) ? static_cast<size_t>(mHeader->capacity) : 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt ein Element der Queue hinzu, sofern die Queue nicht geschlossen oder voll ist.
+		/// @param value	Wert, der am Ende der Queue hinzugefügt werden soll.
+		/// @return			true, wenn das angegene Element der Queue hinzugefügt werden konnte.
+		[[nodiscard]] bool TryPush(const T& value)
+		{
+			if(IsClosed())
+			{
+				return false;
+			}
+			{
+				SharedLock		lock(mHeader->producerLock);
+				const uint64_t	tail = mHeader->tail.load(std::memory_order_relaxed);
+
+				if(		(mHeader->isClosed.load(std::memory_order_acquire) != 0)
+					||	(tail - mHeader->head.load(std::memory_order_acquire) >= mHeader->capacity))
+				{
+					return false;
+				}
+				std::memcpy(mSlots + (tail & mMask)*sizeof(T), &value, sizeof(T));
+				mHeader->tail.store(tail + 1, std::memory_order_release);
+			}
+			mHeader->pushSequence.fetch_add(1, std::memory_order_seq_cst);
+			if(mHeader->numPopWaiters.load(std::memory_order_seq_cst) != 0)
+			{
+				WakeAll(mHeader->pushSequence);
+			}
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entfernt das erste Element aus der Queue und gibt dieses zurück.
+		/// @return		wenn die Queue leer ist, hält das zurückgegebene std::optional<T> keinen Wert,
+		///				sont wird der Wert des ersten Elements der Queue zurückgegeben.
+		std::optional<T> TryPop()
+		{
+			if((mHeader == nullptr) || IsEmpty())
+			{
+				return {};
+			}
+			std::optional<T> optValue;
+			{
+				SharedLock		lock(mHeader->consumerLock);
+				const uint64_t	head = mHeader->head.load(std::memory_order_relaxed);
+
+				if(head == mHeader->tail.load(std::memory_order_acquire))
+				{
+					return {};
+				}
+				optValue.emplace();
+				std::memcpy(&optValue.value(), mSlots + (head & mMask)*sizeof(T), sizeof(T));
+				mHeader->head.store(head + 1, std::memory_order_release);
+			}
+			mHeader->popSequence.fetch_add(1, std::memory_order_seq_cst);
+			if(mHeader->numPushWaiters.load(std::memory_order_seq_cst) != 0)
+			{
+				WakeAll(mHeader->popSequence);
+			}
+			return optValue;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt ein Element der Queue hinzu und blockiert, solange die Queue voll ist.
+		/// @param value [in]:			Wert, der am Ende der Queue hinzugefügt werden soll.
+		/// @param waitDurationMS [in]:	max. Wartezeit in Millisekunden, < 0 ohne Zeitbegrenzung
+		/// @return						true, wenn das Element hinzugefügt wurde. false, wenn die Queue
+		///								geschlossen ist oder die Wartezeit abgelaufen ist.
+		[[nodiscard]] bool Push(const T& value, int waitDurationMS = -1)
+		{
+			//_ASSERT(false); // not tested
+			const auto deadline = Deadline(waitDurationMS);
+			while(!TryPush(value))
+			{
+				if(IsClosed() || !WaitFor(mHeader->popSequence, mHeader->numPushWaiters, deadline, [this]() { return !IsFull(); }))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entnimmt das erste Element der Queue und blockiert, solange die Queue offen und leer ist.
+		/// @param waitDurationMS [in]:	max. Wartezeit in Millisekunden, < 0 ohne Zeitbegrenzung
+		/// @return						Element, bzw. ein leeres Element, wenn die Queue leer und
+		///								geschlossen ist oder die Wartezeit abgelaufen ist.
+		std::optional<T> Pop(int waitDurationMS = -1)
+		{
+			//_ASSERT(false); // not tested
+			const auto deadline = Deadline(waitDurationMS);
+			while(true)
+			{
+				if(std::optional<T> optValue = TryPop(); optValue.has_value())
+				{
+					return optValue;
+				}
+				if(IsClosed())
+				{
+					return TryPop();
+				}
+				if(!WaitFor(mHeader->pushSequence, mHeader->numPopWaiters, deadline, [this]() { return !IsEmpty(); }))
+				{
+					return {};
+				}
+			}
+		}
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		///----------------------------------------------------------------------------------------------
+		/// Berechnet den Zeitpunkt, bis zu dem gewartet wird (max() für unbegrenztes Warten)
+		static Clock::time_point Deadline(int waitDurationMS)
+		{
+			return (waitDurationMS < 0) ? (Clock::time_point::max)() : Clock::now() + std::chrono::milliseconds(waitDurationMS);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Wartet, bis sich "sequence" ändert, die Bedingung erfüllt ist oder die Queue geschlossen wurde.
+		/// Gewartet wird in Zeitscheiben, sodass auch ein verlorenes Wecken eines abgestürzten Prozesses
+		/// nicht zu dauerhaftem Blockieren führt.
+		/// @return			false, wenn der Zeitpunkt "deadline" erreicht wurde.
+		template <typename Predicate>
+		bool WaitFor(std::atomic_uint32_t& sequence, std::atomic_uint32_t& numWaiters, Clock::time_point deadline, Predicate isReady)
+		{
+			const auto now = Clock::now();
+			if(now >= deadline)
+			{
+				return false;
+			}
+			numWaiters.fetch_add(1, std::memory_order_seq_cst);
+			const uint32_t expected = sequence.load(std::memory_order_seq_cst);
+			if(!isReady() && !IsClosed())
+			{
+				const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+				WaitOnWord(sequence, expected, (std::min)(remaining + std::chrono::milliseconds(1), std::chrono::milliseconds(WaitSlice)));
+			}
+			numWaiters.fetch_sub(1, std::memory_order_seq_cst);
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Blockiert, solange word == expected ist (höchstens "timeout")
+		static void WaitOnWord(std::atomic_uint32_t& word, uint32_t expected, std::chrono::milliseconds timeout)
+		{
+		#ifdef __linux__
+			static_assert(sizeof(std::atomic_uint32_t) == sizeof(uint32_t));
+			const timespec waitTime { static_cast<time_t>(timeout.count()/1000), static_cast<long>((timeout.count()%1000)*1000000) };
+			::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &waitTime, nullptr, 0);
+		#else
+			// kein prozessübergreifendes WaitOnAddress verfügbar
+			if(word.load(std::memory_order_acquire) == expected)
+			{
+				std::this_thread::sleep_for((std::min)(timeout, std::chrono::milliseconds(1)));
+			}
+		#endif
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Weckt alle Prozesse, die auf "word" warten
+		static void WakeAll([[maybe_unused]] std::atomic_uint32_t& word)
+		{
+		#ifdef __linux__
+			::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+		#endif
+		}
+
+		tiel::io::MemoryMappedFile	mFile;
+		SharedHeader*				mHeader		= nullptr;
+		std::byte*					mSlots		= nullptr;
+		uint64_t					mMask		= 0;
+	}; // class SharedMemoryQueue
+
+} // namespace tiel::concurrent::container
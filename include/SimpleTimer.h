@@ -1,24 +1,209 @@
 #pragma once
+#include <atomic>
 #include <ctime>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define TIEL_TIMER_X86
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+		#include <x86intrin.h>
+	#endif
+#endif
 
 namespace tiel::timer
 {
+	//_________________________________________________________________________________________________
+	/// @brief	std::chrono-Clock auf Basis des invarianten Time Stamp Counters (TSC) der CPU.
+	/// @remark	now() liest den TSC per rdtscp mit anschließendem lfence, sodass weder vorherige noch
+	///			nachfolgende Befehle die Messung überholen, und rechnet die Ticks mit dem gegen
+	///			std::chrono::steady_clock kalibrierten Faktor in Nanosekunden um (Epoche wie
+	///			steady_clock). Das kostet nur einen Bruchteil eines steady_clock::now()-Aufrufs.
+	///			Kalibriert wird einmalig über Calibrate() (ca. 10 ms), für TscTimer automatisch beim
+	///			Programmstart. now() selbst kalibriert nie und enthält keine Initialisierungsprüfung,
+	///			vor der Kalibrierung liefert es die Zeit von steady_clock.
+	///			Meldet die CPU keinen invarianten TSC (oder kein rdtscp, bzw. keine x86-CPU), verwendet
+	///			now() immer steady_clock.
+	class TscClock final
+	{
+		struct Calibration
+		{
+			bool		isTscUsed	= false;
+			double		nsPerTick	= 0.0;
+			uint64_t	tscBase		= 0;
+			int64_t		nsBase		= 0;	// steady_clock-Zeit zu tscBase
+		};
+
+	public:
+		using rep			= int64_t;
+		using period		= std::nano;
+		using duration		= std::chrono::nanoseconds;
+		using time_point	= std::chrono::time_point<TscClock>;
+		static constexpr bool is_steady = true;
+
+		//---------------------------------------------------------------------------------------------
+		/// @brief	Gibt den aktuellen Zeitpunkt zurück.
+		static time_point now() noexcept
+		{
+		#ifdef TIEL_TIMER_X86
+			const Calibration* pCalibration = spCalibration.load(std::memory_order_acquire);
+			if((pCalibration != nullptr) && pCalibration->isTscUsed)
+			{
+				// vorzeichenbehaftet: der TSC dieses Kerns kann leicht hinter dem des kalibrierenden Kerns liegen
+				const int64_t ticks = static_cast<int64_t>(ReadTsc() - pCalibration->tscBase);
+				return time_point(duration(pCalibration->nsBase + static_cast<rep>(static_cast<double>(ticks)*pCalibration->nsPerTick)));
+			}
+		#endif
+			return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+		}
+		//---------------------------------------------------------------------------------------------
+		/// @brief	Kalibriert den TSC einmalig, indem die Frequenz über 10 ms gegen steady_clock
+		///			gemessen wird. Weitere Aufrufe kehren sofort zurück.
+		/// @remark	Gehört zum Programmstart bzw. zur Initialisierung, nicht auf den gemessenen Pfad.
+		static void Calibrate()
+		{
+			static const Calibration sCalibration = MeasureCalibration();
+			spCalibration.store(&sCalibration, std::memory_order_release);
+		}
+		//---------------------------------------------------------------------------------------------
+		/// @brief	true, wenn now() den TSC liest (sonst steady_clock)
+		static bool IsTscUsed() noexcept
+		{
+			const Calibration* pCalibration = spCalibration.load(std::memory_order_acquire);
+			return (pCalibration != nullptr) && pCalibration->isTscUsed;
+		}
+		//---------------------------------------------------------------------------------------------
+		/// @brief	Gibt die kalibrierte Anzahl Nanosekunden je TSC-Tick zurück (0 ohne TSC).
+		static double NanosecondsPerTick() noexcept
+		{
+			const Calibration* pCalibration = spCalibration.load(std::memory_order_acquire);
+			return (pCalibration != nullptr) ? pCalibration->nsPerTick : 0.0;
+		}
+		//---------------------------------------------------------------------------------------------
+		/// @brief	Kalibriert beim Programmstart (dynamische Initialisierung). Als Member eines
+		///			Templates wird die Kalibrierung nur in Programmen ausgeführt, die isDone verwenden
+		///			(z.B. TscTimer).
+		template <class = void>
+		struct StartupCalibration
+		{
+			inline static const bool isDone = (Calibrate(), true);
+		};
+
+	private:
+		//---------------------------------------------------------------------------------------------
+		// Misst die TSC-Frequenz über 10 ms gegen steady_clock
+		static Calibration MeasureCalibration() noexcept
+		{
+			Calibration calibration;
+		#ifdef TIEL_TIMER_X86
+			if(HasInvariantTsc())
+			{
+				using namespace std::chrono;
+				uint64_t					tsc0 = 0, tsc1 = 0;
+				steady_clock::time_point	steady0, steady1;
+				ReadTscAndSteady(tsc0, steady0);
+				std::this_thread::sleep_for(milliseconds(10));
+				ReadTscAndSteady(tsc1, steady1);
+				if(tsc1 > tsc0)
+				{
+					calibration.isTscUsed	= true;
+					calibration.nsPerTick	= static_cast<double>(duration_cast<nanoseconds>(steady1 - steady0).count())/static_cast<double>(tsc1 - tsc0);
+					calibration.tscBase		= tsc1;
+					calibration.nsBase		= duration_cast<nanoseconds>(steady1.time_since_epoch()).count();
+				}
+			}
+		#endif
+			return calibration;
+		}
+
+		inline static std::atomic<const Calibration*> spCalibration = nullptr;
+
+	#ifdef TIEL_TIMER_X86
+		//---------------------------------------------------------------------------------------------
+		// Liest den TSC, nachdem alle vorherigen Befehle abgeschlossen sind, und bevor nachfolgende
+		// Befehle beginnen
+		static uint64_t ReadTsc() noexcept
+		{
+			unsigned int	aux;
+			const uint64_t	tsc = __rdtscp(&aux);
+			_mm_lfence();
+			return tsc;
+		}
+		//---------------------------------------------------------------------------------------------
+		// Liest TSC und steady_clock möglichst zum selben Zeitpunkt: von mehreren Messungen wird die
+		// kürzeste verwendet, damit eine Unterbrechung des Threads die Kalibrierung nicht verfälscht
+		static void ReadTscAndSteady(uint64_t& tsc, std::chrono::steady_clock::time_point& steady) noexcept
+		{
+			uint64_t minTicks = (std::numeric_limits<uint64_t>::max)();
+			for(int i = 0; i < 8; i++)
+			{
+				const uint64_t	before	= ReadTsc();
+				const auto		now		= std::chrono::steady_clock::now();
+				const uint64_t	after	= ReadTsc();
+				if(after - before < minTicks)
+				{
+					minTicks	= after - before;
+					tsc			= before + (after - before)/2;
+					steady		= now;
+				}
+			}
+		}
+		//---------------------------------------------------------------------------------------------
+		// CPUID 0x80000007 EDX Bit 8: invarianter TSC, CPUID 0x80000001 EDX Bit 27: rdtscp
+		static bool HasInvariantTsc() noexcept
+		{
+			unsigned int regs[4] = {};
+			Cpuid(0x80000000u, regs);
+			if(regs[0] < 0x80000007u)
+			{
+				return false;
+			}
+			Cpuid(0x80000001u, regs);
+			const bool hasRdtscp = (regs[3] & (1u << 27)) != 0;
+			Cpuid(0x80000007u, regs);
+			return hasRdtscp && ((regs[3] & (1u << 8)) != 0);
+		}
+		static void Cpuid(unsigned int leaf, unsigned int (&regs)[4]) noexcept
+		{
+		#ifdef _MSC_VER
+			int cpuInfo[4];
+			__cpuid(cpuInfo, static_cast<int>(leaf));
+			for(int i = 0; i < 4; i++)
+			{
+				regs[i] = static_cast<unsigned int>(cpuInfo[i]);
+			}
+		#else
+			__cpuid(leaf, regs[0], regs[1], regs[2], regs[3]);
+		#endif
+		}
+	#endif
+	}; // class TscClock
+
 	//_________________________________________________________________________________________________
 	// Einfacher std::chrono-basierter Timer.
 	// Die Startzeit wird im Konstruktor erstmalig gesetzt.
-	class SimpleTimer
+	// Clock ist die Zeitquelle für Start/Stop und die abgelaufene Zeit, z.B. steady_clock (SimpleTimer)
+	// oder TscClock (TscTimer). TimePointUTC() und DurationSinceCreationMidnight() basieren immer auf
+	// steady_clock.
+	template <class Clock = std::chrono::steady_clock>
+	class BasicSimpleTimer
 	{
-		std::chrono::steady_clock::time_point mStartSteadyTP{};
-		std::chrono::steady_clock::time_point mStopSteadyTP{};
+		typename Clock::time_point mStartSteadyTP{};
+		typename Clock::time_point mStopSteadyTP{};
 		std::chrono::steady_clock::time_point mSteadyTPMidnightUTC	= std::chrono::steady_clock::now();
 		std::chrono::system_clock::time_point mEpochTPMidnightUTC	= std::chrono::system_clock::now();
 
 	public:
 		//---------------------------------------------------------------------------------------------
-		SimpleTimer()
+		BasicSimpleTimer()
 		{
 			using namespace std::chrono;
 			using namespace std::chrono_literals;
@@ -26,12 +211,16 @@ namespace tiel::timer
 			auto dayDuration		 = mEpochTPMidnightUTC.time_since_epoch()%24h;
 			mEpochTPMidnightUTC		-= std::chrono::duration_cast<microseconds>(dayDuration);
 			mSteadyTPMidnightUTC	-= std::chrono::duration_cast<microseconds>(dayDuration);
-			mStartSteadyTP			 = std::chrono::steady_clock::now();;
+			if constexpr(std::is_same_v<Clock, TscClock>)
+			{
+				(void)Clock::template StartupCalibration<>::isDone; // fordert die Kalibrierung beim Programmstart an
+			}
+			mStartSteadyTP			 = Clock::now();
 			mStopSteadyTP			 = mStartSteadyTP;
 		}
 		//---------------------------------------------------------------------------------------------
 		/// Copy-Konstruktor
-		SimpleTimer(const SimpleTimer& other)
+		BasicSimpleTimer(const BasicSimpleTimer& other)
 			:	mStartSteadyTP(other.mStartSteadyTP),
 				mStopSteadyTP(other.mStopSteadyTP),
 				mSteadyTPMidnightUTC(other.mSteadyTPMidnightUTC),
@@ -39,7 +228,7 @@ namespace tiel::timer
 		{ }
 		//---------------------------------------------------------------------------------------------
 		/// Copy-Assignment
-		SimpleTimer& operator=(const SimpleTimer& rhs)
+		BasicSimpleTimer& operator=(const BasicSimpleTimer& rhs)
 		{
 			mStartSteadyTP			= rhs.mStartSteadyTP;
 			mStopSteadyTP			= rhs.mStopSteadyTP;
@@ -51,124 +240,143 @@ namespace tiel::timer
 		// setzt die Start-Zeit
 		void Start()
 		{
-			mStartSteadyTP = std::chrono::steady_clock::now();
+			mStartSteadyTP = Clock::now();
 			mStopSteadyTP = mStartSteadyTP;
 		}
 		//---------------------------------------------------------------------------------------------
 		// setzt die Stop-Zeit
 		void Stop()
 		{
-			mStopSteadyTP = std::chrono::steady_clock::now();
+			mStopSteadyTP = Clock::now();
 		}
 		//---------------------------------------------------------------------------------------------
-		// Gibt die, mit xxxStop() gemessene Zeit in Mikrosekunden zurck
+		// Gibt die, mit xxxStop() gemessene Zeit in Nanosekunden zurück
+		int64_t llGetMeasuredTimeNs() const
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(mStopSteadyTP - mStartSteadyTP).count();
+		}
+		//---------------------------------------------------------------------------------------------
+		// Gibt die, mit xxxStop() gemessene Zeit in Mikrosekunden zurück
 		uint64_t llGetMeasuredTimeUs() const
 		{
 			return std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count();
 		}
 		//---------------------------------------------------------------------------------------------
-		// Gibt die, mit xxxStop() gemessene Zeit in Mikrosekunden zurck
+		// Gibt die, mit xxxStop() gemessene Zeit in Mikrosekunden zurück
 		uint32_t lGetMeasuredTimeUs() const
 		{
 			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count());
 		}
 		//---------------------------------------------------------------------------------------------
-		// Gibt die, mit xxxStop() gemessene Zeit in Millisekunden zurck
+		// Gibt die, mit xxxStop() gemessene Zeit in Millisekunden zurück
 		uint64_t llGetMeasuredTimeMs() const
 		{
 			return std::chrono::duration_cast<std::chrono::milliseconds>(mStopSteadyTP - mStartSteadyTP).count();
 		}
 		//---------------------------------------------------------------------------------------------
-		// Gibt die, mit xxxStop() gemessene Zeit in Millisekunden zurck
+		// Gibt die, mit xxxStop() gemessene Zeit in Millisekunden zurück
 		uint32_t lGetMeasuredTimeMs() const
 		{
 			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(mStopSteadyTP - mStartSteadyTP).count());
 		}
 		//---------------------------------------------------------------------------------------------
-		// Gibt die, mit xxxStop() gemessene Zeit mit Nachkommastellen in Millisekunden zurck
+		// Gibt die, mit xxxStop() gemessene Zeit mit Nachkommastellen in Millisekunden zurück
 		double dGetMeasuredTimeMs() const
 		{
 			return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count()) / 1000.0;
 		}
 		//---------------------------------------------------------------------------------------------
-		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Millisekunden als double zurck
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Millisekunden als double zurück
 		double dStopMs()
 		{
-			mStopSteadyTP = std::chrono::steady_clock::now();
+			mStopSteadyTP = Clock::now();
 			return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count()) / 1000.0;
 		}
 		//---------------------------------------------------------------------------------------------
-		// setzt die Stop-Zeit und gibt die abgelaufene Zeit in Millisekunden zurck
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit in Millisekunden zurück
 		int32_t lStopMs()
 		{
-			mStopSteadyTP = std::chrono::steady_clock::now();
+			mStopSteadyTP = Clock::now();
 			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(mStopSteadyTP - mStartSteadyTP).count());
 		}
 		//---------------------------------------------------------------------------------------------
-		// setzt die Stop-Zeit und gibt die abgelaufene Zeit in Millisekunden zurck
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit in Millisekunden zurück
 		int64_t llStopMs()
 		{
-			mStopSteadyTP = std::chrono::steady_clock::now();
+			mStopSteadyTP = Clock::now();
 			return std::chrono::duration_cast<std::chrono::milliseconds>(mStopSteadyTP - mStartSteadyTP).count();
 		}
 		//---------------------------------------------------------------------------------------------
-		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Mikrosekunden zurck
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Nanosekunden zurück
+		int64_t llStopNs()
+		{
+			mStopSteadyTP = Clock::now();
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(mStopSteadyTP - mStartSteadyTP).count();
+		}
+		//---------------------------------------------------------------------------------------------
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Mikrosekunden zurück
 		int32_t lStopUs()
 		{
-			mStopSteadyTP = std::chrono::steady_clock::now();
+			mStopSteadyTP = Clock::now();
 			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count());
 		}
 		//---------------------------------------------------------------------------------------------
-		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Mikrosekunden als int64_t zurck
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Mikrosekunden als int64_t zurück
 		int64_t llStopUs()
 		{
-			mStopSteadyTP = std::chrono::steady_clock::now();
+			mStopSteadyTP = Clock::now();
 			return std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count();
 		}
 		//---------------------------------------------------------------------------------------------
-		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Millisekunden als double zurck
+		// setzt die Stop-Zeit und gibt die abgelaufene Zeit seit Start() in Millisekunden als double zurück
 		std::string StopMs()
 		{
 			return std::to_string(dStopMs());
 		}
 		//---------------------------------------------------------------------------------------------
-		// gibt die abgelaufene Zeit seit Start() in Millisekunden als double zurck
+		// gibt die abgelaufene Zeit seit Start() in Millisekunden als double zurück
 		double dElapseMs() const
 		{
-			return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStartSteadyTP).count()) / 1000.0;
+			return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mStartSteadyTP).count()) / 1000.0;
 		}
 		//---------------------------------------------------------------------------------------------
-		// gibt die abgelaufene Zeit in Millisekunden zurck
+		// gibt die abgelaufene Zeit in Millisekunden zurück
 		int32_t lElapsedMs() const
 		{
-			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStartSteadyTP).count());
+			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - mStartSteadyTP).count());
 		}
 		//---------------------------------------------------------------------------------------------
-		// gibt die abgelaufene Zeit in Millisekunden zurck
+		// gibt die abgelaufene Zeit in Millisekunden zurück
 		int64_t llElapsedMs() const
 		{
-			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStartSteadyTP).count();
+			return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - mStartSteadyTP).count();
 		}
 		//---------------------------------------------------------------------------------------------
-		// gibt die abgelaufene Zeit seit Start() in Mikrosekunden zurck
+		// gibt die abgelaufene Zeit seit Start() in Nanosekunden zurück
+		int64_t llElapseNs() const
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mStartSteadyTP).count();
+		}
+		//---------------------------------------------------------------------------------------------
+		// gibt die abgelaufene Zeit seit Start() in Mikrosekunden zurück
 		int32_t lElapseUs() const
 		{
-			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStartSteadyTP).count());
+			return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mStartSteadyTP).count());
 		}
 		//---------------------------------------------------------------------------------------------
-		// gibt die abgelaufene Zeit seit Start() in Mikrosekunden als int64_t zurck
+		// gibt die abgelaufene Zeit seit Start() in Mikrosekunden als int64_t zurück
 		int64_t llElapseUs() const
 		{
-			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStartSteadyTP).count();
+			return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mStartSteadyTP).count();
 		}
 		//---------------------------------------------------------------------------------------------
-		// gibt die abgelaufene Zeit seit Start() in Millisekunden mit Nachkommastellen als string zurck
+		// gibt die abgelaufene Zeit seit Start() in Millisekunden mit Nachkommastellen als string zurück
 		std::string ElapsedMs() const
 		{
 			return std::to_string(dElapseMs());
 		}
 		//---------------------------------------------------------------------------------------------
-		/// @brief	Gibt den Zeitpunkt seit dem 1.1.1970 (UTC) zurck. Die Messung basiert jedoch auf 
+		/// @brief	Gibt den Zeitpunkt seit dem 1.1.1970 (UTC) zurück. Die Messung basiert jedoch auf 
 		///			auf der monotonic std::chrono::steady_clock.
 		std::chrono::system_clock::time_point TimePointUTC() const
 		{
@@ -177,15 +385,15 @@ namespace tiel::timer
 		}
 		//---------------------------------------------------------------------------------------------
 		/// @brief	Gibt die verstrichene Zeit seit Mitternacht (UTC) des Erzeugungsdatums
-		///			dieser Instanz zurck
+		///			dieser Instanz zurück
 		std::chrono::steady_clock::duration DurationSinceCreationMidnight() const
 		{
 			return (std::chrono::steady_clock::now()-mSteadyTPMidnightUTC);
 		}
 		//---------------------------------------------------------------------------------------------
 		/// @brief	Gibt die verstrichene Zeit seit Mitternacht (UTC) des Erzeugungsdatums
-		///			dieser Instanz zurck
-		/// @param timepoint [in]		Zeitpunkt, fr die die Zeitspanne bestimmt werden soll
+		///			dieser Instanz zurück
+		/// @param timepoint [in]		Zeitpunkt, für die die Zeitspanne bestimmt werden soll
 		std::chrono::steady_clock::duration DurationSinceCreationMidnight(std::chrono::steady_clock::time_point timepoint) const
 		{
 			return (timepoint-mSteadyTPMidnightUTC);
@@ -194,7 +402,7 @@ namespace tiel::timer
 		// gibt die bisher verstrichene Zeit in Millisekunden auf der Konsole aus
 		void PrintElapsedTime(std::string_view _Prefix) const
 		{
-			printf("%s: %6.3f ms\n", _Prefix.data(), static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStartSteadyTP).count()) / 1000.0);
+			printf("%s: %6.3f ms\n", _Prefix.data(), static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mStartSteadyTP).count()) / 1000.0);
 		}
 		//---------------------------------------------------------------------------------------------
 		// gibt die gestoppte Zeit in Millisekunden auf der Konsole aus
@@ -203,4 +411,12 @@ namespace tiel::timer
 			printf("%s: %6.3f ms\n", _Prefix.data(), static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(mStopSteadyTP - mStartSteadyTP).count()) / 1000.0);
 		}
 	};
+
+	//_________________________________________________________________________________________________
+	// Timer auf Basis von std::chrono::steady_clock
+	using SimpleTimer = BasicSimpleTimer<std::chrono::steady_clock>;
+
+	//_________________________________________________________________________________________________
+	// Timer auf Basis des TSC (siehe TscClock) für Messungen im Bereich weniger Nanosekunden
+	using TscTimer = BasicSimpleTimer<TscClock>;
 } // namespace asentics::timer
\ No newline at end of file
@@ -0,0 +1,300 @@
+#pragma once
+#include <algorithm>
+#include <deque>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <string>
+#include <atomic>
+#include <limits>
+#include <cstring>
+#include <system_error>
+#include "MemoryMappedFile.h"
+#include "Serializer.h"
+
+namespace tiel::concurrent::container
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Konfiguration für das Auslagern von Queue-Elementen in Segmentdateien.
+	struct SpillOptions
+	{
+		std::filesystem::path	directory;							///< Verzeichnis der Segmentdateien (leer: temp. Verzeichnis)
+		size_t					memoryThreshold = 100000;			///< max. Anzahl Elemente im Speicher
+		size_t					segmentSize		= 64*1024*1024;		///< Größe einer Segmentdatei in Bytes
+	};
+
+	//_________________________________________________________________________________________________
+	/// @brief	FIFO-Speicher, der serialisierte Elemente in eingeblendete, nur angehängte Segmentdateien
+	///			schreibt und diese sequentiell wieder ausliest.
+	/// @remark	Elemente werden direkt in den eingeblendeten Speicher serialisiert bzw. direkt aus diesem
+	///			erzeugt (keine Zwischenpuffer). Eine Segmentdatei wird gelöscht, sobald alle ihre
+	///			Elemente entnommen wurden.
+	///			Die Klasse ist nicht threadsicher, die Synchronisation übernimmt die besitzende Queue.
+	/// @tparam T	Serializer<T> muss spezialisiert sein (siehe Serializer.h), sobald Elemente
+	///				geschrieben oder gelesen werden.
+	template <typename T>
+	class SpillStore final
+	{
+		struct Segment
+		{
+			tiel::io::MemoryMappedFile	file;
+			std::filesystem::path		path;
+			size_t						writeOffset = 0;	// Ende des zuletzt geschriebenen Datensatzes
+			size_t						readOffset	= 0;	// Anfang des nächsten zu lesenden Datensatzes
+		};
+
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor
+		/// @param options		Verzeichnis und Segmentgröße der Spill-Dateien
+		explicit SpillStore(SpillOptions options)
+			: mOptions(std::move(options)), mStoreId(sNextStoreId.fetch_add(1, std::memory_order_relaxed))
+		{
+			if(mOptions.directory.empty())
+			{
+				std::error_code error;
+				mOptions.directory = std::filesystem::temp_directory_path(error);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist weder kopier- noch verschiebbar
+		SpillStore(const SpillStore&) = delete;
+		SpillStore& operator=(const SpillStore&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, löscht alle Segmentdateien
+		~SpillStore()
+		{
+			Clear();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Hängt das Element an das aktuelle Segment an. Ist dieses voll, wird ein neues Segment
+		///			angelegt.
+		/// @param value	zu serialisierendes Element
+		/// @return			true, wenn das Element geschrieben werden konnte.
+		[[nodiscard]] bool Push(const T& value)
+		{
+			const size_t payloadSize = Serializer<T>::Size(value);
+			if(payloadSize > (std::numeric_limits<uint32_t>::max)())
+			{
+				return false;
+			}
+			const size_t recordSize = SerializedRecord::TotalSize(payloadSize);
+
+			if(mSegments.empty() || (mSegments.back().writeOffset + recordSize > mSegments.back().file.Size()))
+			{
+				if(!AddSegment(recordSize))
+				{
+					return false;
+				}
+			}
+			Segment& segment = mSegments.back();
+			segment.writeOffset += SerializedRecord::Write(value, segment.file.Data() + segment.writeOffset);
+			++mSize;
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Hängt einen bereits serialisierten Datensatz (Format SerializedRecord) unverändert an.
+		/// @param pRecord		Anfang des Datensatzes
+		/// @param recordSize	Größe des Datensatzes inklusive Kopf und Füllbytes
+		/// @return				true, wenn der Datensatz geschrieben werden konnte.
+		[[nodiscard]] bool PushRecord(const std::byte* pRecord, size_t recordSize)
+		{
+			if(mSegments.empty() || (mSegments.back().writeOffset + recordSize > mSegments.back().file.Size()))
+			{
+				if(!AddSegment(recordSize))
+				{
+					return false;
+				}
+			}
+			Segment& segment = mSegments.back();
+			std::memcpy(segment.file.Data() + segment.writeOffset, pRecord, recordSize);
+			segment.writeOffset += recordSize;
+			++mSize;
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entnimmt das älteste Element. Ein vollständig gelesenes Segment wird gelöscht.
+		/// @return		wenn keine Elemente ausgelagert sind, hält das zurückgegebene std::optional<T>
+		///				keinen Wert.
+		std::optional<T> Pop()
+		{
+			if(mSize == 0)
+			{
+				return {};
+			}
+			Segment&		segment = mSegments.front();
+			const std::byte* pRecord = segment.file.Data() + segment.readOffset;
+			T				value	= SerializedRecord::Read<T>(pRecord);
+
+			segment.readOffset += SerializedRecord::TotalSize(SerializedRecord::PayloadSize(pRecord));
+			--mSize;
+			if(segment.readOffset >= segment.writeOffset)
+			{
+				RemoveFrontSegment();
+			}
+			return ToOptional(value);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Erzeugt eine Kopie des ältesten Elements, ohne es zu entnehmen.
+		[[nodiscard]] std::optional<T> Front() const
+		{
+			if(mSize == 0)
+			{
+				return {};
+			}
+			const Segment&	segment = mSegments.front();
+			T				value	= SerializedRecord::Read<T>(segment.file.Data() + segment.readOffset);
+			return ToOptional(value);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entfernt alle Elemente, für die die Filterfunktion true zurückgibt.
+		/// @remark	Die verbleibenden Datensätze werden unverändert in neue Segmente umkopiert, der
+		///			Speicherbedarf bleibt dabei auf ein Element begrenzt. Erst wenn alle verbleibenden
+		///			Datensätze geschrieben sind, werden die alten Segmente ersetzt.
+		/// @param filter [in]:			Filterfunktion, die für alle zu entfernenden Elemente true zurückgibt
+		/// @param numRemoved [out]:	Anzahl der entfernten Elemente
+		/// @return						false, wenn die verbleibenden Elemente nicht geschrieben werden
+		///								konnten. Der SpillStore bleibt dann unverändert (numRemoved == 0).
+		[[nodiscard]] bool RemoveByFilter(const std::function<bool(const T& value)>& filter, size_t& numRemoved)
+		{
+			SpillStore	remaining(mOptions);
+			bool		isWritten	= true;
+
+			numRemoved = 0;
+			ForEachRecord([&](const std::byte* pRecord, size_t recordSize)
+				{
+					if(!isWritten)
+					{
+						return;
+					}
+					if(filter(SerializedRecord::Read<T>(pRecord)))
+					{
+						++numRemoved;
+					}
+					else
+					{
+						isWritten = remaining.PushRecord(pRecord, recordSize);
+					}
+				});
+			if(!isWritten)
+			{
+				numRemoved = 0;
+				return false;
+			}
+			std::swap(mSegments, remaining.mSegments);
+			std::swap(mSize, remaining.mSize);
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Hängt alle Elemente von "mv_other" ohne Kopieren an, indem dessen Segmente übernommen
+		///			werden.
+		/// @param mv_other [in, out]:	ist anschließend leer
+		void Append(SpillStore&& mv_other)
+		{
+			for(Segment& segment : mv_other.mSegments)
+			{
+				mSegments.push_back(std::move(segment));
+			}
+			mSize += mv_other.mSize;
+			mv_other.mSegments.clear();
+			mv_other.mSize = 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft für jeden ausgelagerten Datensatz (älteste zuerst) func(pRecord, recordSize) auf.
+		/// @remark	pRecord zeigt auf einen vollständigen Datensatz im Format von SerializedRecord.
+		template <typename Func>
+		void ForEachRecord(Func&& func) const
+		{
+			for(const Segment& segment : mSegments)
+			{
+				size_t offset = segment.readOffset;
+				while(offset < segment.writeOffset)
+				{
+					const std::byte*	pRecord		= segment.file.Data() + offset;
+					const size_t		recordSize	= SerializedRecord::TotalSize(SerializedRecord::PayloadSize(pRecord));
+					func(pRecord, recordSize);
+					offset += recordSize;
+				}
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entfernt alle Elemente und löscht alle Segmentdateien.
+		void Clear()
+		{
+			while(!mSegments.empty())
+			{
+				RemoveFrontSegment();
+			}
+			mSize = 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl ausgelagerter Elemente zurück.
+		[[nodiscard]] size_t Size() const
+		{
+			return mSize;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob keine Elemente ausgelagert sind.
+		[[nodiscard]] bool IsEmpty() const
+		{
+			return mSize == 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Konfiguration zurück.
+		[[nodiscard]] const SpillOptions& Options() const
+		{
+			return mOptions;
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Verschiebt bzw. kopiert (bei nicht verschiebbarem T) das Element in ein std::optional<T>
+		static std::optional<T> ToOptional(T& value)
+		{
+			if constexpr(std::is_move_constructible_v<T>)
+			{
+				return std::optional<T>(std::move(value));
+			}
+			else
+			{
+				return std::optional<T>(value);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Legt ein neues Segment an, das mindestens "minSize" Bytes aufnehmen kann
+		bool AddSegment(size_t minSize)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(mOptions.directory, error);
+
+			Segment segment;
+			segment.path = mOptions.directory / ("spill_" + std::to_string(tiel::io::CurrentProcessId())
+								+ "_" + std::to_string(mStoreId) + "_" + std::to_string(mNextSegmentId++) + ".seg");
+			if(!segment.file.Create(segment.path, (std::max)(mOptions.segmentSize, minSize)))
+			{
+				return false;
+			}
+			segment.file.AdviseSequential();
+			mSegments.push_back(std::move(segment));
+			return true;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Blendet das älteste Segment aus und löscht dessen Datei
+		void RemoveFrontSegment()
+		{
+			std::error_code error;
+			mSegments.front().file.Close();
+			std::filesystem::remove(mSegments.front().path, error);
+			mSegments.pop_front();
+		}
+
+		inline static std::atomic_uint64_t	sNextStoreId	= 0;
+
+		SpillOptions			mOptions;
+		const uint64_t			mStoreId;
+		uint64_t				mNextSegmentId	= 0;
+		size_t					mSize			= 0;
+		std::deque<Segment>		mSegments;
+	}; // class SpillStore
+
+} // namespace tiel::concurrent::container
@@ -0,0 +1,172 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <exception>
+#include "InplaceFunction.h"
+
+namespace tiel::concurrent
+{
+	//________________________________________________________________________________________________
+	/// @brief	Callback-Handler mit fester, beim Übersetzen bekannter Anzahl Slots für Subscriber, die
+	///			sich beim Start anmelden.
+	/// @remark	Die Slots liegen in einem std::array, Funktionszeiger werden direkt, Funktionsobjekte als
+	///			InplaceFunction abgelegt. Es wird weder Heap-Speicher angefordert noch eine Sperre
+	///			verwendet: AddCallback() beschreibt zuerst den Slot und veröffentlicht ihn dann über den
+	///			atomaren Zähler, CallAll() liest nur die bereits veröffentlichten Slots.
+	///			Nach Freeze() sind keine weiteren Anmeldungen möglich, die Slots sind dann unveränderlich.
+	///			Ein nur mit Funktionszeigern konstruierter Handler ist bereits eingefroren. Sein Konstruktor
+	///			ist constexpr, er kann daher constinit ohne dynamische Initialisierung angelegt werden.
+	///			AddCallback() darf nicht gleichzeitig aus mehreren Threads aufgerufen werden.
+	//	@param	Capacity	max. Anzahl Callbacks
+	//	@param	Args		Callback-Parameter
+	template <size_t Capacity, class ... Args>
+	class StaticCallbackHandler final
+	{
+	public:
+		using FunctionPointer	= void(*)(Args ...);
+		using CallbackType		= InplaceFunction<void(Args ...)>;
+
+	private:
+		///_________________________________________________________________________________________________
+		/// Slot für einen Callback: entweder Funktionszeiger oder Funktionsobjekt
+		struct CallbackSlot
+		{
+			FunctionPointer	pFunction = nullptr;
+			CallbackType	object;					// leer, wenn pFunction gesetzt ist
+
+			void operator()(const Args& ... args) const
+			{
+				if(pFunction != nullptr)
+				{
+					pFunction(args...);
+				}
+				else
+				{
+					object(args...);
+				}
+			}
+		};
+
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Standard-Konstruktor, erzeugt einen leeren, nicht eingefrorenen Handler
+		constexpr StaticCallbackHandler() noexcept = default;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Konstruktor, meldet die übergebenen Funktionszeiger an und friert den Handler ein.
+		/// @param pFunctions		Funktionszeiger, max. Capacity
+		template <class ... Functions>
+			requires (sizeof...(Functions) <= Capacity) && (std::is_convertible_v<Functions, FunctionPointer> && ...)
+		constexpr explicit StaticCallbackHandler(Functions ... pFunctions) noexcept
+			: mSlots{ CallbackSlot{ static_cast<FunctionPointer>(pFunctions), {} }... }
+			, mNumCallbacks(sizeof...(Functions))
+			, mIsFrozen(true)
+		{}
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist weder kopier- noch verschiebbar
+		StaticCallbackHandler(const StaticCallbackHandler&) = delete;
+		StaticCallbackHandler& operator=(const StaticCallbackHandler&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Meldet einen Funktionszeiger an.
+		/// @param pFunction	aufzurufende Funktion
+		/// @return				false, wenn der Handler eingefroren, voll oder pFunction == nullptr ist.
+		[[nodiscard]] bool AddCallback(FunctionPointer pFunction)
+		{
+			if(pFunction == nullptr)
+			{
+				return false;
+			}
+			return Publish(CallbackSlot{ pFunction, {} });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Meldet ein Funktionsobjekt (Lambda, Klasse mit operator()) an. Das Objekt wird ohne
+		///			Heap-Allokation im Slot abgelegt, zu große Objekte werden beim Übersetzen abgewiesen.
+		/// @param callback		aufzurufendes Funktionsobjekt
+		/// @return				false, wenn der Handler eingefroren oder voll ist.
+		template <class Callback>
+			requires (!std::is_convertible_v<Callback, FunctionPointer>) && std::is_invocable_v<Callback&, Args ...>
+		[[nodiscard]] bool AddCallback(Callback&& callback)
+		{
+			return Publish(CallbackSlot{ nullptr, CallbackType(std::forward<Callback>(callback)) });
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Beendet die Anmeldephase. Danach sind die Slots unveränderlich.
+		void Freeze() noexcept
+		{
+			mIsFrozen.store(true, std::memory_order_release);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob der Handler eingefroren ist.
+		[[nodiscard]] bool IsFrozen() const noexcept
+		{
+			return mIsFrozen.load(std::memory_order_acquire);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft alle angemeldeten Callbacks in der Reihenfolge ihrer Anmeldung auf.
+		/// @remark	Exception innerhalb der Callbacks werden nicht behandelt. Es wird keine Sperre
+		///			gehalten, beliebig viele Threads können gleichzeitig CallAll() aufrufen.
+		/// @param ...args		Callback-Argumente
+		void CallAll(Args... args) const
+		{
+			const size_t numCallbacks = mNumCallbacks.load(std::memory_order_acquire);
+			for(size_t i = 0; i < numCallbacks; i++)
+			{
+				mSlots[i](args...);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft alle angemeldeten Callbacks in der Reihenfolge ihrer Anmeldung auf.
+		/// @remark	Exception innerhalb der Callbacks werden gefangen.
+		/// @param ...args		Callback-Argumente
+		/// @return				true, wenn alle Callbacks erfolgreich aufgerufen wurden.
+		///						false, wenn in mindestens einem Callback eine Ausnahme ausgelöst wurde
+		bool CallAllNoExcept(Args... args) const
+		{
+			const size_t	numCallbacks	= mNumCallbacks.load(std::memory_order_acquire);
+			bool			success			= true;
+			for(size_t i = 0; i < numCallbacks; i++)
+			{
+				try
+				{
+					mSlots[i](args...);
+				}
+				catch(const std::exception&)
+				{
+					success = false;
+				}
+			}
+			return success;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der angemeldeten Callbacks zurück.
+		[[nodiscard]] size_t Size() const noexcept
+		{
+			return mNumCallbacks.load(std::memory_order_acquire);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die max. Anzahl der Callbacks zurück.
+		[[nodiscard]] static constexpr size_t MaxSize() noexcept
+		{
+			return Capacity;
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Beschreibt den nächsten freien Slot und veröffentlicht ihn
+		bool Publish(CallbackSlot&& mv_slot)
+		{
+			const size_t numCallbacks = mNumCallbacks.load(std::memory_order_relaxed);
+			if(IsFrozen() || (numCallbacks >= Capacity))
+			{
+				return false;
+			}
+			mSlots[numCallbacks] = std::move(mv_slot);
+			mNumCallbacks.store(numCallbacks + 1, std::memory_order_release);
+			return true;
+		}
+
+		std::array<CallbackSlot, Capacity>	mSlots;
+		std::atomic_size_t					mNumCallbacks	= 0;
+		std::atomic_bool					mIsFrozen		= false;
+	}; // class StaticCallbackHandler
+
+} // namespace tiel::concurrent
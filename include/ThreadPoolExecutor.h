@@ -0,0 +1,481 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ConcurrentQueue.h"
+#include "WorkStealingDeque.h"
+
+namespace tiel::concurrent
+{
+	class ThreadPoolExecutor;
+
+	//_________________________________________________________________________________________________
+	/// @brief	Typgelöschte Aufgabe des ThreadPoolExecutor (siehe ThreadPoolExecutor::Post()).
+	/// @remark	Run() führt die Aufgabe aus und gibt sie anschließend selbst frei bzw. an ihren Besitzer
+	///			zurück. Nach Run() greift der Executor nicht mehr auf die Aufgabe zu, wiederverwendbare
+	///			Aufgaben können daher ohne Allokation erneut eingestellt werden.
+	class ExecutorTask
+	{
+	public:
+		virtual ~ExecutorTask() = default;
+		virtual void Run() = 0;
+	};
+
+	namespace detail
+	{
+		//_________________________________________________________________________________________________
+		/// Gemeinsamer Zustand von Aufgabe und TaskFuture<R>
+		template <typename R>
+		class TaskState final
+		{
+			using ValueType = std::conditional_t<std::is_void_v<R>, bool, R>;
+		public:
+			template <typename Func>
+			void Run(Func& func) noexcept
+			{
+				try
+				{
+					if constexpr(std::is_void_v<R>)
+					{
+						func();
+						mValue.emplace(true);
+					}
+					else
+					{
+						mValue.emplace(func());
+					}
+				}
+				catch(...)
+				{
+					mException = std::current_exception();
+				}
+				mIsReady.store(true, std::memory_order_release);
+				mIsReady.notify_all();
+			}
+			bool IsReady() const
+			{
+				return mIsReady.load(std::memory_order_acquire);
+			}
+			void Wait() const
+			{
+				mIsReady.wait(false, std::memory_order_acquire);
+			}
+			R Get()
+			{
+				if(mException)
+				{
+					std::rethrow_exception(mException);
+				}
+				if constexpr(!std::is_void_v<R>)
+				{
+					return std::move(mValue.value());
+				}
+			}
+		private:
+			std::atomic_bool			mIsReady = false;
+			std::optional<ValueType>	mValue;
+			std::exception_ptr			mException;
+		};
+
+		//_________________________________________________________________________________________________
+		/// Aufgabe, die "func" ausführt und das Ergebnis im TaskState<R> ablegt
+		template <typename R, typename Func>
+		class FutureTask final : public ExecutorTask
+		{
+		public:
+			FutureTask(Func&& mv_func, std::shared_ptr<TaskState<R>> pState)
+				: mFunc(std::move(mv_func)), mState(std::move(pState))
+			{}
+			void Run() override
+			{
+				mState->Run(mFunc);
+				delete this;
+			}
+		private:
+			Func							mFunc;
+			std::shared_ptr<TaskState<R>>	mState;
+		};
+	} // namespace detail
+
+	//_________________________________________________________________________________________________
+	/// @brief	Ergebnis einer mit ThreadPoolExecutor::Submit() übergebenen Aufgabe.
+	/// @remark	Im Gegensatz zu std::future werden beim Warten aus einem Worker-Thread heraus
+	///			währenddessen andere Aufgaben des Executors abgearbeitet. Verschachtelte
+	///			Submit()/Wait()-Aufrufe (z.B. in ParallelFor()) können den Pool daher nicht verklemmen.
+	///			Erst wenn keine Aufgabe mehr zu finden ist (die erwartete Aufgabe läuft dann bereits in
+	///			einem anderen Worker), blockiert der Worker bis zu deren Abschluss.
+	/// @tparam R	Rückgabetyp der Aufgabe
+	template <typename R>
+	class TaskFuture final
+	{
+		friend class ThreadPoolExecutor;
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// Standard-Konstruktor, erzeugt ein ungültiges TaskFuture
+		TaskFuture() = default;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob das TaskFuture zu einer Aufgabe gehört.
+		[[nodiscard]] bool IsValid() const
+		{
+			return mState != nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob die Aufgabe abgeschlossen ist.
+		[[nodiscard]] bool IsReady() const
+		{
+			return (mState != nullptr) && mState->IsReady();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet, bis die Aufgabe abgeschlossen ist.
+		void Wait() const;
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Wartet, bis die Aufgabe abgeschlossen ist, und gibt deren Ergebnis zurück.
+		/// @remark	Eine in der Aufgabe geworfene Exception wird erneut geworfen. Get() darf nur einmal
+		///			aufgerufen werden.
+		R Get()
+		{
+			_ASSERT(IsValid());
+			Wait();
+			return mState->Get();
+		}
+
+	private:
+		TaskFuture(std::shared_ptr<detail::TaskState<R>> pState, ThreadPoolExecutor* pExecutor)
+			: mState(std::move(pState)), mExecutor(pExecutor)
+		{}
+
+		std::shared_ptr<detail::TaskState<R>>	mState;
+		ThreadPoolExecutor*						mExecutor	= nullptr;
+	};
+
+	//_________________________________________________________________________________________________
+	/// @brief	Thread-Pool für rechenintensive Aufgaben mit Work-Stealing.
+	/// @remark	Jeder Worker besitzt eine WorkStealingDeque, in die Aufgaben aus Worker-Threads heraus
+	///			gelegt werden (LIFO, cache-freundlich). Aufgaben anderer Threads landen in einer globalen
+	///			Injection-Queue. Ein Worker ohne eigene Aufgaben entnimmt zuerst aus der Injection-Queue
+	///			und stiehlt dann bei zufällig gewählten anderen Workern. Worker ohne Arbeit legen sich
+	///			schlafen und werden beim Einstellen neuer Aufgaben geweckt.
+	///			Der Destruktor arbeitet alle ausstehenden Aufgaben ab, bevor die Worker beendet werden.
+	class ThreadPoolExecutor final
+	{
+		//---------------------------------------------------------------------------------------------
+		struct Worker
+		{
+			container::WorkStealingDeque<ExecutorTask*>		deque;
+			std::minstd_rand									random;
+			std::thread											thread;
+		};
+		//---------------------------------------------------------------------------------------------
+		// Worker des aktuellen Threads
+		struct WorkerContext
+		{
+			ThreadPoolExecutor*	pExecutor;
+			Worker*				pWorker;
+		};
+
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor
+		/// @param numWorkers	Anzahl Worker-Threads (0: Anzahl Hardware-Threads)
+		explicit ThreadPoolExecutor(size_t numWorkers = 0)
+		{
+			if(numWorkers == 0)
+			{
+				numWorkers = (std::max)(1u, std::thread::hardware_concurrency());
+			}
+			mWorkers.reserve(numWorkers);
+			for(size_t i = 0; i < numWorkers; i++)
+			{
+				mWorkers.push_back(std::make_unique<Worker>());
+				mWorkers.back()->random.seed(static_cast<unsigned>(i + 1));
+			}
+			for(auto& pWorker : mWorkers)
+			{
+				pWorker->thread = std::thread(&ThreadPoolExecutor::WorkerLoop, this, pWorker.get());
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist weder kopier- noch verschiebbar
+		ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+		ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, arbeitet alle ausstehenden Aufgaben ab und beendet die Worker-Threads
+		~ThreadPoolExecutor()
+		{
+			//_ASSERT(false); // not tested
+			{
+				std::lock_guard lock(mParkMutex);
+				mIsStopping.store(true, std::memory_order_seq_cst);
+			}
+			mParkCondition.notify_all();
+			for(auto& pWorker : mWorkers)
+			{
+				pWorker->thread.join();
+			}
+			mInjectionQueue.Close();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt den prozessweiten Standard-Executor zurück (ein Worker je Hardware-Thread).
+		static ThreadPoolExecutor& Default()
+		{
+			static ThreadPoolExecutor sDefaultExecutor;
+			return sDefaultExecutor;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der Worker-Threads zurück.
+		[[nodiscard]] size_t NumWorkers() const
+		{
+			return mWorkers.size();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob der aufrufende Thread ein Worker dieses Executors ist.
+		[[nodiscard]] bool IsWorkerThread() const
+		{
+			return sCurrentWorker.pExecutor == this;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Stellt eine Aufgabe zur Ausführung ein.
+		/// @param func		Funktion ohne Parameter. Eine geworfene Exception wird im TaskFuture abgelegt.
+		/// @return			TaskFuture mit dem Rückgabewert von func()
+		template <typename Func>
+		[[nodiscard]] auto Submit(Func&& func) -> TaskFuture<std::invoke_result_t<std::decay_t<Func>&>>
+		{
+			using R			= std::invoke_result_t<std::decay_t<Func>&>;
+			using TaskType	= detail::FutureTask<R, std::decay_t<Func>>;
+
+			auto pState = std::make_shared<detail::TaskState<R>>();
+			Enqueue(new TaskType(std::decay_t<Func>(std::forward<Func>(func)), pState));
+			return TaskFuture<R>(std::move(pState), this);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Stellt eine vom Aufrufer verwaltete Aufgabe ohne weitere Allokation zur Ausführung ein.
+		/// @param task		Aufgabe, die bis zum Ende von task.Run() gültig bleiben muss
+		void Post(ExecutorTask& task)
+		{
+			Enqueue(&task);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Ruft func(i) für alle i aus [begin, end) parallel auf und kehrt zurück, wenn alle
+		///			Aufrufe abgeschlossen sind.
+		/// @remark	Die Indizes werden in Blöcken der Größe "grainSize" dynamisch an die Worker und den
+		///			aufrufenden Thread verteilt. Wirft func() eine Exception, werden keine weiteren Blöcke
+		///			begonnen und die erste Exception wird anschließend erneut geworfen.
+		/// @param begin		erster Index
+		/// @param end			Index nach dem letzten Index
+		/// @param func			Funktion mit der Signatur void(size_t index)
+		/// @param grainSize	Anzahl Indizes je Block (0: automatisch)
+		template <typename Func>
+		void ParallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0)
+		{
+			if(begin >= end)
+			{
+				return;
+			}
+			const size_t numIndices = end - begin;
+			if(grainSize == 0)
+			{
+				grainSize = (std::max)(size_t(1), numIndices/(4*(NumWorkers() + 1)));
+			}
+			const size_t numBlocks = (numIndices + grainSize - 1)/grainSize;
+
+			// der Zustand liegt auf dem Stack, da vor dem Rücksprung auf alle Hilfsaufgaben gewartet wird
+			std::atomic_size_t	nextBlock	= 0;
+			std::atomic_bool	isFailed	= false;
+			std::exception_ptr	exception;
+			std::mutex			exceptionMutex;
+
+			auto runBlocks = [&]()
+			{
+				for(size_t block = nextBlock++; (block < numBlocks) && !isFailed.load(std::memory_order_relaxed); block = nextBlock++)
+				{
+					const size_t blockBegin = begin + block*grainSize;
+					const size_t blockEnd	= (std::min)(end, blockBegin + grainSize);
+					try
+					{
+						for(size_t i = blockBegin; i < blockEnd; i++)
+						{
+							func(i);
+						}
+					}
+					catch(...)
+					{
+						std::lock_guard lock(exceptionMutex);
+						if(!isFailed.exchange(true))
+						{
+							exception = std::current_exception();
+						}
+					}
+				}
+			};
+
+			std::vector<TaskFuture<void>> helpers;
+			const size_t numHelpers = (std::min)(NumWorkers(), numBlocks - 1);
+			helpers.reserve(numHelpers);
+			for(size_t i = 0; i < numHelpers; i++)
+			{
+				helpers.push_back(Submit(runBlocks));
+			}
+			runBlocks();
+			for(auto& helper : helpers)
+			{
+				helper.Wait();
+			}
+			if(exception)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Führt eine ausstehende Aufgabe im aufrufenden Thread aus (Hilfe beim Warten).
+		/// @return		true, wenn eine Aufgabe ausgeführt wurde.
+		bool RunPendingTask()
+		{
+			Worker* pWorker = (sCurrentWorker.pExecutor == this) ? sCurrentWorker.pWorker : nullptr;
+			if(ExecutorTask* pTask = FindTask(pWorker))
+			{
+				RunTask(pTask);
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		///----------------------------------------------------------------------------------------------
+		/// Legt die Aufgabe in die Deque des aktuellen Workers bzw. in die Injection-Queue und weckt
+		/// bei Bedarf einen schlafenden Worker
+		void Enqueue(ExecutorTask* pTask)
+		{
+			mNumPendingTasks.fetch_add(1, std::memory_order_seq_cst);
+			if(sCurrentWorker.pExecutor == this)
+			{
+				sCurrentWorker.pWorker->deque.Push(pTask);
+			}
+			else
+			{
+				(void)mInjectionQueue.TryPush(pTask);
+			}
+			if(mNumParkedWorkers.load(std::memory_order_seq_cst) != 0)
+			{
+				std::lock_guard lock(mParkMutex);
+				mParkCondition.notify_one();
+			}
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Sucht eine Aufgabe: eigene Deque, Injection-Queue, danach Stehlen bei zufälligen Workern
+		ExecutorTask* FindTask(Worker* pWorker)
+		{
+			if(pWorker != nullptr)
+			{
+				if(std::optional<ExecutorTask*> pTask = pWorker->deque.Pop())
+				{
+					return pTask.value();
+				}
+			}
+			if(std::optional<ExecutorTask*> pTask = mInjectionQueue.TryPop())
+			{
+				return pTask.value();
+			}
+			const size_t numWorkers = mWorkers.size();
+			const size_t firstVictim = (pWorker != nullptr) ? pWorker->random() % numWorkers : 0;
+			for(size_t i = 0; i < numWorkers; i++)
+			{
+				Worker* pVictim = mWorkers[(firstVictim + i) % numWorkers].get();
+				if(pVictim != pWorker)
+				{
+					if(std::optional<ExecutorTask*> pTask = pVictim->deque.Steal())
+					{
+						return pTask.value();
+					}
+				}
+			}
+			return nullptr;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Führt die entnommene Aufgabe aus (die sich anschließend selbst freigibt)
+		void RunTask(ExecutorTask* pTask)
+		{
+			mNumPendingTasks.fetch_sub(1, std::memory_order_relaxed);
+			pTask->Run();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Hauptschleife eines Worker-Threads
+		void WorkerLoop(Worker* pWorker)
+		{
+			sCurrentWorker = { this, pWorker };
+			while(true)
+			{
+				if(ExecutorTask* pTask = FindTask(pWorker))
+				{
+					RunTask(pTask);
+					continue;
+				}
+				std::unique_lock lock(mParkMutex);
+				if(mIsStopping.load(std::memory_order_seq_cst) && (mNumPendingTasks.load(std::memory_order_seq_cst) == 0))
+				{
+					break;
+				}
+				mNumParkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+				mParkCondition.wait(lock, [this]()
+					{
+						return (mNumPendingTasks.load(std::memory_order_seq_cst) != 0) || mIsStopping.load(std::memory_order_seq_cst);
+					});
+				mNumParkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+			}
+			sCurrentWorker = { nullptr, nullptr };
+		}
+
+		inline static thread_local WorkerContext	sCurrentWorker = { nullptr, nullptr };
+
+		std::vector<std::unique_ptr<Worker>>					mWorkers;
+		container::LockFreeQueue<ExecutorTask*>					mInjectionQueue;
+		std::mutex												mParkMutex;
+		std::condition_variable									mParkCondition;
+		std::atomic_size_t										mNumPendingTasks	= 0;
+		std::atomic_size_t										mNumParkedWorkers	= 0;
+		std::atomic_bool										mIsStopping			= false;
+	}; // class ThreadPoolExecutor
+
+	///----------------------------------------------------------------------------------------------
+	template <typename R>
+	void TaskFuture<R>::Wait() const
+	{
+		_ASSERT(IsValid());
+		if(mExecutor->IsWorkerThread())
+		{
+			// im Worker zunächst andere Aufgaben abarbeiten. Findet sich wiederholt keine, läuft die
+			// erwartete Aufgabe bereits in einem anderen Worker und es wird bis zu deren Abschluss
+			// blockiert (TaskState::Run() weckt), statt den Kern mit yield() auszulasten.
+			constexpr int MaxFailedAttempts = 16;
+			for(int numFailed = 0; !mState->IsReady(); )
+			{
+				if(mExecutor->RunPendingTask())
+				{
+					numFailed = 0;
+				}
+				else if(++numFailed < MaxFailedAttempts)
+				{
+					std::this_thread::yield();
+				}
+				else
+				{
+					mState->Wait();
+				}
+			}
+		}
+		else
+		{
+			mState->Wait();
+		}
+	}
+
+} // namespace tiel::concurrent
@@ -0,0 +1,201 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "HazardPointer.h"
+
+namespace tiel::concurrent::container
+{
+	//_________________________________________________________________________________________________
+	/// @brief	Lock-freie Work-Stealing-Deque nach Chase und Lev ("Dynamic Circular Work-Stealing Deque",
+	///			Speichermodell nach Lê, Pop, Cohen und Zappa Nardelli).
+	/// @remark	Genau ein Thread (der Besitzer) ruft Push() und Pop() auf und arbeitet LIFO am unteren Ende,
+	///			beliebige andere Threads entnehmen mit Steal() FIFO am oberen Ende. Nur bei Konkurrenz um das
+	///			letzte Element bzw. zwischen Dieben wird ein CAS benötigt.
+	///			Der Ringpuffer wächst bei Bedarf auf die doppelte Größe. Diebe schützen den gelesenen
+	///			Puffer mit einem HazardPointer (nur ein Slot des eigenen Threads, kein gemeinsamer Zähler),
+	///			der Besitzer gibt abgelöste Puffer frei, sobald kein Dieb mehr auf sie verweist. Das gelingt
+	///			auch bei ununterbrochenem Stehlen, da jeder Dieb nur den jeweils gelesenen Puffer schützt.
+	/// @tparam T	Elementtyp, muss trivial kopierbar sein (Elemente werden von Dieben ungeschützt gelesen,
+	///				typischerweise Zeiger oder Indizes auf Tasks).
+	template <typename T>
+	class WorkStealingDeque final
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque<T>: T muss trivial kopierbar sein");
+
+		static constexpr size_t CacheLineSize = 64;
+
+		//---------------------------------------------------------------------------------------------
+		// Ringpuffer mit Zweierpotenz-Kapazität, Indizes laufen monoton und werden maskiert
+		class RingArray final
+		{
+		public:
+			explicit RingArray(size_t capacity) : mMask(capacity - 1), mSlots(new std::atomic<T>[capacity])
+			{
+			}
+			size_t Capacity() const
+			{
+				return mMask + 1;
+			}
+			void Put(int64_t index, const T& value)
+			{
+				mSlots[static_cast<size_t>(index) & mMask].store(value, std::memory_order_relaxed);
+			}
+			T Get(int64_t index) const
+			{
+				return mSlots[static_cast<size_t>(index) & mMask].load(std::memory_order_relaxed);
+			}
+			// Erzeugt einen Puffer doppelter Größe mit den Elementen [top, bottom)
+			RingArray* Grow(int64_t bottom, int64_t top) const
+			{
+				RingArray* pArray = new RingArray(2*Capacity());
+				for(int64_t i = top; i < bottom; i++)
+				{
+					pArray->Put(i, Get(i));
+				}
+				return pArray;
+			}
+		private:
+			const size_t					mMask;
+			std::unique_ptr<std::atomic<T>[]>	mSlots;
+		};
+
+	public:
+		///----------------------------------------------------------------------------------------------
+		/// @brief Konstruktor
+		/// @param initialCapacity		Anfangskapazität, wird auf die nächste Zweierpotenz aufgerundet
+		explicit WorkStealingDeque(size_t initialCapacity = 1024)
+		{
+			size_t capacity = 2;
+			while(capacity < initialCapacity)
+			{
+				capacity <<= 1;
+			}
+			mArray.store(new RingArray(capacity), std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// Typ ist weder kopier- noch verschiebbar
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+		///----------------------------------------------------------------------------------------------
+		/// Destruktor, es darf kein Thread mehr auf die Deque zugreifen
+		~WorkStealingDeque()
+		{
+			delete mArray.load(std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Fügt ein Element am unteren Ende hinzu (nur Besitzer-Thread). Ist der Puffer voll,
+		///			wird er vergrößert.
+		/// @param value	hinzuzufügendes Element
+		void Push(const T& value)
+		{
+			const int64_t	bottom	= mBottom.load(std::memory_order_relaxed);
+			const int64_t	top		= mTop.load(std::memory_order_acquire);
+			RingArray*		pArray	= mArray.load(std::memory_order_relaxed);
+
+			if(bottom - top > static_cast<int64_t>(pArray->Capacity()) - 1)
+			{
+				RingArray* pNewArray = pArray->Grow(bottom, top);
+				mArray.store(pNewArray, std::memory_order_seq_cst);
+				mRetiredArrays.Retire(std::unique_ptr<RingArray>(pArray));
+				pArray = pNewArray;
+			}
+			else
+			{
+				mRetiredArrays.Reclaim();
+			}
+			pArray->Put(bottom, value);
+			std::atomic_thread_fence(std::memory_order_release);
+			mBottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entnimmt das zuletzt hinzugefügte Element am unteren Ende (nur Besitzer-Thread).
+		/// @return		wenn die Deque leer ist, hält das zurückgegebene std::optional<T> keinen Wert.
+		std::optional<T> Pop()
+		{
+			const int64_t	bottom	= mBottom.load(std::memory_order_relaxed) - 1;
+			RingArray*		pArray	= mArray.load(std::memory_order_relaxed);
+
+			mBottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = mTop.load(std::memory_order_relaxed);
+
+			if(top > bottom)
+			{
+				// leer
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return {};
+			}
+			std::optional<T> optValue = pArray->Get(bottom);
+			if(top == bottom)
+			{
+				// letztes Element: Wettlauf mit Dieben über top entscheiden
+				if(!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					optValue.reset();
+				}
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return optValue;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Entnimmt das älteste Element am oberen Ende (beliebiger Thread).
+		/// @return		wenn die Deque leer ist oder ein anderer Thread das Element gleichzeitig entnommen
+		///				hat, hält das zurückgegebene std::optional<T> keinen Wert.
+		std::optional<T> Steal()
+		{
+			int64_t top = mTop.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64_t bottom = mBottom.load(std::memory_order_acquire);
+
+			std::optional<T> optValue;
+			if(top < bottom)
+			{
+				const HazardPointer<RingArray> pArray(mArray);
+				optValue = pArray->Get(top);
+				if(!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					optValue.reset();
+				}
+			}
+			return optValue;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die (bei gleichzeitigem Zugriff nur ungefähre) Anzahl der Elemente zurück.
+		[[nodiscard]] size_t Size() const
+		{
+			const int64_t bottom	= mBottom.load(std::memory_order_relaxed);
+			const int64_t top		= mTop.load(std::memory_order_relaxed);
+			return (bottom > top) ? static_cast<size_t>(bottom - top) : 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Prüft, ob die Deque (zum Zeitpunkt des Aufrufs) leer ist.
+		[[nodiscard]] bool IsEmpty() const
+		{
+			return Size() == 0;
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die aktuelle Kapazität des Ringpuffers zurück.
+		[[nodiscard]] size_t Capacity() const
+		{
+			return mArray.load(std::memory_order_relaxed)->Capacity();
+		}
+		///----------------------------------------------------------------------------------------------
+		/// @brief	Gibt die Anzahl der abgelösten, noch nicht freigegebenen Puffer zurück (nur
+		///			Besitzer-Thread).
+		[[nodiscard]] size_t NumRetiredArrays() const
+		{
+			return mRetiredArrays.Size();
+		}
+
+	private:
+		alignas(CacheLineSize) std::atomic_int64_t				mTop			= 0;
+		alignas(CacheLineSize) std::atomic_int64_t				mBottom			= 0;
+		alignas(CacheLineSize) std::atomic<RingArray*>			mArray			= nullptr;
+		HazardRetireList<std::unique_ptr<RingArray>>			mRetiredArrays;	// nur Besitzer-Thread
+	}; // class WorkStealingDeque
+
+} // namespace tiel::concurrent::container
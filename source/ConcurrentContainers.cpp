@@ -32,24 +32,24 @@ CallbackHandler<int, std::string> TestCallbackHandler(CallbackHandler<int, std::
 		cout << std::format("V3: {} = {})\n", s, i);
 	};
 	auto first = ch.AddCallback(callback1);
-	ch.CallAll(first, "CallbackHandler");
+	ch.CallAll(1, "CallbackHandler");
 	cout << "---------------------------\n";
 	auto second = ch.AddCallback(callback2);
-	ch.CallAll(second, "CallbackHandler");
+	ch.CallAll(2, "CallbackHandler");
 	cout << "---------------------------\n";
 	ch.RemoveCallback(first);
-	ch.CallAll(second, "CallbackHandler");
+	ch.CallAll(2, "CallbackHandler");
 	cout << "---------------------------\n";
 	first = ch.AddCallback(callback1);
 	auto third = ch.AddCallback(callback3);
-	ch.CallAll(third, "CallbackHandler");
+	ch.CallAll(3, "CallbackHandler");
 	cout << "---------------------------\n";
 	ch.RemoveCallback(second);
-	ch.CallAll(third, "CallbackHandler");
+	ch.CallAll(3, "CallbackHandler");
 	cout << "---------------------------\n";
 	cout << "alle Callbacks entfernt\n";
 	ch.RemoveAllCallbacks();
-	ch.CallAll(third, "CallbackHandler");
+	ch.CallAll(3, "CallbackHandler");
 	cout << "---------------------------\n";
 
 	// Vorbereitung für Move-Operationen